@@ -0,0 +1,185 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  BenchmarkApp.cpp
+//  Benchmarks
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "BenchmarkApp.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <core/Console.h>
+#include <utils/SystemUtil.hpp>
+#include "version.h"
+
+//BenchmarkReport
+BenchmarkReport::BenchmarkReport(const std::string& benchmarkName, int argc, const char* argv[], unsigned int defaultSteps)
+    : name(benchmarkName), outputPath(benchmarkName + ".json"), steps(defaultSteps)
+{
+    if(argc > 1)
+        outputPath = std::string(argv[1]);
+    if(argc > 2)
+        steps = (unsigned int)std::max(atoi(argv[2]), 1);
+}
+
+void BenchmarkReport::AddResult(const BenchmarkResult& result)
+{
+    results.push_back(result);
+}
+
+unsigned int BenchmarkReport::getSteps() const
+{
+    return steps;
+}
+
+std::string BenchmarkReport::getName() const
+{
+    return name;
+}
+
+bool BenchmarkReport::Save() const
+{
+    FILE* file = fopen(outputPath.c_str(), "w");
+    if(file == nullptr)
+    {
+        fprintf(stderr, "Failed to open output file '%s'!\n", outputPath.c_str());
+        return false;
+    }
+    
+    fprintf(file, "{\n  \"benchmark\": \"%s\",\n  \"version\": \"%s\",\n  \"steps\": %u,\n  \"results\": [", name.c_str(), STONEFISH_VER, steps);
+    for(size_t i=0; i<results.size(); ++i)
+    {
+        const BenchmarkResult& r = results[i];
+        fprintf(file, "%s\n    {\n      \"case\": \"%s\",\n      \"params\": {", i > 0 ? "," : "", r.name.c_str());
+        size_t k = 0;
+        for(auto it = r.params.begin(); it != r.params.end(); ++it, ++k)
+            fprintf(file, "%s\"%s\": %.9g", k > 0 ? ", " : "", it->first.c_str(), it->second);
+        fprintf(file, "},\n      \"metrics\": {");
+        k = 0;
+        for(auto it = r.metrics.begin(); it != r.metrics.end(); ++it, ++k)
+            fprintf(file, "%s\"%s\": %.9g", k > 0 ? ", " : "", it->first.c_str(), it->second);
+        fprintf(file, "},\n      \"phases_us\": {");
+        k = 0;
+        for(auto it = r.phases.begin(); it != r.phases.end(); ++it, ++k)
+        {
+            const sf::PerformanceStats& s = it->second;
+            fprintf(file, "%s\n        \"%s\": {\"min\": %.3f, \"mean\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"samples\": %lu}", 
+                    k > 0 ? "," : "", it->first.c_str(), s.min, s.mean, s.p95, s.p99, (unsigned long)s.samples);
+        }
+        fprintf(file, "%s}\n    }", k > 0 ? "\n      " : "");
+    }
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+    
+    printf("Benchmark results saved to '%s'.\n", outputPath.c_str());
+    return true;
+}
+
+//BenchmarkManager
+BenchmarkManager::BenchmarkManager(sf::Scalar stepsPerSecond, std::function<void(BenchmarkManager*)> builder, sf::SolverType st)
+    : SimulationManager(stepsPerSecond, st, sf::CollisionFilteringType::COLLISION_EXCLUSIVE), builder(builder), clock(1), buildTime(0)
+{
+}
+
+void BenchmarkManager::BuildScenario()
+{
+    uint64_t start = sf::GetTimeInMicroseconds();
+    if(builder)
+        builder(this);
+    buildTime = sf::GetTimeInMicroseconds() - start;
+}
+
+uint64_t BenchmarkManager::getSimulationClock() const
+{
+    return clock;
+}
+
+void BenchmarkManager::SimulationClockSleep(uint64_t us)
+{
+    clock += us; //Virtual time passes immediately, so that each call to AdvanceSimulation() computes one step
+}
+
+uint64_t BenchmarkManager::getBuildTime() const
+{
+    return buildTime;
+}
+
+//BenchmarkApp
+BenchmarkApp::BenchmarkApp(const std::string& name, BenchmarkManager* sim) 
+    : ConsoleSimulationApp(name, std::string(DATA_DIR_PATH), sim)
+{
+}
+
+BenchmarkApp::~BenchmarkApp()
+{
+    delete getSimulationManager();
+}
+
+void BenchmarkApp::Initialize()
+{
+    Init();
+}
+
+BenchmarkResult BenchmarkApp::Simulate(const std::string& caseName, unsigned int warmupSteps, unsigned int steps)
+{
+    BenchmarkResult result;
+    result.name = caseName;
+    result.params["steps"] = steps;
+    
+    BenchmarkManager* sim = (BenchmarkManager*)getSimulationManager();
+    result.params["steps_per_simulated_second"] = sim->getStepsPerSecond();
+    result.metrics["build_time_ms"] = sim->getBuildTime()/1000.0;
+    
+    if(!sim->StartSimulation())
+    {
+        cError("Benchmark case '%s' failed to start!", caseName.c_str());
+        return result;
+    }
+    
+    sim->AdvanceSimulation(); //Synchronizes the clock
+    for(unsigned int i=0; i<warmupSteps; ++i)
+        sim->AdvanceSimulation();
+    
+    uint64_t start = sf::GetTimeInMicroseconds();
+    for(unsigned int i=0; i<steps; ++i)
+        sim->AdvanceSimulation();
+    double elapsed = (sf::GetTimeInMicroseconds() - start)/1000000.0;
+    sim->StopSimulation();
+    
+    double stepsPerSecond = steps/std::max(elapsed, 1e-9);
+    result.metrics["wall_time_s"] = elapsed;
+    result.metrics["steps_per_second"] = stepsPerSecond;
+    result.metrics["realtime_factor"] = stepsPerSecond/sim->getStepsPerSecond();
+    
+    sf::PerformanceMonitor& perf = sim->getPerformanceMonitor();
+    for(size_t i=0; i<(size_t)sf::PerformancePhase::COUNT; ++i)
+    {
+        sf::PerformanceStats stats = perf.getPhaseStats((sf::PerformancePhase)i);
+        if(stats.samples > 0)
+            result.phases[sf::PerformanceMonitor::getPhaseName((sf::PerformancePhase)i)] = stats;
+    }
+    
+    cInfo("Benchmark case '%s': %.1lf steps/s (%.2lfx realtime).", caseName.c_str(), stepsPerSecond, result.metrics["realtime_factor"]);
+    return result;
+}
@@ -0,0 +1,135 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  BenchmarkApp.h
+//  Benchmarks
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish__BenchmarkApp__
+#define __Stonefish__BenchmarkApp__
+
+#include <core/ConsoleSimulationApp.h>
+#include <core/SimulationManager.h>
+#include <utils/PerformanceMonitor.h>
+#include <functional>
+#include <vector>
+#include <map>
+#include <string>
+
+class BenchmarkManager;
+
+//! A structure holding the result of a single benchmark case.
+struct BenchmarkResult
+{
+    std::string name;
+    std::map<std::string, double> params;
+    std::map<std::string, double> metrics;
+    std::map<std::string, sf::PerformanceStats> phases; //In microseconds
+};
+
+//! A class collecting the results of a benchmark and saving them in JSON format.
+/*!
+ Usage of all benchmark executables: <benchmark> [output_file] [steps]
+ */
+class BenchmarkReport
+{
+public:
+    //! A constructor.
+    /*!
+     \param benchmarkName the name of the benchmark
+     \param argc the number of command line arguments
+     \param argv the command line arguments
+     \param defaultSteps the default number of measured simulation steps per case
+     */
+    BenchmarkReport(const std::string& benchmarkName, int argc, const char* argv[], unsigned int defaultSteps = 1000);
+    
+    //! A method adding a result to the report.
+    void AddResult(const BenchmarkResult& result);
+    
+    //! A method saving the report to the output file.
+    bool Save() const;
+    
+    //! A method returning the number of measured simulation steps per case.
+    unsigned int getSteps() const;
+    
+    //! A method returning the name of the benchmark.
+    std::string getName() const;
+    
+private:
+    std::string name;
+    std::string outputPath;
+    unsigned int steps;
+    std::vector<BenchmarkResult> results;
+};
+
+//! A simulation manager stepping the simulation in lockstep with a virtual clock.
+/*!
+ Every call to AdvanceSimulation() computes exactly one simulation step, as fast as possible.
+ */
+class BenchmarkManager : public sf::SimulationManager
+{
+public:
+    BenchmarkManager(sf::Scalar stepsPerSecond, std::function<void(BenchmarkManager*)> builder, 
+                     sf::SolverType st = sf::SolverType::SOLVER_SI);
+    
+    void BuildScenario();
+    uint64_t getSimulationClock() const;
+    void SimulationClockSleep(uint64_t us);
+    
+    //! A method returning the time spent building the scenario [us].
+    uint64_t getBuildTime() const;
+    
+private:
+    std::function<void(BenchmarkManager*)> builder;
+    uint64_t clock;
+    uint64_t buildTime;
+};
+
+//! A console application running a benchmark scenario in the calling thread.
+class BenchmarkApp : public sf::ConsoleSimulationApp
+{
+public:
+    //! A constructor.
+    /*!
+     \param name the name of the benchmark
+     \param sim a pointer to the simulation manager (owned by the application)
+     */
+    BenchmarkApp(const std::string& name, BenchmarkManager* sim);
+    
+    //! A destructor.
+    ~BenchmarkApp();
+    
+    //! A method building the scenario.
+    void Initialize();
+    
+    //! A method running the simulation and measuring its performance.
+    /*!
+     Phase statistics cover the last measured steps, up to the window of the performance monitor.
+     \param caseName the name of the benchmark case
+     \param warmupSteps the number of steps run before the measurement
+     \param steps the number of measured steps
+     \return the result of the measurement
+     */
+    BenchmarkResult Simulate(const std::string& caseName, unsigned int warmupSteps, unsigned int steps);
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  FleetScenario.cpp
+//  Benchmarks
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "FleetScenario.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <utils/SystemUtil.hpp>
+
+FleetParser::FleetParser(sf::SimulationManager* sm, unsigned int vehicles, sf::Scalar spacing) 
+    : ScenarioParser(sm), assetsTime(0), count(0), spacing(spacing)
+{
+    side = (unsigned int)std::ceil(std::sqrt((double)std::max(vehicles, 1u)));
+}
+
+uint64_t FleetParser::getAssetsTime() const
+{
+    return assetsTime;
+}
+
+void FleetParser::PrepareAssets(XMLNode* root)
+{
+    uint64_t start = sf::GetTimeInMicroseconds();
+    ScenarioParser::PrepareAssets(root);
+    assetsTime = sf::GetTimeInMicroseconds() - start;
+}
+
+bool FleetParser::ParseRobot(XMLElement* element)
+{
+    XMLElement* trans = element->FirstChildElement("world_transform");
+    if(trans != nullptr)
+    {
+        char xyz[64];
+        snprintf(xyz, 64, "%1.3lf %1.3lf 2.0", (double)((count % side) * spacing), (double)((count / side) * spacing));
+        trans->SetAttribute("xyz", xyz);
+    }
+    ++count;
+    return ScenarioParser::ParseRobot(element);
+}
+
+std::string WriteFleetScenario(unsigned int vehicles)
+{
+    std::string path = (std::filesystem::temp_directory_path() / ("stonefish_fleet_" + std::to_string(vehicles) + ".scn")).string();
+    FILE* file = fopen(path.c_str(), "w");
+    if(file == nullptr)
+        return "";
+    
+    fprintf(file, 
+        "<?xml version=\"1.0\"?>\n"
+        "<scenario>\n"
+        "\t<environment>\n"
+        "\t\t<ned latitude=\"40.0\" longitude=\"3.0\"/>\n"
+        "\t\t<ocean>\n"
+        "\t\t\t<water density=\"1025.0\" jerlov=\"0.25\"/>\n"
+        "\t\t\t<waves height=\"0.0\"/>\n"
+        "\t\t\t<current type=\"uniform\">\n"
+        "\t\t\t\t<velocity xyz=\"0.5 0.0 0.0\"/>\n"
+        "\t\t\t</current>\n"
+        "\t\t</ocean>\n"
+        "\t</environment>\n"
+        "\t<materials>\n"
+        "\t\t<material name=\"Neutral\" density=\"1000.0\" restitution=\"0.5\"/>\n"
+        "\t\t<material name=\"Rock\" density=\"3000.0\" restitution=\"0.8\"/>\n"
+        "\t\t<material name=\"Fiberglass\" density=\"1500.0\" restitution=\"0.3\"/>\n"
+        "\t\t<material name=\"Aluminium\" density=\"2710.0\" restitution=\"0.7\"/>\n"
+        "\t</materials>\n"
+        "\t<looks>\n"
+        "\t\t<look name=\"yellow\" rgb=\"1.0 0.9 0.0\" roughness=\"0.3\"/>\n"
+        "\t\t<look name=\"gray\" gray=\"0.3\" roughness=\"0.4\" metalness=\"0.5\"/>\n"
+        "\t\t<look name=\"seabed\" rgb=\"0.7 0.7 0.5\" roughness=\"0.9\"/>\n"
+        "\t\t<look name=\"propeller\" gray=\"1.0\" roughness=\"0.3\"/>\n"
+        "\t\t<look name=\"duct\" gray=\"0.1\" roughness=\"0.4\" metalness=\"0.5\"/>\n"
+        "\t\t<look name=\"manipulator\" rgb=\"0.2 0.15 0.1\" roughness=\"0.6\" metalness=\"0.8\"/>\n"
+        "\t</looks>\n"
+        "\t<static name=\"Bottom\" type=\"plane\">\n"
+        "\t\t<material name=\"Rock\"/>\n"
+        "\t\t<look name=\"seabed\"/>\n"
+        "\t\t<world_transform rpy=\"0.0 0.0 0.0\" xyz=\"0.0 0.0 20.0\"/>\n"
+        "\t</static>\n");
+    for(unsigned int i=0; i<vehicles; ++i)
+        fprintf(file, 
+            "\t<include file=\"%sgirona500auv_console.scn\">\n"
+            "\t\t<arg name=\"robot_name\" value=\"GIRONA500_%u\"/>\n"
+            "\t</include>\n", DATA_DIR_PATH, i);
+    fprintf(file, "</scenario>\n");
+    fclose(file);
+    return path;
+}
@@ -0,0 +1,65 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  FleetScenario.h
+//  Benchmarks
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish__FleetScenario__
+#define __Stonefish__FleetScenario__
+
+#include <core/ScenarioParser.h>
+
+//! A scenario parser placing the consecutive robots on a horizontal grid.
+class FleetParser : public sf::ScenarioParser
+{
+public:
+    //! A constructor.
+    /*!
+     \param sm a pointer to the simulation manager
+     \param vehicles the total number of robots in the scenario
+     \param spacing the distance between the robots [m]
+     */
+    FleetParser(sf::SimulationManager* sm, unsigned int vehicles, sf::Scalar spacing);
+    
+    //! A method returning the time spent on loading and processing the meshes [us].
+    uint64_t getAssetsTime() const;
+    
+protected:
+    void PrepareAssets(XMLNode* root);
+    bool ParseRobot(XMLElement* element);
+    
+private:
+    uint64_t assetsTime;
+    unsigned int side;
+    unsigned int count;
+    sf::Scalar spacing;
+};
+
+//! A function writing a scenario including a number of vehicles (girona500auv_console.scn) to a temporary file.
+/*!
+ \param vehicles the number of vehicles
+ \return a path to the scenario file
+ */
+std::string WriteFleetScenario(unsigned int vehicles);
+
+#endif
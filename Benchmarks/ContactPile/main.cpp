@@ -0,0 +1,75 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  main.cpp
+//  ContactPile
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "BenchmarkApp.h"
+#include <core/Console.h>
+#include <entities/statics/Plane.h>
+#include <entities/solids/Box.h>
+#include <entities/solids/Sphere.h>
+#include <utils/SystemUtil.hpp>
+#include <cmath>
+
+//Contact-heavy scene: a pile of boxes and spheres dropped on a plane
+int main(int argc, const char * argv[])
+{
+    BenchmarkReport report("ContactPile", argc, argv);
+    const unsigned int counts[] = {125, 500, 1000, 2000};
+    
+    for(unsigned int n : counts)
+    {
+        BenchmarkManager* sim = new BenchmarkManager(500.0, [n](BenchmarkManager* sm)
+        {
+            sm->CreateMaterial("Rock", 3000.0, 0.3);
+            sm->SetMaterialsInteraction("Rock", "Rock", 0.9, 0.7);
+            sm->AddStaticEntity(new sf::Plane("Ground", 1000.0, "Rock"), sf::I4());
+            
+            sf::BodyPhysicsSettings phy;
+            phy.mode = sf::BodyPhysicsMode::SURFACE;
+            phy.collisions = true;
+            unsigned int side = (unsigned int)std::ceil(std::cbrt((double)n));
+            for(unsigned int i=0; i<n; ++i)
+            {
+                sf::Vector3 pos((i % side) * 0.3, ((i / side) % side) * 0.3, -0.2 - (i / (side * side)) * 0.3);
+                pos += sf::Vector3(0.05 * ((i / side) % 2), 0.05 * ((i / (side * side)) % 2), 0.0); //Staggered layers
+                sf::SolidEntity* solid;
+                if(i % 2 == 0)
+                    solid = new sf::Box("Box" + std::to_string(i), phy, sf::Vector3(0.2, 0.2, 0.2), sf::I4(), "Rock", "");
+                else
+                    solid = new sf::Sphere("Sphere" + std::to_string(i), phy, 0.1, sf::I4(), "Rock", "");
+                sm->AddSolidEntity(solid, sf::Transform(sf::IQ(), pos));
+            }
+        });
+        BenchmarkApp app(report.getName(), sim);
+        app.Initialize();
+        
+        BenchmarkResult result = app.Simulate("bodies_" + std::to_string(n), 500, report.getSteps()); //Warmup lets the pile form
+        result.params["bodies"] = n;
+        result.metrics["contact_manifolds"] = sim->getDynamicsWorld()->getDispatcher()->getNumManifolds();
+        report.AddResult(result);
+    }
+    
+    return report.Save() ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  main.cpp
+//  HydrodynamicsKernel
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "BenchmarkApp.h"
+#include <core/Console.h>
+#include <entities/solids/Polyhedron.h>
+#include <entities/forcefields/Ocean.h>
+#include <entities/forcefields/Jet.h>
+#include <entities/forcefields/Uniform.h>
+#include <graphics/OpenGLDataStructs.h>
+#include <utils/SystemUtil.hpp>
+
+//Throughput of the hydrodynamic forces computation versus the number of faces of the body mesh
+int main(int argc, const char * argv[])
+{
+    BenchmarkReport report("HydrodynamicsKernel", argc, argv);
+    const char* meshes[] = {"icosphere.obj", "sphere_R=1.obj", "torus_R=1_r=025.obj", "hull_hydro.obj", "hull_hydro2.obj", "dragon.obj"};
+    
+    for(const char* mesh : meshes)
+    {
+        sf::Polyhedron* body = nullptr;
+        BenchmarkManager* sim = new BenchmarkManager(500.0, [mesh, &body](BenchmarkManager* sm)
+        {
+            sm->CreateMaterial("Neutral", 1000.0, 0.5);
+            sm->EnableOcean(0.0);
+            sm->getOcean()->AddVelocityField(new sf::Uniform(sf::Vector3(0.5, 0.0, 0.0)));
+            sm->getOcean()->AddVelocityField(new sf::Jet(sf::Vector3(0.0, 0.0, 10.0), sf::VY(), 0.5, 2.0)); //Spatially varying field
+            sm->getOcean()->EnableCurrents();
+            
+            sf::BodyPhysicsSettings phy;
+            phy.mode = sf::BodyPhysicsMode::SUBMERGED;
+            phy.collisions = false;
+            phy.buoyancy = true;
+            body = new sf::Polyhedron("Body", phy, sf::GetDataPath() + mesh, sf::Scalar(1), sf::I4(), "Neutral", "");
+            sm->AddSolidEntity(body, sf::Transform(sf::IQ(), sf::Vector3(0.0, 0.0, 10.0)));
+        });
+        BenchmarkApp app(report.getName(), sim);
+        app.Initialize();
+        
+        BenchmarkResult result = app.Simulate(mesh, 100, report.getSteps());
+        double faces = (double)body->getPhysicsMesh()->faces.size();
+        result.params["faces"] = faces;
+        auto hydro = result.phases.find(sf::PerformanceMonitor::getPhaseName(sf::PerformancePhase::HYDRODYNAMICS));
+        if(hydro != result.phases.end() && hydro->second.mean > 0.0)
+            result.metrics["faces_per_second"] = faces/(hydro->second.mean * 1e-6);
+        report.AddResult(result);
+    }
+    
+    return report.Save() ? 0 : 1;
+}
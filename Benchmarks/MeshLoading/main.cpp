@@ -0,0 +1,84 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  main.cpp
+//  MeshLoading
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "BenchmarkApp.h"
+#include <core/Console.h>
+#include <utils/GeometryFileUtil.h>
+#include <utils/SystemUtil.hpp>
+#include <filesystem>
+#include <algorithm>
+
+//Load time of the OBJ and STL meshes found in the test data directory (bypassing the mesh cache)
+int main(int argc, const char * argv[])
+{
+    BenchmarkReport report("MeshLoading", argc, argv, 5); //Steps = repetitions of each load
+    BenchmarkApp app(report.getName(), new BenchmarkManager(500.0, nullptr)); //Provides the console
+    
+    std::vector<std::filesystem::path> files;
+    for(const auto& entry : std::filesystem::directory_iterator(std::string(DATA_DIR_PATH)))
+    {
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if(entry.is_regular_file() && (ext == ".obj" || ext == ".stl"))
+            files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    
+    for(const auto& file : files)
+    {
+        BenchmarkResult result;
+        result.name = file.filename().string();
+        double size = (double)std::filesystem::file_size(file);
+        double minTime = 1e30;
+        double sumTime = 0.0;
+        
+        for(unsigned int i=0; i<report.getSteps(); ++i)
+        {
+            uint64_t start = sf::GetTimeInMicroseconds();
+            sf::Mesh* mesh = sf::LoadGeometryFromFile(file.string(), 1.f);
+            double t = (sf::GetTimeInMicroseconds() - start)/1000.0;
+            if(mesh == nullptr)
+                break;
+            minTime = std::min(minTime, t);
+            sumTime += t;
+            result.params["vertices"] = (double)mesh->getNumOfVertices();
+            result.params["faces"] = (double)mesh->faces.size();
+            delete mesh;
+        }
+        
+        result.params["file_size_bytes"] = size;
+        if(sumTime > 0.0)
+        {
+            result.metrics["min_load_time_ms"] = minTime;
+            result.metrics["mean_load_time_ms"] = sumTime/report.getSteps();
+            result.metrics["megabytes_per_second"] = size/(minTime * 1000.0);
+        }
+        cInfo("Loading '%s': %.3lf ms.", result.name.c_str(), minTime);
+        report.AddResult(result);
+    }
+    
+    return report.Save() ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  main.cpp
+//  RaycastSensors
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "BenchmarkApp.h"
+#include <core/Console.h>
+#include <core/FeatherstoneRobot.h>
+#include <entities/solids/Box.h>
+#include <entities/statics/Terrain.h>
+#include <sensors/scalar/Multibeam.h>
+#include <utils/SystemUtil.hpp>
+
+#define BEAMS_PER_SENSOR 256
+
+//Throughput of the raycast-based sensors (multibeam sonars looking at a terrain)
+int main(int argc, const char * argv[])
+{
+    BenchmarkReport report("RaycastSensors", argc, argv);
+    const unsigned int counts[] = {1, 4, 16, 64};
+    
+    for(unsigned int n : counts)
+    {
+        BenchmarkManager* sim = new BenchmarkManager(500.0, [n](BenchmarkManager* sm)
+        {
+            sm->CreateMaterial("Rock", 3000.0, 0.8);
+            sm->CreateMaterial("Aluminium", 2710.0, 0.7);
+            
+            sf::Terrain* seabed = new sf::Terrain("Seabed", sf::GetDataPath() + "terrain.png", 1.0, 1.0, 5.0, "Rock", "");
+            sm->AddStaticEntity(seabed, sf::Transform(sf::IQ(), sf::Vector3(0.0, 0.0, 15.0)));
+            
+            sf::BodyPhysicsSettings phy;
+            phy.mode = sf::BodyPhysicsMode::SURFACE;
+            phy.collisions = false;
+            sf::Box* frame = new sf::Box("Frame", phy, sf::Vector3(1.0, 1.0, 0.2), sf::I4(), "Aluminium", "");
+            sf::Robot* robot = new sf::FeatherstoneRobot("Survey", true);
+            robot->DefineLinks(frame);
+            robot->BuildKinematicStructure();
+            for(unsigned int i=0; i<n; ++i)
+            {
+                sf::Multibeam* mb = new sf::Multibeam("Multibeam" + std::to_string(i), 120.0, BEAMS_PER_SENSOR-1);
+                mb->setRange(0.1, 100.0);
+                sf::Scalar yaw = i * sf::Scalar(M_PI)/n; //Spread the swaths
+                robot->AddLinkSensor(mb, "Frame", sf::Transform(sf::Quaternion(yaw, -M_PI_2, 0.0), sf::Vector3(0.0, 0.0, 0.2)));
+            }
+            sm->AddRobot(robot, sf::Transform(sf::IQ(), sf::Vector3(0.0, 0.0, 0.0)));
+        });
+        BenchmarkApp app(report.getName(), sim);
+        app.Initialize();
+        
+        BenchmarkResult result = app.Simulate("sensors_" + std::to_string(n), 100, report.getSteps());
+        double rays = (double)n * BEAMS_PER_SENSOR;
+        result.params["sensors"] = n;
+        result.params["rays_per_step"] = rays;
+        auto sensors = result.phases.find(sf::PerformanceMonitor::getPhaseName(sf::PerformancePhase::SENSORS));
+        if(sensors != result.phases.end() && sensors->second.mean > 0.0)
+            result.metrics["rays_per_second"] = rays/(sensors->second.mean * 1e-6);
+        report.AddResult(result);
+    }
+    
+    return report.Save() ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  main.cpp
+//  ScenarioParsing
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "BenchmarkApp.h"
+#include "FleetScenario.h"
+#include <core/Console.h>
+#include <utils/MeshCache.h>
+#include <utils/SystemUtil.hpp>
+#include <filesystem>
+#include <algorithm>
+
+//Parse time of the girona500auv_console.scn scenario, with cold, disk-cached and memory-cached meshes
+int main(int argc, const char * argv[])
+{
+    BenchmarkReport report("ScenarioParsing", argc, argv, 10); //Steps = repetitions of each case
+    std::string scenario = WriteFleetScenario(1);
+    std::string defaultCacheDir = sf::MeshCache::getDiskCacheDirectory();
+    std::string benchCacheDir = (std::filesystem::temp_directory_path() / "stonefish_benchmark_cache").string();
+    std::filesystem::remove_all(benchCacheDir);
+    
+    uint64_t assetsTime = 0;
+    BenchmarkManager* sim = new BenchmarkManager(500.0, [&](BenchmarkManager* sm)
+    {
+        FleetParser parser(sm, 1, 0.0);
+        if(!parser.Parse(scenario))
+            cCritical("Failed to parse the benchmark scenario!");
+        assetsTime = parser.getAssetsTime();
+    });
+    BenchmarkApp app(report.getName(), sim);
+    app.Initialize();
+    
+    const char* cases[] = {"no_cache", "disk_cache", "memory_cache"};
+    for(const char* c : cases)
+    {
+        std::string name(c);
+        sf::MeshCache::setRetainUnused(name == "memory_cache"); //Otherwise purged when the previous scenario is destroyed
+        sf::MeshCache::setDiskCacheDirectory(name == "no_cache" ? "" : benchCacheDir);
+        sim->RestartScenario(); //Warmup (fills the caches)
+        
+        BenchmarkResult result;
+        result.name = name;
+        double minTime = 1e30;
+        double sumTime = 0.0;
+        double sumAssets = 0.0;
+        for(unsigned int i=0; i<report.getSteps(); ++i)
+        {
+            sim->RestartScenario();
+            double t = sim->getBuildTime()/1000.0;
+            minTime = std::min(minTime, t);
+            sumTime += t;
+            sumAssets += assetsTime/1000.0;
+        }
+        result.metrics["min_parse_time_ms"] = minTime;
+        result.metrics["mean_parse_time_ms"] = sumTime/report.getSteps();
+        result.metrics["mean_assets_time_ms"] = sumAssets/report.getSteps();
+        result.params["cached_meshes"] = (double)sf::MeshCache::getNumOfMeshes();
+        cInfo("Parsing with %s: %.1lf ms.", c, minTime);
+        report.AddResult(result);
+    }
+    
+    sf::MeshCache::setDiskCacheDirectory(defaultCacheDir);
+    std::filesystem::remove_all(benchCacheDir);
+    return report.Save() ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  main.cpp
+//  VehicleScaling
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "BenchmarkApp.h"
+#include "FleetScenario.h"
+#include <core/Console.h>
+
+//Scaling of the simulation step with the number of vehicles (girona500auv_console.scn), console application in lockstep
+int main(int argc, const char * argv[])
+{
+    BenchmarkReport report("VehicleScaling", argc, argv);
+    const unsigned int fleets[] = {1, 2, 4, 8, 16, 32};
+    
+    for(unsigned int n : fleets)
+    {
+        std::string scenario = WriteFleetScenario(n);
+        BenchmarkManager* sim = new BenchmarkManager(500.0, [n, scenario](BenchmarkManager* sm)
+        {
+            FleetParser parser(sm, n, 4.0);
+            if(!parser.Parse(scenario))
+                cCritical("Failed to parse the benchmark scenario!");
+        });
+        BenchmarkApp app(report.getName(), sim);
+        app.Initialize();
+        
+        BenchmarkResult result = app.Simulate("vehicles_" + std::to_string(n), 100, report.getSteps());
+        result.params["vehicles"] = n;
+        result.metrics["vehicle_steps_per_second"] = n * result.metrics["steps_per_second"];
+        report.AddResult(result);
+    }
+    
+    return report.Save() ? 0 : 1;
+}
@@ -98,6 +98,7 @@ namespace sf
         
     protected:
         virtual void ProcessMessages();
+        virtual size_t getInternalMemoryUsage();
         
         static AcousticModem* getNode(uint64_t deviceId);
         
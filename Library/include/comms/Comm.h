@@ -134,6 +134,9 @@ namespace sf
         //! A method returning the comm name.
         std::string getName();
         
+        //! A method returning the amount of memory used by the message buffers [B].
+        size_t getBufferMemoryUsage();
+        
         //! A method performing an internal update of the comm state.
         /*!
          \param dt the time step of the simulation [s]
@@ -148,6 +151,10 @@ namespace sf
         void MessageReceived(CommDataFrame* message);
         //! A method to proccess received messages.
         virtual void ProcessMessages() = 0;
+        //! A method returning the amount of memory used by the messages held by the specific device (called under the update lock).
+        virtual size_t getInternalMemoryUsage();
+        //! A method returning the amount of memory used by a single data frame.
+        static size_t getFrameMemoryUsage(const CommDataFrame* frame);
     
         bool newDataAvailable;
         std::deque<CommDataFrame*> txBuffer;
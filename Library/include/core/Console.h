@@ -42,14 +42,21 @@ namespace sf
     };
     
     //! A class implementing a text console.
+    /*!
+     The console keeps a bounded ring of the most recent messages. Printing on the standard output is performed
+     by a background thread, so that the calling thread does not wait for the terminal. Repeated messages are
+     collapsed into a single summary and the rate of info and warning messages printed on the standard output is limited
+     (all messages are stored).
+     */
     class Console
     {
     public:
         //! A constructor.
         /*!
          \param useStdout a flag enabling message printing on the system standard output
+         \param capacity the maximum number of messages stored in the console
          */
-        Console(bool useStdout = true);
+        Console(bool useStdout = true, size_t capacity = DEFAULT_CONSOLE_CAPACITY);
         
         //! A destructor.
         virtual ~Console();
@@ -62,12 +69,15 @@ namespace sf
         */
         void Print(MessageType t, std::string format, ...);
     
-        //! A method to add messages to the console
+        //! A method to add messages to the console (not printed on the standard output).
         /*!
          \param msg a message to append to the console lines
          */
         void AppendMessage(const ConsoleMessage& msg);
         
+        //! A method that waits until all messages are printed on the standard output.
+        void Flush();
+        
         //! A method that clears the console.
         void Clear();
 
@@ -78,16 +88,61 @@ namespace sf
          */
         bool SaveToFile(std::string filename);
     
+        //! A method to set the maximum rate of info and warning messages printed on the standard output (errors are never suppressed).
+        /*!
+         \param messagesPerSecond the maximum number of messages per second (0 disables the limit)
+         */
+        void setRateLimit(Scalar messagesPerSecond);
+        
         //! A method that returns a pointer to the console data mutex.
         SDL_mutex* getLinesMutex();
         
         //! A method that returns a copy of the console lines.
         std::vector<ConsoleMessage> getLines();
         
+        //! A method that returns the messages added after the one pointed by the cursor.
+        /*!
+         \param cursor the cursor returned by the previous call (0 to get all stored messages)
+         \param messages a reference to a vector to which the messages are appended
+         \return the cursor to be used in the next call
+         */
+        uint64_t getLines(uint64_t cursor, std::vector<ConsoleMessage>& messages);
+        
+        static constexpr size_t DEFAULT_CONSOLE_CAPACITY = 10000;
+        static constexpr Scalar DEFAULT_CONSOLE_RATE = 200.0;
+        
     protected:
+        size_t getNumOfLines() const;
+        const ConsoleMessage& getLine(size_t index) const;
+        
         bool stdoutEnabled;
-        std::vector<ConsoleMessage> lines;
+        std::vector<ConsoleMessage> lines; //Ring of messages
         SDL_mutex* linesMutex;
+        
+    private:
+        void Push(const ConsoleMessage& msg, bool echo);
+        void FlushRepeats();
+        static int WriteOutput(void* data);
+        static void Write(const ConsoleMessage& msg);
+        
+        std::vector<char> echo; //Should the message be printed on the standard output?
+        size_t capacity;
+        uint64_t total; //Number of messages added since creation
+        uint64_t first; //Number of the oldest stored message
+        uint64_t written; //Number of messages handled by the writer
+        uint64_t echoTotal; //Number of messages to be printed added since creation
+        uint64_t echoHandled; //Number of messages to be printed that were printed or dropped by the writer
+        MessageType lastType;
+        std::string lastText;
+        unsigned int repeats;
+        Scalar rate;
+        Scalar tokens;
+        int64_t lastRefill;
+        unsigned int suppressed;
+        bool quit;
+        SDL_cond* pending;
+        SDL_cond* flushed;
+        SDL_Thread* writer;
     };
 }
 
@@ -27,6 +27,8 @@
 #define __Stonefish_NameManager__
 
 #include "StonefishCommon.h"
+#include <unordered_set>
+#include <unordered_map>
 
 namespace sf
 {
@@ -57,7 +59,8 @@ namespace sf
         void ClearNames();
         
     private:
-        std::vector<std::string> names;
+        std::unordered_set<std::string> names;
+        std::unordered_map<std::string, int> nextNumber; //First numeric suffix that can be free, for each proposed name
     };
 }
     
@@ -0,0 +1,65 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ProfiledDynamicsWorld.h
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish_ProfiledDynamicsWorld__
+#define __Stonefish_ProfiledDynamicsWorld__
+
+#include "BulletSoftBody/btSoftMultiBodyDynamicsWorld.h"
+
+namespace sf
+{
+    class PerformanceMonitor;
+    
+    //! A dynamics world reporting the duration of the internal phases of the step to the performance monitor.
+    class ProfiledDynamicsWorld : public btSoftMultiBodyDynamicsWorld
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param dispatcher a pointer to the collision dispatcher
+         \param pairCache a pointer to the broadphase interface
+         \param constraintSolver a pointer to the multibody constraint solver
+         \param collisionConfiguration a pointer to the collision configuration
+         \param softBodySolver a pointer to the soft body solver
+         \param monitor a pointer to the performance monitor
+         */
+        ProfiledDynamicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* pairCache, btMultiBodyConstraintSolver* constraintSolver,
+                              btCollisionConfiguration* collisionConfiguration, btSoftBodySolver* softBodySolver, PerformanceMonitor* monitor);
+        
+        //! A method running the collision detection, measuring the broadphase and narrowphase separately.
+        void performDiscreteCollisionDetection();
+        
+        //! A method solving the constraints, measuring the duration.
+        /*!
+         \param solverInfo a reference to the solver settings
+         */
+        void solveConstraints(btContactSolverInfo& solverInfo);
+        
+    private:
+        PerformanceMonitor* perfMon;
+    };
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  RealtimeGovernor.h
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish_RealtimeGovernor__
+#define __Stonefish_RealtimeGovernor__
+
+#include <atomic>
+#include <vector>
+#include <map>
+#include "StonefishCommon.h"
+#include "utils/PerformanceMonitor.h"
+
+namespace sf
+{
+    class SimulationManager;
+    class Sensor;
+    
+    //! A structure holding the bounds within which the realtime governor can reduce the fidelity of the simulation.
+    struct RealtimeGovernorSettings
+    {
+        bool enabled; //Is the governor active?
+        Scalar degradeLoad; //Fraction of the realtime budget above which the fidelity is reduced
+        Scalar restoreLoad; //Fraction of the realtime budget below which the fidelity is restored
+        Scalar interval; //Time between consecutive decisions [s]
+        unsigned int maxPrescalerMultiplier; //Maximum multiplier of the fluid dynamics prescaler
+        Scalar minSensorRate; //Minimum fraction of the nominal update frequency of sensors
+        Scalar minVisionRate; //Minimum fraction of the nominal update frequency of vision sensors
+        bool meshLOD; //Can the fluid dynamics be computed using coarse physics meshes?
+        
+        RealtimeGovernorSettings() : enabled(false), degradeLoad(0.9), restoreLoad(0.6), interval(1.0), maxPrescalerMultiplier(4), 
+                                     minSensorRate(0.25), minVisionRate(0.25), meshLOD(true)
+        {
+        }
+    };
+    
+    //! A class implementing a governor that keeps the simulation in real time by reducing its fidelity.
+    /*!
+     The governor measures the fraction of the realtime budget used by the physics step and, when it is exceeded,
+     takes one decision per interval: it raises the fluid dynamics prescaler, lowers the update frequency of the
+     sensors and vision sensors (only the ones with a fixed rate) or switches the fluid dynamics computation
+     to the coarse versions of the physics meshes. The order depends on the most expensive phase of the step.
+     When the load drops, the decisions are reverted in the reverse order. Every decision is logged.
+     */
+    class RealtimeGovernor
+    {
+    public:
+        //! A constructor.
+        RealtimeGovernor();
+        
+        //! A method to update the governor after a simulation step (called by the simulation manager).
+        /*!
+         \param sm a pointer to the simulation manager
+         \param physicsTime the time spent computing the step [us]
+         \param elapsedTime the simulation clock time elapsed since the previous step [us]
+         */
+        void Update(SimulationManager* sm, double physicsTime, double elapsedTime);
+        
+        //! A method reverting all decisions, which restores the full fidelity of the simulation.
+        /*!
+         \param sm a pointer to the simulation manager
+         */
+        void Reset(SimulationManager* sm);
+        
+        //! A method to set the bounds of the governor.
+        /*!
+         \param s a structure holding the settings
+         */
+        void setSettings(const RealtimeGovernorSettings& s);
+        
+        //! A method returning the bounds of the governor.
+        RealtimeGovernorSettings getSettings() const;
+        
+        //! A method returning the number of active fidelity reductions.
+        unsigned int getDegradationLevel() const;
+        
+        //! A method returning the last measured fraction of the realtime budget used by the simulation.
+        double getLoad() const;
+        
+    private:
+        enum class Lever {FLUID_DYNAMICS_PRESCALER, MESH_LOD, VISION_RATE, SENSOR_RATE};
+        
+        struct Decision
+        {
+            Lever lever;
+            unsigned int prescaler; //Prescaler before the decision
+            Scalar rate; //Rate factor before the decision
+        };
+        
+        bool Degrade(SimulationManager* sm, Lever lever);
+        void Restore(SimulationManager* sm);
+        void ApplySensorRates(SimulationManager* sm, bool vision, Scalar factor);
+        unsigned int ApplyMeshLOD(SimulationManager* sm, bool enabled);
+        
+        RealtimeGovernorSettings settings;
+        std::vector<Decision> decisions;
+        std::map<Sensor*, Scalar> nominalRates;
+        unsigned int nominalPrescaler;
+        Scalar sensorRate;
+        Scalar visionRate;
+        bool saturated;
+        double accPhysicsTime;
+        double accElapsedTime;
+        std::atomic<double> load;
+        std::atomic<unsigned int> level;
+    };
+}
+
+#endif
@@ -30,6 +30,7 @@
 #include "core/Console.h"
 #include "tinyxml2.h"
 #include <map>
+#include <memory>
 
 using namespace tinyxml2;
 
@@ -46,6 +47,7 @@ namespace sf
     class VelocityField;
     class FixedJoint;
     struct Color;
+    struct Mesh;
     enum class ColorMap;
   
     //! A class that implements parsing of XML files describing a simulation scenario.
@@ -140,6 +142,13 @@ namespace sf
          */
         virtual bool ParseLooks(XMLElement* element);
         
+        //! A method used to load and process all meshes referenced in the scenario description, in parallel.
+        /*!
+         The results are stored in the mesh cache, so that the entities constructed afterwards only look them up.
+         \param root a pointer to the root node
+         */
+        virtual void PrepareAssets(XMLNode* root);
+        
         //! A method used to parse a definition of a velocity field (current, wind).
         /*!
          \param element a pointer to the XML node
@@ -284,6 +293,21 @@ namespace sf
         bool isGraphicalSim();
 
     private:
+        enum class AssetUse {MESH, REFINED_MESH, SOLID, OBSTACLE, ANIMATED, VBS_VOLUME};
+        
+        struct AssetRequest
+        {
+            AssetUse use;
+            std::string filename;
+            Scalar scale;
+            Scalar thickness;
+            Scalar density;
+            unsigned int hullVertices;
+            unsigned int decompositionParts;
+            bool convex;
+        };
+        
+        void CollectAssets(XMLElement* element, bool actuator, std::vector<AssetRequest>& assets);
         bool CopyNode(XMLNode* destParent, const XMLNode* src);
         bool ParseVector(const char* components, Vector3& v);
         bool ParseTransform(XMLElement* element, Transform& T);
@@ -293,6 +317,7 @@ namespace sf
         XMLDocument doc;
         SimulationManager* sm;
         bool graphical;
+        std::vector<std::shared_ptr<const Mesh>> preparedMeshes;
     };
 }
 
@@ -27,10 +27,12 @@
 #define __Stonefish_SimulationManager__
 
 #include "StonefishCommon.h"
+#include <unordered_map>
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
 #include "entities/SolidEntity.h"
 #include "utils/PerformanceMonitor.h"
+#include "core/RealtimeGovernor.h"
 
 namespace sf
 {
@@ -44,8 +46,11 @@ namespace sf
     class StaticEntity;
     class AnimatedEntity;
     class FeatherstoneEntity;
+    class TiledTerrain;
+    class Trigger;
     class Joint;
     class Actuator;
+    class SuctionCup;
     class Sensor;
     class Comm;
     class Contact;
@@ -69,6 +74,7 @@ namespace sf
     class SimulationManager
     {
         friend class OpenGLPipeline;
+        friend class RealtimeGovernor;
         
     public:
         //! A constructor.
@@ -264,6 +270,18 @@ namespace sf
          \param presc a prescaler used to compute the update frequency of fluid dynamics computations
          */
         void setFluidDynamicsPrescaler(unsigned int presc);
+        
+        //! A method returning the fluid dynamics prescaler.
+        unsigned int getFluidDynamicsPrescaler() const;
+        
+        //! A method that sets up the adaptive recomputation of fluid dynamics.
+        /*!
+         \param enabled a flag deciding if the bodies can reuse the forces computed previously when their state did not change
+         \param linearTolerance a change of position [m] or relative velocity [m/s] triggering recomputation, as a fraction of the body size (half of its bounding box diagonal)
+         \param angularTolerance a change of attitude [rad] or angular velocity [rad/s] triggering recomputation
+         \param maxSkipped a maximum number of consecutive recomputations that can be skipped for a single body
+         */
+        void setAdaptiveFluidDynamics(bool enabled, Scalar linearTolerance = Scalar(0.05), Scalar angularTolerance = Scalar(0.01), unsigned int maxSkipped = 10);
 
         //! A method that sets how simulation time relates to real time.
         /*!
@@ -466,6 +484,24 @@ namespace sf
         //! A method returning a reference to the performance monitor.
         PerformanceMonitor& getPerformanceMonitor();
 
+        //! A method returning the accumulated cost of the fluid dynamics computation for all bodies, sorted from the most expensive.
+        std::vector<std::pair<std::string, FluidDynamicsCost>> getFluidDynamicsCosts();
+        
+        //! A method that measures the memory used by the simulation subsystems and stores it in the performance monitor (waits for the current simulation step).
+        void UpdateMemoryUsage();
+        
+        //! A method that measures the memory used by the simulation subsystems and prints it to the console.
+        void ReportMemoryUsage();
+        
+        //! A method that sets up the realtime governor, which reduces the fidelity of the simulation when it cannot keep up with real time.
+        /*!
+         \param settings a structure holding the bounds of the fidelity reduction
+         */
+        void setRealtimeGovernor(const RealtimeGovernorSettings& settings);
+        
+        //! A method returning a reference to the realtime governor.
+        const RealtimeGovernor& getRealtimeGovernor() const;
+
         //! A method returning a pointer to the trackball view.
         OpenGLTrackball* getTrackball();
         
@@ -526,6 +562,9 @@ namespace sf
         static bool CustomMaterialCombinerCallback(btManifoldPoint& cp,	const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1);
         static bool ContactInfoUpdateCallback(btManifoldPoint& cp, void* body0, void* body1);
         static bool ContactInfoDestroyCallback(void* userPersistentData);
+        void RegisterEntity(Entity* ent);
+        void UnregisterEntity(Entity* ent);
+        std::vector<SolidEntity*> getFluidDynamicsBodies();
 
         btSoftMultiBodyDynamicsWorld* dynamicsWorld;
         btMultiBodyConstraintSolver* mbSolver;
@@ -538,9 +577,21 @@ namespace sf
         MaterialManager* materialManager;
         
     private:
+        //Hash of an unordered pair of entities
+        struct EntityPairHash
+        {
+            size_t operator()(const std::pair<const Entity*, const Entity*>& p) const
+            {
+                size_t h1 = std::hash<const Entity*>()(p.first);
+                size_t h2 = std::hash<const Entity*>()(p.second);
+                return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+            }
+        };
+        
         void RenderBulletDebug();
         void InitializeSolver();
         void InitializeScenario();
+        static std::pair<const Entity*, const Entity*> MakeEntityPair(const Entity* entA, const Entity* entB);
         
         // State
         Scalar simulationTime;
@@ -550,10 +601,12 @@ namespace sf
 
         // Performance
         PerformanceMonitor perfMon;
+        RealtimeGovernor governor;
         Scalar realtimeFactor;
         Scalar cpuUsage;
         unsigned int fdPrescaler;
         unsigned int fdCounter;
+        AdaptiveHydrodynamicsSettings fdAdaptive;
         
         // Threading
         SDL_mutex* simSettingsMutex;
@@ -589,6 +642,20 @@ namespace sf
         std::vector<Comm*> comms;
         std::vector<Contact*> contacts;
         std::vector<Collision> collisions;
+        std::vector<SolidEntity*> solids; //Entities grouped by role (iterated every simulation step)
+        std::vector<FeatherstoneEntity*> multibodies;
+        std::vector<AnimatedEntity*> animated;
+        std::vector<TiledTerrain*> terrains;
+        std::vector<Trigger*> triggers;
+        std::vector<SuctionCup*> suctionCups;
+        std::unordered_map<std::string, Robot*> robotIndex; //Indices of objects by name (names are unique)
+        std::unordered_map<std::string, Entity*> entityIndex;
+        std::unordered_map<std::string, Joint*> jointIndex;
+        std::unordered_map<std::string, Sensor*> sensorIndex;
+        std::unordered_map<std::string, Actuator*> actuatorIndex;
+        std::unordered_map<std::string, Comm*> commIndex;
+        std::unordered_map<std::string, Contact*> contactIndex;
+        std::unordered_map<std::pair<const Entity*, const Entity*>, Contact*, EntityPairHash> contactPairs; //Contacts by entity pair (ordered by address)
         NED* ned;
         Ocean* ocean;
         Atmosphere* atmosphere;
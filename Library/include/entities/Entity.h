@@ -51,6 +51,7 @@ namespace sf
     enum class DisplayMode {GRAPHICAL, PHYSICAL};
     
     struct Renderable;
+    struct Mesh;
     class SimulationManager;
     
     //! An abstract class representing a simulation entity.
@@ -97,6 +98,13 @@ namespace sf
          */
         virtual void getAABB(Vector3& min, Vector3& max) = 0;
         
+        //! A method collecting the meshes kept in memory by the entity (used for memory accounting).
+        /*!
+         \param graphics a reference to a list of meshes used only for rendering
+         \param physics a reference to a list of meshes used for physics
+         */
+        virtual void getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics);
+        
     private:
         bool renderable;
         std::string name;
@@ -393,6 +393,13 @@ namespace sf
          */
         void getAABB(Vector3& min, Vector3& max);
         
+        //! A method collecting the meshes kept in memory by the links of the multibody.
+        /*!
+         \param graphics a reference to a list of meshes used only for rendering
+         \param physics a reference to a list of meshes used for physics
+         */
+        void getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics);
+        
         //! A method returning the type of the entity.
         EntityType getType() const;
         
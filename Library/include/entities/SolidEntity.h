@@ -26,6 +26,8 @@
 #ifndef __Stonefish_SolidEntity__
 #define __Stonefish_SolidEntity__
 
+#include <memory>
+#include <atomic>
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "core/MaterialManager.h"
 #include "entities/MovingEntity.h"
@@ -59,8 +61,39 @@ namespace sf
         {
         }
     };
+    //! A structure holding face data of a mesh, precomputed in the mesh frame and stored as a structure of arrays (vectorisation).
+    struct MeshFaceData
+    {
+        std::vector<GLfloat> cx, cy, cz; //Face centroids
+        std::vector<GLfloat> nx, ny, nz; //Face unit normals
+        std::vector<GLfloat> area; //Face areas
+        mutable std::vector<GLfloat> vrx, vry, vrz; //Scratch buffers for the relative fluid velocity at face centroids (used by the thread computing the forces of the body)
+    };
+
+    //! A structure holding the accumulated cost of the fluid dynamics computation for a body.
+    struct FluidDynamicsCost
+    {
+        unsigned long long hydroEvaluations; //Number of computations of hydrodynamic forces
+        unsigned long long hydroReused; //Number of hydrodynamics updates in which the previously computed forces were reused
+        unsigned long long aeroEvaluations; //Number of computations of aerodynamic forces
+        unsigned long long faces; //Total number of processed mesh faces
+        double hydroTime; //Total time of the computation of hydrodynamic forces [us]
+        double aeroTime; //Total time of the computation of aerodynamic forces [us]
+        unsigned long long inside; //Number of hydrodynamics computations with the body fully submerged
+        unsigned long long outside; //Number of hydrodynamics computations with the body out of the fluid
+        unsigned long long crossing; //Number of hydrodynamics computations with the body crossing the fluid surface
+        
+        FluidDynamicsCost() : hydroEvaluations(0), hydroReused(0), aeroEvaluations(0), faces(0), hydroTime(0.0), aeroTime(0.0), inside(0), outside(0), crossing(0)
+        {
+        }
+        
+        //! A method returning the total time of the computation [us].
+        double getTotalTime() const { return hydroTime + aeroTime; }
+    };
 
     struct HydrodynamicsSettings;
+    struct HydrodynamicsCounters;
+    struct AdaptiveHydrodynamicsSettings;
     class Ocean;
     class Atmosphere;
     
@@ -119,6 +152,14 @@ namespace sf
          */
         virtual void ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn);
         
+        //! A method deciding if the fluid dynamics of the body has to be recomputed or the cached forces can be reused.
+        /*!
+         \param settings a structure holding settings of the adaptive recomputation
+         \param ocn a pointer to the ocean entity
+         \return true if the forces have to be recomputed
+         */
+        bool CheckHydrodynamicsRecompute(const AdaptiveHydrodynamicsSettings& settings, Ocean* ocn);
+        
         //! A method that corrects damping forces based on geometry approximation
         /*!
          \param ocn a pointer to the fluid entity generating forces (currently only Ocean supported)
@@ -196,6 +237,27 @@ namespace sf
         static void ComputeAerodynamicForces(const Mesh* mesh, Atmosphere* atm, const Transform& T_CG, const Transform& T_C,
                                              const Vector3& linearV, const Vector3& angularV, Vector3& _Fda, Vector3& _Tda);
         
+        //! A static method that computes aerodynamics for a body, based on precomputed face data.
+        /*!
+         \param faces the face data of the body physics mesh
+         \param atm a pointer to the atmosphere object
+         \param T_CG a transform from the world frame to the body CG frame
+         \param T_C a transform from the world frame to the body physics frame
+         \param linearV the linear velocity of the body in the world frame
+         \param angularV the angular velocity of the body in the world frame
+         \param _Fda output of the damping force resulting from pressure drag
+         \param _Tda output of the torque induced by pressure drag
+         */
+        static void ComputeAerodynamicForces(const MeshFaceData& faces, Atmosphere* atm, const Transform& T_CG, const Transform& T_C,
+                                             const Vector3& linearV, const Vector3& angularV, Vector3& _Fda, Vector3& _Tda);
+        
+        //! A static method that precomputes face data of a mesh.
+        /*!
+         \param mesh a pointer to the mesh data
+         \param faces output of the face data (degenerate faces are skipped)
+         */
+        static void BuildFaceData(const Mesh* mesh, MeshFaceData& faces);
+        
         //! A method which applies given force to the body CG.
         /*!
          \param force a force to be applied to the body, in the world frame
@@ -366,6 +428,19 @@ namespace sf
         
         //! A method returning a pointer to the physics mesh.
         const Mesh* getPhysicsMesh();
+        
+        //! A method returning the face data of the physics mesh (built together with the mesh).
+        const MeshFaceData& getPhysicsFaceData();
+        
+        //! A method to switch the fluid dynamics computation to a coarse version of the physics mesh (level of detail).
+        /*!
+         \param enabled a flag deciding if the coarse mesh should be used
+         \return was the coarse mesh available and the switch performed?
+         */
+        virtual bool setPhysicsMeshLOD(bool enabled);
+        
+        //! A method informing if the fluid dynamics computation is using the coarse version of the physics mesh.
+        bool isUsingPhysicsMeshLOD() const;
 
         //! A method that returns a copy of all physics mesh vertices in body origin frame.
         virtual std::vector<Vector3>* getMeshVertices() const;
@@ -373,6 +448,25 @@ namespace sf
         //! A method informing if the body is using buoyancy computation.
         bool isBuoyant() const;
         
+        //! A method returning the accumulated cost of the fluid dynamics computation for the body.
+        FluidDynamicsCost getFluidDynamicsCost() const;
+        
+        //! A method resetting the accumulated cost of the fluid dynamics computation.
+        void ResetFluidDynamicsCost();
+        
+        //! A method setting the counters of the adaptive hydrodynamics reported through the performance monitor.
+        /*!
+         \param counters a pointer to the counters owned by the performance monitor (nullptr to disable)
+         */
+        void setHydrodynamicsCounters(HydrodynamicsCounters* counters);
+        
+        //! A method adding the time of a fluid dynamics computation to the accumulated cost (called by the force fields).
+        /*!
+         \param us the time of the computation [us]
+         \param aerodynamics a flag indicating if the aerodynamic forces were computed
+         */
+        void AddFluidDynamicsTime(double us, bool aerodynamics);
+        
         //! A method informing what kind of physics computations are performed for the body.
         BodyPhysicsMode getBodyPhysicsMode() const;
         
@@ -390,6 +484,13 @@ namespace sf
          */
         void getAABB(Vector3& min, Vector3& max);
         
+        //! A method collecting the meshes kept in memory by the body.
+        /*!
+         \param graphics a reference to a list of meshes used only for rendering
+         \param physics a reference to a list of meshes used for physics
+         */
+        virtual void getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics);
+        
         //! A method used to set if the body CG should be rendered.
         void setDisplayCoordSys(bool enabled);
         
@@ -398,10 +499,16 @@ namespace sf
         
     protected:
         BodyFluidPosition CheckBodyFluidPosition(Ocean* ocn);
+        BodyFluidPosition CheckBodyFluidPosition(Ocean* ocn, const Vector3& aabbMin, const Vector3& aabbMax);
+        BodyFluidPosition GetBodyFluidPosition(Ocean* ocn);
+        void CountHydrodynamicsEvaluation(BodyFluidPosition bf, size_t faces);
+        void CountAerodynamicsEvaluation(size_t faces);
+        virtual std::shared_ptr<const Mesh> BuildPhysicsMeshLOD();
         void ComputeFluidDynamicsApprox(GeometryApproxType t);
         void ComputeSphericalApprox();
         void ComputeCylindricalApprox();
         void ComputeEllipsoidalApprox();
+        bool FitEllipsoid(Vector3& axes);
         
         Scalar LambKFactor(Scalar r1, Scalar r2);
         virtual void BuildRigidBody(btDynamicsWorld* world);
@@ -410,7 +517,11 @@ namespace sf
         //Body
         btMultiBodyLinkCollider* multibodyCollider;
         
-        Mesh* phyMesh; //Mesh used for physics calculation
+        std::shared_ptr<const Mesh> phyMesh; //Mesh used for physics calculation (may be shared with the mesh cache)
+        MeshFaceData phyFaces; //Face data of the physics mesh
+        std::shared_ptr<const Mesh> phyMeshLOD; //Coarse version of the physics mesh (built on first use)
+        MeshFaceData phyFacesLOD; //Face data of the coarse physics mesh
+        bool useLOD;
         Scalar thick;
         Scalar volume;
         Scalar surface;
@@ -452,6 +563,25 @@ namespace sf
         Vector3 Fda;
         Vector3 Tda;
         
+        //State at last fluid dynamics computation (adaptive recomputation)
+        bool hydroCached;
+        unsigned int hydroSkipped;
+        Transform hydroT;
+        Vector3 hydroV;
+        Vector3 hydroOmega;
+        BodyFluidPosition hydroBf;
+        bool hydroBfFresh; //Position checked in the current update, not yet used by the force computation
+        HydrodynamicsCounters* hydroCounters;
+        
+        //Cost of fluid dynamics (written by the thread computing the forces of the body, read by any thread)
+        std::atomic<unsigned long long> fdcHydroEvaluations;
+        std::atomic<unsigned long long> fdcHydroReused;
+        std::atomic<unsigned long long> fdcAeroEvaluations;
+        std::atomic<unsigned long long> fdcFaces;
+        std::atomic<double> fdcHydroTime;
+        std::atomic<double> fdcAeroTime;
+        std::atomic<unsigned long long> fdcPosition[3];
+        
         //Motion
         Vector3 lastV;
         Vector3 lastOmega;
@@ -32,7 +32,7 @@
 namespace sf
 {
     //! An enum specifiying the type of the static entity.
-    enum class StaticEntityType {PLANE, TERRAIN, OBSTACLE};
+    enum class StaticEntityType {PLANE, TERRAIN, TILED_TERRAIN, OBSTACLE};
     
     struct Mesh;
     
@@ -74,6 +74,13 @@ namespace sf
          */
         virtual void getAABB(Vector3& min, Vector3& max);
         
+        //! A method collecting the meshes kept in memory by the entity.
+        /*!
+         \param graphics a reference to a list of meshes used only for rendering
+         \param physics a reference to a list of meshes used for physics
+         */
+        virtual void getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics);
+        
         //! A method used to set new origin of the entity in the world frame.
         /*!
          \param trans a transformation of the entity origin in the world frame
@@ -78,6 +78,12 @@ namespace sf
          */
         void AddVelocityField(VelocityField* field);
         
+        //! A method updating the time-dependent state of the winds.
+        /*!
+         \param t current simulation time [s]
+         */
+        void UpdateVelocityFields(Scalar t);
+        
         //! A method running the aerodynamics computation.
         /*!
          \param world a pointer to the dynamics world
@@ -101,6 +107,12 @@ namespace sf
         Vector3 GetFluidVelocity(const Vector3& point) const;
         glm::vec3 GetFluidVelocity(const glm::vec3& point) const;
         
+        //! A method informing if the air velocity is the same in the whole atmosphere (refreshed every simulation step).
+        /*!
+         \return true if there are no winds or all winds are uniform
+         */
+        bool isFlowUniform() const;
+        
         //! A method checking if a point is inside atmosphere.
         /*!
          \param point the position of a point to be checked [m]
@@ -127,6 +139,10 @@ namespace sf
         Fluid gas;
         std::vector<VelocityField*> wind;
         OpenGLAtmosphere* glAtmosphere;
+        bool uniformFlow;
+        Vector3 uniformVelocity;
+        
+        void UpdateUniformFlow();
     };
 }
 
@@ -0,0 +1,127 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Gridded.h
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish_Gridded__
+#define __Stonefish_Gridded__
+
+#include <atomic>
+#include "entities/forcefields/VelocityField.h"
+
+namespace sf
+{
+    //! Gridded velocity field class.
+    /*!
+     Class implements a time-varying velocity field defined on a regular or rectilinear 4D grid (x, y, z, t),
+     e.g., the output of an ocean circulation model. The data is memory-mapped from a binary file and only
+     the time slices surrounding the current simulation time are paged in. The velocity is interpolated
+     trilinearly in space and linearly in time. Outside of the spatial domain the velocity is zero, while
+     outside of the time span the first/last slice is held (or the data is looped if requested).
+
+     Binary file layout (little-endian):
+     - char[4] magic "SFVF"
+     - uint32 version (1)
+     - uint32 nx, ny, nz, nt
+     - float64 x[nx], y[ny], z[nz] grid coordinates in the world frame [m], strictly increasing
+     - float64 t[nt] time stamps [s], strictly increasing
+     - float32 v[nt][nz][ny][nx][3] velocity in the world frame [m/s]
+
+     Non-finite samples (e.g. land masks) are treated as zero velocity.
+     */
+    class Gridded : public VelocityField
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param filename a path to the binary file containing the gridded data
+         \param timeOffset the time in the data corresponding to the start of simulation [s]
+         \param loop a flag to decide if the data should be looped in time
+         */
+        Gridded(const std::string& filename, Scalar timeOffset = Scalar(0), bool loop = false);
+
+        //! A destructor.
+        ~Gridded();
+
+        //! A method returning velocity at a specified point.
+        /*!
+         \param p a point at which the velocity is requested
+         \return velocity [m/s]
+         */
+        Vector3 GetVelocityAtPoint(const Vector3& p) const;
+
+        //! A method updating the time slices used for interpolation.
+        /*!
+         \param t current simulation time [s]
+         */
+        void Update(Scalar t);
+
+        //! A method implementing the rendering of the gridded field.
+        std::vector<Renderable> Render(VelocityFieldUBO& ubo);
+
+        //! A method returning the spatial extent of the grid.
+        /*!
+         \param min a reference to a variable that will store the minimum corner of the grid [m]
+         \param max a reference to a variable that will store the maximum corner of the grid [m]
+         */
+        void getDomain(Vector3& min, Vector3& max) const;
+
+        //! A method returning the time span of the data.
+        /*!
+         \param start a reference to a variable that will store the first time stamp [s]
+         \param end a reference to a variable that will store the last time stamp [s]
+         */
+        void getTimeSpan(Scalar& start, Scalar& end) const;
+
+        //! A method returning the type of the velocity field.
+        VelocityFieldType getType() const;
+
+    private:
+        struct GridAxis
+        {
+            const double* c;
+            unsigned int n;
+            bool regular;
+            double step;
+        };
+
+        void SetupAxis(GridAxis& axis, const double* coords, unsigned int n);
+        bool FindCell(const GridAxis& axis, Scalar x, unsigned int& i0, unsigned int& i1, Scalar& f) const;
+        Vector3 SampleSlice(unsigned int k, unsigned int ix[2], unsigned int iy[2], unsigned int iz[2], Scalar fx, Scalar fy, Scalar fz) const;
+        void PageSlices(unsigned int first, unsigned int last);
+
+        void* map;
+        size_t mapSize;
+        size_t pageSize;
+        size_t dataOffset;
+        size_t sliceSize;
+        const float* data;
+        GridAxis ax, ay, az, at;
+        Scalar tOffset;
+        bool looped;
+        std::atomic<uint64_t> slices; //Index of the first time slice and interpolation factor, published together (read by other threads)
+        unsigned int residentFirst, residentLast;
+    };
+}
+
+#endif
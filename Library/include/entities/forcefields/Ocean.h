@@ -40,6 +40,15 @@ namespace sf
         bool reallisticBuoyancy;
     };
     
+    //! A structure holding settings of the adaptive recomputation of hydrodynamics.
+    struct AdaptiveHydrodynamicsSettings
+    {
+        bool enabled;
+        Scalar linearTolerance; //Change of position [m] and relative velocity [m/s] triggering recomputation, relative to the body size
+        Scalar angularTolerance; //Change of attitude [rad] and angular velocity [rad/s] triggering recomputation
+        unsigned int maxSkipped; //Maximum number of consecutive recomputations that can be skipped
+    };
+    
     class VelocityField;
     class Actuator;
     
@@ -64,13 +73,20 @@ namespace sf
          */
         void AddVelocityField(VelocityField* field);
         
+        //! A method updating the time-dependent state of the currents.
+        /*!
+         \param t current simulation time [s]
+         */
+        void UpdateVelocityFields(Scalar t);
+        
         //! A method running the hydrodynamics computation.
         /*!
          \param world a pointer to the dynamics world
          \param co a pointer to the collision object
          \param recompute a flag deciding if hydrodynamic forces need to be recomputed
+         \param adaptive settings of the adaptive recomputation (allowing bodies to reuse cached forces)
          */
-        void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute);
+        void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute, const AdaptiveHydrodynamicsSettings& adaptive);
         
         //! A method returning the water velocity.
         /*!
@@ -80,6 +96,12 @@ namespace sf
         Vector3 GetFluidVelocity(const Vector3& point) const;
         glm::vec3 GetFluidVelocity(const glm::vec3& point) const;
         
+        //! A method informing if the water velocity is the same in the whole ocean (refreshed every simulation step).
+        /*!
+         \return true if currents are disabled or all enabled currents are uniform
+         */
+        bool isFlowUniform() const;
+        
         //! A method checking if a point is inside fluid
         /*!
          \param point the position of a point to be checked [m]
@@ -167,6 +189,12 @@ namespace sf
         Scalar oceanState;
         bool currentsEnabled;
         Renderable wavesDebug;
+        SDL_mutex* flowMutex; //Guards the uniform flow cache (updated by the simulation, read by other threads)
+        bool uniformFlow;
+        Vector3 uniformVelocity;
+        glm::vec3 uniformVelocityGL;
+        
+        void UpdateUniformFlow();
     };
 }
 
@@ -32,9 +32,11 @@ namespace sf
 {
     //! Stream (current) velocity field class.
     /*!
-     Class implements a velocity field in a shape of a tube along a Hermite spline, with variable diameter.
+     Class implements a velocity field in a shape of a tube along a cubic spline, with variable diameter.
      The flow velocity is specified at the centre of the beginning of the tube (tanget to spline).
      The closer to the boundary the slower the flow (zero at boudary).
+     The spline is sampled into an arc-length parameterised polyline at construction and the polyline
+     segments are stored in a bounding volume hierarchy, to make the per-point projection cheap.
      */
     class Stream : public VelocityField
     {
@@ -48,6 +50,9 @@ namespace sf
          */
         Stream(const std::vector<Vector3>& streamline, const std::vector<Scalar>& radius, Scalar inputVelocity, Scalar exponent);
         
+        //! A method returning the total length of the stream line.
+        Scalar getLength() const;
+        
         //! A method returning velocity at a specified point.
         /*!
          \param p a point at which the velocity is requested
@@ -62,10 +67,28 @@ namespace sf
         VelocityFieldType getType() const;
         
     private:
+        struct BVHNode
+        {
+            Vector3 aabbMin;
+            Vector3 aabbMax;
+            unsigned int first; //First segment (leaf) or right child (internal node)
+            unsigned int count; //Number of segments (0 for internal nodes)
+        };
+        
+        void BuildPolyline();
+        unsigned int BuildBVH(unsigned int first, unsigned int count);
+        
         std::vector<Vector3> c;
         std::vector<Scalar> r;
         Scalar vin;
         Scalar gamma;
+        
+        std::vector<Vector3> pts;  //Polyline vertices
+        std::vector<Vector3> tan;  //Unit tangents at vertices
+        std::vector<Scalar> rad;   //Radius at vertices
+        std::vector<Scalar> arc;   //Arc length at vertices
+        std::vector<BVHNode> bvh;
+        std::vector<unsigned int> segs;
     };
 }
 
@@ -32,7 +32,7 @@
 namespace sf
 {
     //! An enum representing the type of a velocity field.
-    enum class VelocityFieldType {UNIFORM, JET, PIPE, STREAM};
+    enum class VelocityFieldType {UNIFORM, JET, PIPE, STREAM, GRIDDED};
 
     //! An abstract class representing a velocity field.
     class VelocityField
@@ -51,6 +51,12 @@ namespace sf
          */
         virtual Vector3 GetVelocityAtPoint(const Vector3& p) const = 0;
         
+        //! A method updating the time-dependent state of the velocity field.
+        /*!
+         \param t current simulation time [s]
+         */
+        virtual void Update(Scalar t);
+
         //! A method implementing the rendering of the velocity field.
         virtual std::vector<Renderable> Render(VelocityFieldUBO& ubo) = 0;
 
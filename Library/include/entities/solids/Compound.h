@@ -110,6 +110,20 @@ namespace sf
         //! A method that returns a copy of all physics mesh vertices in body origin frame.
         std::vector<Vector3>* getMeshVertices() const;
         
+        //! A method to switch the fluid dynamics computation of all parts to the coarse versions of their physics meshes.
+        /*!
+         \param enabled a flag deciding if the coarse meshes should be used
+         \return was the switch performed for at least one of the parts?
+         */
+        bool setPhysicsMeshLOD(bool enabled);
+        
+        //! A method collecting the meshes kept in memory by the body and its parts.
+        /*!
+         \param graphics a reference to a list of meshes used only for rendering
+         \param physics a reference to a list of meshes used for physics
+         */
+        void getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics);
+        
         //! A method that informs if the internal parts of the body are displayed.
         bool isDisplayingInternalParts();
         
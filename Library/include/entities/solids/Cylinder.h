@@ -53,6 +53,9 @@ namespace sf
         //! A method that returns the collision shape for the cylinder.
         btCollisionShape* BuildCollisionShape();
         
+    protected:
+        std::shared_ptr<const Mesh> BuildPhysicsMeshLOD();
+        
     private:
         Scalar r;
         Scalar halfHeight;
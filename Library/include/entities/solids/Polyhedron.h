@@ -81,8 +81,40 @@ namespace sf
         //! A method used to build the graphical representation of the body.
         void BuildGraphicalObject();
         
+        //! A method setting the maximum number of vertices of the collision hull (has to be called before adding the body to the simulation).
+        /*!
+         \param n the maximum number of vertices (0 to use the exact hull)
+         */
+        void setMaxHullVertices(unsigned int n);
+        
+        //! A method returning the maximum number of vertices of the collision hull.
+        unsigned int getMaxHullVertices() const;
+        
+        //! A method enabling the approximate convex decomposition of the collision geometry (has to be called before adding the body to the simulation).
+        /*!
+         \param maxParts the maximum number of convex parts (0 or 1 to use a single convex hull)
+         */
+        void setConvexDecomposition(unsigned int maxParts);
+        
+        //! A method returning the maximum number of convex parts of the collision geometry.
+        unsigned int getConvexDecomposition() const;
+        
+        //! A method collecting the meshes kept in memory by the body.
+        /*!
+         \param graphics a reference to a list of meshes used only for rendering
+         \param physics a reference to a list of meshes used for physics
+         */
+        void getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics);
+        
+    protected:
+        std::shared_ptr<const Mesh> BuildPhysicsMeshLOD();
+        
     private:
-        Mesh *graMesh; //Mesh used for rendering
+        std::shared_ptr<const Mesh> graMesh; //Mesh used for rendering
+        std::string phyFilename; //Path to the file of the physics mesh (used to load the coarse version)
+        GLfloat phyScale;
+        unsigned int hullVertices; //Maximum number of vertices of the collision hull(s)
+        unsigned int decompositionParts; //Maximum number of convex parts of the collision geometry
     };
 }
 
@@ -52,6 +52,9 @@ namespace sf
         //! A method that returns the collision shape for the sphere.
         btCollisionShape* BuildCollisionShape();
         
+    protected:
+        std::shared_ptr<const Mesh> BuildPhysicsMeshLOD();
+        
     private:
         Scalar r;
     };
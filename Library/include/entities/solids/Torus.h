@@ -54,6 +54,9 @@ namespace sf
         //! A method that returns the collision shape for the torus.
         btCollisionShape* BuildCollisionShape();
         
+    protected:
+        std::shared_ptr<const Mesh> BuildPhysicsMeshLOD();
+        
     private:
         Scalar mR;
         Scalar MR;
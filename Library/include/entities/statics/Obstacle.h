@@ -26,6 +26,7 @@
 #ifndef __Stonefish_Obstacle__
 #define __Stonefish_Obstacle__
 
+#include <memory>
 #include "entities/StaticEntity.h"
 
 namespace sf
@@ -105,9 +106,20 @@ namespace sf
         //! A method that returns the static body type.
         StaticEntityType getStaticType();
         
+        //! A method collecting the meshes kept in memory by the obstacle.
+        /*!
+         \param graphics a reference to a list of meshes used only for rendering
+         \param physics a reference to a list of meshes used for physics
+         */
+        void getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics);
+        
     private:
         void BuildGraphicalObject();
-        Mesh* graMesh;
+        std::shared_ptr<const Mesh> graMesh; //Mesh used for rendering (shared through the mesh cache)
+        std::shared_ptr<const Mesh> sharedPhyMesh; //Mesh used for physics (shared through the mesh cache)
+        std::shared_ptr<btBvhTriangleMeshShape> triangleShape; //Collision shape shared through the mesh cache
+        Transform T_O2G;
+        Transform T_O2C;
         int graObjectId;
     };
 }
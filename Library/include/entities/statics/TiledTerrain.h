@@ -0,0 +1,156 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  TiledTerrain.h
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish_TiledTerrain__
+#define __Stonefish_TiledTerrain__
+
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+#include "entities/StaticEntity.h"
+
+#define TILED_TERRAIN_RENDER_SAMPLES 1024
+
+class btDynamicsWorld;
+
+namespace sf
+{
+    //! A class representing a large heightfield terrain, streamed in tiles.
+    /*!
+     Class implements a terrain that does not have to fit in memory, e.g., survey-grade bathymetry.
+     The heights are memory-mapped from a binary file and divided into square tiles. Each tile gets
+     its own heightfield collision shape, which is created when a dynamic body gets closer to the tile
+     than the load distance and destroyed when all of the dynamic bodies are further than the evict distance.
+     The terrain is rendered using a single mesh, downsampled to at most TILED_TERRAIN_RENDER_SAMPLES
+     samples along each axis. The grid is centred at the origin of the terrain and the heights are
+     measured along the Z axis.
+
+     Binary file layout (little-endian):
+     - char[4] magic "SFHT"
+     - uint32 version (1)
+     - uint32 nx, ny number of samples along the X and Y axis (at least 2)
+     - uint32 tile size in cells (the tiles share the border samples)
+     - uint32 reserved (0)
+     - float64 dx, dy distance between samples [m]
+     - float32 h[nty][ntx][...] tiles in row-major order, each storing its samples in row-major order [m]
+     */
+    class TiledTerrain : public StaticEntity
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param uniqueName a name for the terrain
+         \param pathToHeights a path to the binary file containing the tiled heights
+         \param loadDistance the distance from a dynamic body at which the tiles are loaded [m]
+         \param evictDistance the distance from all dynamic bodies at which the tiles are evicted [m]
+         \param material the name of the material the terrain is made of
+         \param look the name of the graphical material used for rendering
+         \param uvScale scaling of texture coordinates
+         */
+        TiledTerrain(std::string uniqueName, std::string pathToHeights, Scalar loadDistance, Scalar evictDistance,
+                     std::string material, std::string look = "", float uvScale = 1.f);
+        
+        //! A destructor.
+        ~TiledTerrain();
+        
+        //! A method used to add the terrain to the simulation.
+        /*!
+         \param sm a pointer to the simulation manager
+         \param origin the origin of the terrain in the world frame
+         */
+        void AddToSimulation(SimulationManager* sm, const Transform& origin);
+        
+        //! A method loading the tiles close to dynamic bodies and evicting the distant ones.
+        /*!
+         \param world a pointer to the dynamics world
+         */
+        void UpdateTiles(btDynamicsWorld* world);
+        
+        //! A method implementing the rendering of the terrain.
+        std::vector<Renderable> Render();
+        
+        //! A method returning the extents of the terrain axis alligned bounding box.
+        /*!
+         \param min a point located at the minimum coordinate corner
+         \param max a point located at the maximum coordinate corner
+         */
+        void getAABB(Vector3& min, Vector3& max);
+        
+        //! A method returning the total number of tiles.
+        unsigned int getNumOfTiles() const;
+        
+        //! A method returning the number of tiles currently loaded.
+        unsigned int getNumOfLoadedTiles() const;
+        
+        //! A method returning the type of static entity.
+        StaticEntityType getStaticType();
+        
+        //! A static method converting a raw heightmap to the tiled format.
+        /*!
+         The input file has to contain nx*ny float32 heights in row-major order. It is memory-mapped
+         and converted one row of tiles at a time, so it does not have to fit in memory.
+         \param rawPath a path to the raw heightmap file
+         \param nx the number of samples along the X axis
+         \param ny the number of samples along the Y axis
+         \param dx the distance between samples along the X axis [m]
+         \param dy the distance between samples along the Y axis [m]
+         \param tileSize the size of a tile in cells
+         \param outputPath a path to the output file
+         \return was the conversion successful?
+         */
+        static bool ConvertRawHeightmap(const std::string& rawPath, unsigned int nx, unsigned int ny, Scalar dx, Scalar dy,
+                                        unsigned int tileSize, const std::string& outputPath);
+        
+    private:
+        struct Tile
+        {
+            btHeightfieldTerrainShape* shape;
+            btRigidBody* body;
+            uint64_t used; //Last update in which the tile was in range of a dynamic body
+        };
+        
+        void TileSize(unsigned int tx, unsigned int ty, unsigned int& w, unsigned int& h) const;
+        size_t TileOffset(unsigned int tx, unsigned int ty) const;
+        float Sample(unsigned int ix, unsigned int iy) const;
+        void MarkTiles(btDynamicsWorld* world, Scalar distance, bool load);
+        void LoadTile(btDynamicsWorld* world, unsigned int id);
+        void EvictTile(btDynamicsWorld* world, unsigned int id);
+        
+        void* map;
+        size_t mapSize;
+        size_t pageSize;
+        const float* data;
+        unsigned int nx, ny;
+        unsigned int tileSize;
+        unsigned int ntx, nty;
+        Scalar dx, dy;
+        Scalar loadDist;
+        Scalar evictDist;
+        Transform origin;
+        std::vector<Tile> tiles;
+        std::vector<unsigned int> loaded;
+        uint64_t updateId;
+    };
+}
+
+#endif
@@ -32,6 +32,9 @@
 #include "graphics/OpenGLPointLight.h"
 #include "graphics/OpenGLSpotLight.h"
 #include <map>
+#include <atomic>
+#include <mutex>
+#include <memory>
 
 namespace sf
 {
@@ -246,7 +249,7 @@ namespace sf
          \param mesh a pointer to the mesh structure
          \return an id of the built object
          */
-        unsigned int BuildObject(Mesh* mesh);
+        unsigned int BuildObject(const Mesh* mesh);
         
         //! A method to create a new simple look.
         /*!
@@ -368,15 +371,28 @@ namespace sf
          \return a framebuffer object handle
          */
         static GLuint GenerateFramebuffer(const std::vector<FBOTexture>& textures);
+        
+        //! A static method to delete textures and remove them from the memory accounting.
+        /*!
+         \param n the number of textures
+         \param textures a pointer to the array of texture handles
+         */
+        static void DeleteTextures(GLsizei n, const GLuint* textures);
+        
+        //! A static method returning the estimated amount of memory used by the textures created with the content methods [B].
+        static size_t getTextureMemoryUsage();
+        
+        //! A method returning the amount of memory used by the vertex and index buffers of the graphical objects [B].
+        size_t getBufferMemoryUsage() const;
 
         //! A static method to load a mesh from a file.
         /*!
          \param filename a path to the model file
          \param scale the scale of the model
          \param smooth a flag to decide if model normals should be smoothed after loading
-         \return a pointer to the allocated mesh structure
+         \return a shared pointer to the immutable mesh stored in the mesh cache
          */
-        static Mesh* LoadMesh(const std::string& filename, GLfloat scale, bool smooth);
+        static std::shared_ptr<const Mesh> LoadMesh(const std::string& filename, GLfloat scale, bool smooth);
         
         //! A static method to build a graphical plane object.
         /*!
@@ -546,8 +562,16 @@ namespace sf
         std::vector<MaterialShader> materialShaders;
         GLSLShader* lightSourceShader[2];
         
+        //Memory accounting
+        std::atomic<size_t> bufferMemory;
+        static std::mutex textureMutex;
+        static std::map<GLuint, size_t> textureMemory; //Estimated size of each tracked texture
+        static size_t textureMemoryTotal;
+        
         //Methods
         void UseStandardLook(const glm::mat4& M);
+        static void RegisterTexture(GLuint texture, size_t bytes);
+        static size_t getTexelSize(GLenum internalFormat);
     };
 }
 
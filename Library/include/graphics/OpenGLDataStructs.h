@@ -178,6 +178,11 @@ namespace sf
             return (void*)&faces[0].vertexID[0];
         }
 
+        size_t getMemoryUsage() const
+        {
+            return faces.capacity() * sizeof(Face) + getNumOfVertices() * getVertexSize();
+        }
+
         virtual ~Mesh() {}    
         virtual bool isTexturable() const = 0;
         virtual size_t getNumOfVertices() const = 0;
@@ -29,6 +29,8 @@
 #include <deque>
 #include "StonefishCommon.h"
 
+#define DEFAULT_CONTACT_HISTORY 1000
+
 namespace sf
 {
     //! An enum specifying the style of contact rendering.
@@ -55,6 +57,18 @@ namespace sf
         Vector3 slippingVelocityA;
         Vector3 normalForceA;
     };
+    
+    //! A structure containing the contact data aggregated over all contact points of a simulation step.
+    struct ContactStepData
+    {
+        Scalar timeStamp;
+        unsigned int numOfPoints;
+        Vector3 centroidA; //Contact points on body A weighted by the normal force
+        Vector3 centroidB; //Contact points on body B weighted by the normal force
+        Vector3 netForceA; //Sum of the normal forces acting on body A
+        Vector3 slippingVelocityA; //Mean slipping velocity of body A
+        Scalar maxPenetration;
+    };
 
     //! A structure containing the internal data attached to a contact point.
     struct ContactInfo
@@ -67,6 +81,10 @@ namespace sf
     class Entity;
     
     //! A class implementing a sensor measuring the contact between two entities.
+    /*!
+     The contact data is aggregated per simulation step and stored in a ring buffer of fixed length.
+     Recording of the individual contact points is optional.
+     */
     class Contact
     {
     public:
@@ -75,14 +93,15 @@ namespace sf
          \param uniqueName a name for the contact
          \param entityA a pointer to the first entity
          \param entityB a pointer to the second entity
-         \param historyLength defines: 0 -> unlimited history, >0 -> history with a specified length
+         \param historyLength defines: 0 -> unlimited history, >0 -> history with a specified length (contact points)
+         \param stepHistoryLength the number of simulation steps stored in the aggregated history (0 -> default length)
          */
-        Contact(std::string uniqueName, Entity* entityA, Entity* entityB, unsigned int historyLength = 1);
+        Contact(std::string uniqueName, Entity* entityA, Entity* entityB, unsigned int historyLength = 1, unsigned int stepHistoryLength = DEFAULT_CONTACT_HISTORY);
         
         //! A destructor.
         ~Contact();
 
-        //! A method to add a contact point to the history.
+        //! A method to add the contact points of a manifold to the data of the current simulation step.
         /*!
          \param manifold a pointer to the contact manifold
          \param swapped a flag indicating if the contact bodies are swapped
@@ -90,12 +109,28 @@ namespace sf
          */
         void AddContactPoint(const btPersistentManifold* manifold, bool swapped, Scalar dt);
         
-        //! A method to add a contact point to the history.
+        //! A method to add a contact point to the point history (ignored when point recording is disabled).
         /*!
          \param p a structure containing contact info
          */
         void AddContactPoint(ContactPoint p);
         
+        //! A method closing the aggregation of the contact data for the current simulation step.
+        /*!
+         \param time the simulation time of the step [s]
+         */
+        void StepCompleted(Scalar time);
+        
+        //! A method to enable the recording of individual contact points.
+        /*!
+         \param enabled a flag specifying if the contact points should be recorded
+         \param historyLength the maximum number of recorded points (0 -> unlimited)
+         */
+        void setPointRecording(bool enabled, unsigned int historyLength = 0);
+        
+        //! A method informing if the individual contact points are recorded.
+        bool isRecordingPoints() const;
+        
         //! A method clearing the contact history.
         void ClearHistory();
         
@@ -105,7 +140,7 @@ namespace sf
         //! A method to check if new data is available.
         bool isNewDataAvailable() const;
         
-        //! A method that saves contact data to an Octave file.
+        //! A method that saves contact data to an Octave file (contact points if recorded, otherwise step data).
         /*!
          \param path a path to the output file
          \param includeTime a flag to specify if time should be written
@@ -130,16 +165,53 @@ namespace sf
         //! A method returning a pointer to the second entity.
         const Entity* getEntityB();
         
-        //! A method returning the history of the contact.
+        //! A method returning the number of simulation steps stored in the history.
+        size_t getNumOfSteps() const;
+        
+        //! A method returning the contact data of a simulation step.
+        /*!
+         \param index the index of the step in the history (0 -> oldest)
+         \return a reference to the step data
+         */
+        const ContactStepData& getStep(size_t index) const;
+        
+        //! A method returning the contact data of the last simulation step with contact.
+        ContactStepData getLastStep() const;
+        
+        //! A method returning a copy of the step history (oldest first).
+        std::vector<ContactStepData> getStepHistory() const;
+        
+        //! A method returning the history of the recorded contact points.
         const std::deque<ContactPoint>& getHistory();
         
+        //! A method returning the amount of memory used by the history of the contact [B].
+        size_t getHistoryMemoryUsage() const;
+        
     private:
+        void RecordPoint(const ContactPoint& p);
+        void ResetStep();
+        
         std::string name;
         Entity* A;
         Entity* B;
+        
+        //Step history (ring buffer)
+        std::vector<ContactStepData> steps;
+        uint64_t stepCount;
+        
+        //Aggregation of the current step
+        ContactStepData current;
+        Vector3 sumLocationA;
+        Vector3 sumLocationB;
+        Scalar sumWeight;
+        size_t currentPoints;
+        
+        //Point history (optional)
         std::deque<ContactPoint> points;
-        std::deque<ContactPoint>::iterator pointsLastBeg;
-        unsigned int historyLen;
+        size_t lastPoints;
+        bool recordPoints;
+        unsigned int pointsLen;
+        
         int16_t displayMask;
         bool newDataAvailable;
     };
@@ -138,6 +138,9 @@ namespace sf
         //! A method returing a pointer to a copy of the history of sensor measurements.
         const std::vector<Sample>* getHistory();
         
+        //! A method returning the amount of memory used by the history of measurements [B].
+        size_t getHistoryMemoryUsage();
+        
         //! A method returning the value of the measurement.
         /*!
          \param index the index of the history
@@ -54,6 +54,9 @@ namespace sf
         //! A method that resets the sensor.
         virtual void Reset();
         
+        //! A method called when the scenario is finalised, used to resolve references to other objects.
+        virtual void ResolveDependencies();
+        
         //! A method implementing the rendering of the sensor.
         virtual std::vector<Renderable> Render();
         
@@ -53,6 +53,9 @@ namespace sf
 
         //! A method that resets the sensor.
         void Reset();
+        
+        //! A method that finds the external sensors connected to the INS (sensors not found are looked up again at each update).
+        void ResolveDependencies();
 
         //! A method used to connect a GPS to the INS.
         /*!
@@ -106,6 +109,9 @@ namespace sf
             std::string gpsName;
             std::string dvlName;
             std::string pressName;
+            GPS* gps;
+            DVL* dvl;
+            Pressure* press;
             std::normal_distribution<Scalar> accNoiseX;
             std::normal_distribution<Scalar> accNoiseY;
             std::normal_distribution<Scalar> accNoiseZ;
@@ -29,6 +29,9 @@
 #include "StonefishCommon.h"
 #include "graphics/OpenGLDataStructs.h"
 
+#define DEFAULT_HULL_VERTICES 64
+#define DEFAULT_DECOMPOSITION_RESOLUTION 64
+
 namespace sf
 {
     struct MeshProperties
@@ -49,13 +52,15 @@ namespace sf
      */
     Mesh* LoadGeometryFromFile(const std::string& path, GLfloat scale);
     
-    //! A function to load geometry from a STL file.
+    //! A function to load geometry from a STL file (binary or ASCII).
     /*!
+     Vertices closer than the tolerance are welded and shared between facets, unless the facets meet at a sharp edge.
      \param path a path to the file
      \param scale a scale to apply to the data
+     \param weldTolerance the maximum distance between vertices that are welded [m]
      \return a pointer to an allocated mesh structure
      */
-    Mesh* LoadSTL(const std::string& path, GLfloat scale);
+    Mesh* LoadSTL(const std::string& path, GLfloat scale, GLfloat weldTolerance = 1e-5f);
     
     //! A function to load geometry from an OBJ file.
     /*!
@@ -88,6 +93,33 @@ namespace sf
      */
     MeshProperties ComputePhysicalProperties(const Mesh* mesh, Scalar thickness, Scalar density);
     
+    //! A function to compute the convex hull of a set of points.
+    /*!
+     The exact hull is computed first. If it has more vertices than allowed, it is reduced greedily,
+     starting from a tetrahedron and adding the vertex lying farthest outside of the current hull,
+     until the vertex budget is reached. The result is an inner approximation of the exact hull.
+     \param points a list of points
+     \param maxVertices the maximum number of vertices of the hull (0 to use the exact hull)
+     \return a list of the hull vertices
+     */
+    std::vector<Vector3> ComputeConvexHull(const std::vector<Vector3>& points, unsigned int maxVertices = 0);
+    
+    //! A function to compute an approximate convex decomposition of a mesh.
+    /*!
+     The mesh is voxelized and the voxels are split recursively with axis-aligned planes,
+     always splitting the part with the highest concavity (the difference between the volume of its convex hull
+     and its volume), at the plane minimising the concavity of the resulting parts. The splitting stops when
+     the budget of parts is reached or the parts are convex. The hulls of the parts are computed from the mesh
+     clipped to the cells of the parts.
+     \param mesh a pointer to the mesh structure
+     \param maxParts the maximum number of convex parts
+     \param maxHullVertices the maximum number of vertices of the hull of each part
+     \param resolution the number of voxels along the longest dimension of the mesh
+     \return a list of hulls of the parts
+     */
+    std::vector<std::vector<Vector3>> ComputeConvexDecomposition(const Mesh* mesh, unsigned int maxParts, unsigned int maxHullVertices = DEFAULT_HULL_VERTICES/2,
+                                                                 unsigned int resolution = DEFAULT_DECOMPOSITION_RESOLUTION);
+    
     //! A function to compute inertial axis for a given moment of inertia.
     /*!
      \param I the inertia tensor
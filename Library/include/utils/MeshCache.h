@@ -0,0 +1,234 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MeshCache.h
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish_MeshCache__
+#define __Stonefish_MeshCache__
+
+#include <memory>
+#include <mutex>
+#include <map>
+#include "graphics/OpenGLDataStructs.h"
+#include "utils/GeometryFileUtil.h"
+
+#define DEFAULT_DISK_CACHE_SIZE_LIMIT (size_t(1) << 30)
+
+namespace sf
+{
+    //! A static class implementing a process-wide cache of meshes loaded from files.
+    /*!
+     Meshes are keyed by the file path, scale and smoothing flag and shared as immutable, reference counted data.
+     Products derived from the cached meshes (refined meshes, physical properties, convex hulls, convex decompositions
+     and ellipsoidal approximations)
+     are cached together with the mesh they were computed from, so that loading many instances of the same asset
+     costs the same as loading one. All methods are thread-safe.
+     
+     The processed meshes and their derived products are also stored on disk, in a versioned binary format keyed
+     by the hash of the source file and the processing parameters, so that the following runs only need to map them.
+     The disk cache directory defaults to $STONEFISH_CACHE_DIR, $XDG_CACHE_HOME/stonefish or ~/.cache/stonefish.
+     The size of the disk cache is limited (1 GiB by default) and the least recently used entries are removed
+     when new entries are written.
+     */
+    class MeshCache
+    {
+    public:
+        //! A static method returning a mesh loaded from a file.
+        /*!
+         \param filename a path to the model file
+         \param scale the scale of the model
+         \param smooth a flag to decide if model normals should be smoothed after loading
+         \return a shared pointer to the immutable mesh
+         */
+        static std::shared_ptr<const Mesh> GetMesh(const std::string& filename, GLfloat scale, bool smooth);
+
+        //! A static method returning a refined version of a mesh loaded from a file.
+        /*!
+         \param filename a path to the model file
+         \param scale the scale of the model
+         \param smooth a flag to decide if model normals should be smoothed after loading
+         \param sizeThreshold the maximum size of a face, relative to the average face size
+         \return a shared pointer to the immutable refined mesh
+         */
+        static std::shared_ptr<const Mesh> GetRefinedMesh(const std::string& filename, GLfloat scale, bool smooth, GLfloat sizeThreshold);
+
+        //! A static method returning the physical properties of a mesh.
+        /*!
+         The result is cached only for meshes owned by the cache.
+         \param mesh a pointer to the mesh
+         \param thickness the thickness of the walls (0 for solid bodies) [m]
+         \param density the density of the material [kg*m^-3]
+         \return a structure containing properties of the mesh
+         */
+        static MeshProperties GetPhysicalProperties(const Mesh* mesh, Scalar thickness, Scalar density);
+
+        //! A static method returning the convex hull of a mesh.
+        /*!
+         The result is cached only for meshes owned by the cache.
+         \param mesh a pointer to the mesh
+         \param maxVertices the maximum number of vertices of the hull (0 to use the exact hull)
+         \return a shared pointer to the list of hull vertices
+         */
+        static std::shared_ptr<const std::vector<Vector3>> GetConvexHull(const Mesh* mesh, unsigned int maxVertices = 0);
+        
+        //! A static method returning the approximate convex decomposition of a mesh.
+        /*!
+         The result is cached only for meshes owned by the cache.
+         \param mesh a pointer to the mesh
+         \param maxParts the maximum number of convex parts
+         \param maxHullVertices the maximum number of vertices of the hull of each part
+         \return a shared pointer to the list of hulls of the parts
+         */
+        static std::shared_ptr<const std::vector<std::vector<Vector3>>> GetConvexDecomposition(const Mesh* mesh, unsigned int maxParts, 
+                                                                                              unsigned int maxHullVertices = DEFAULT_HULL_VERTICES);
+        
+        //! A static method returning a static collision shape built from the triangles of a mesh.
+        /*!
+         The shape, including its bounding volume hierarchy, is shared between all users of the mesh. It is released by
+         the cache when it is purged and the shape is not used anymore.
+         The hierarchy of meshes owned by the cache is stored on disk and memory-mapped when loaded.
+         \param mesh a shared pointer to the mesh
+         \return a shared pointer to the collision shape
+         */
+        static std::shared_ptr<btBvhTriangleMeshShape> GetTriangleMeshShape(const std::shared_ptr<const Mesh>& mesh);
+        
+        //! A static method to find a cached ellipsoidal approximation of a mesh.
+        /*!
+         \param mesh a pointer to the mesh
+         \param T the transformation applied to the mesh vertices before fitting
+         \param offset the offset subtracted from the transformed vertices before fitting
+         \param axes a reference to a variable that will store the semi-axes of the ellipsoid [m]
+         \return was the approximation found in the cache?
+         */
+        static bool FindEllipsoid(const Mesh* mesh, const Transform& T, const Vector3& offset, Vector3& axes);
+
+        //! A static method to store the ellipsoidal approximation of a mesh (ignored for meshes not owned by the cache).
+        /*!
+         \param mesh a pointer to the mesh
+         \param T the transformation applied to the mesh vertices before fitting
+         \param offset the offset subtracted from the transformed vertices before fitting
+         \param axes the semi-axes of the ellipsoid [m]
+         */
+        static void StoreEllipsoid(const Mesh* mesh, const Transform& T, const Vector3& offset, const Vector3& axes);
+
+        //! A static method to create a deep copy of a mesh.
+        /*!
+         \param mesh a pointer to the mesh
+         \return a pointer to the allocated copy
+         */
+        static Mesh* CopyMesh(const Mesh* mesh);
+
+        //! A static method removing the meshes that are not used anymore (called when a scenario is destroyed).
+        static void Purge();
+        
+        //! A static method deciding if the meshes that are not used anymore are kept when a scenario is destroyed.
+        /*!
+         \param retain a flag to keep the unused meshes in memory (faster reloading of the same scenario)
+         */
+        static void setRetainUnused(bool retain);
+        
+        //! A static method informing if the meshes that are not used anymore are kept when a scenario is destroyed.
+        static bool isRetainingUnused();
+        
+        //! A static method setting the directory used to store the disk cache.
+        /*!
+         \param path a path to the directory (empty string disables the disk cache)
+         */
+        static void setDiskCacheDirectory(const std::string& path);
+        
+        //! A static method returning the directory used to store the disk cache.
+        static std::string getDiskCacheDirectory();
+        
+        //! A static method setting the maximum size of the disk cache.
+        /*!
+         \param bytes the maximum size of the disk cache in bytes (0 -> unlimited)
+         */
+        static void setDiskCacheSizeLimit(size_t bytes);
+        
+        //! A static method returning the maximum size of the disk cache in bytes.
+        static size_t getDiskCacheSizeLimit();
+
+        //! A static method returning the number of cached meshes.
+        static size_t getNumOfMeshes();
+
+    private:
+        struct EllipsoidEntry
+        {
+            Transform T;
+            Vector3 offset;
+            Vector3 axes;
+        };
+
+        struct DerivedData
+        {
+            std::map<std::pair<Scalar, Scalar>, MeshProperties> properties; //Keyed by thickness and density
+            std::vector<EllipsoidEntry> ellipsoids;
+            std::map<unsigned int, std::shared_ptr<const std::vector<Vector3>>> hulls; //Keyed by maximum number of vertices
+            std::map<std::pair<unsigned int, unsigned int>, std::shared_ptr<const std::vector<std::vector<Vector3>>>> decompositions; //Keyed by maximum number of parts and hull vertices
+            uint64_t diskKey; //Key of the disk cache entry (0 if not stored on disk)
+            
+            DerivedData() : diskKey(0) {}
+        };
+        
+        struct TriangleMeshData
+        {
+            std::shared_ptr<const Mesh> mesh; //Keeps vertex and index data referenced by the shape alive
+            btTriangleIndexVertexArray* array;
+            std::shared_ptr<btBvhTriangleMeshShape> shape;
+            void* map; //Memory-mapped hierarchy (nullptr if built in memory)
+            size_t mapSize;
+        };
+        
+        enum class DerivedRecordType : uint32_t {PROPERTIES = 1, ELLIPSOID = 2, HULL = 3, DECOMPOSITION = 4};
+
+        MeshCache() {}
+        static std::string MakeKey(const std::string& filename, GLfloat scale, bool smooth, GLfloat sizeThreshold);
+        static Mesh* LoadMesh(const std::string& filename, GLfloat scale, bool smooth);
+        static std::shared_ptr<const Mesh> Insert(const std::string& key, Mesh* mesh, const DerivedData& data);
+        static void DestroyTriangleMesh(TriangleMeshData& data);
+        
+        //Disk cache
+        static uint64_t MakeDiskKey(const std::string& filename, GLfloat scale, bool smooth, GLfloat sizeThreshold);
+        static std::string DiskPath(uint64_t key, const char* extension);
+        static Mesh* ReadMeshBlob(uint64_t key);
+        static void WriteMeshBlob(uint64_t key, const Mesh* mesh);
+        static void ReadDerivedRecords(uint64_t key, DerivedData& data);
+        static void AppendDerivedRecord(uint64_t key, DerivedRecordType type, const std::vector<double>& payload);
+        static btOptimizedBvh* ReadBvh(uint64_t key, const Mesh* mesh, void*& map, size_t& mapSize);
+        static void WriteBvh(uint64_t key, const Mesh* mesh, const btOptimizedBvh* bvh);
+        static void PruneDiskCache();
+
+        static std::mutex mutex;
+        static std::mutex diskMutex; //Serialises access to the derived records files
+        static std::map<std::string, std::shared_ptr<const Mesh>> meshes;
+        static std::map<const Mesh*, DerivedData> derived;
+        static std::map<const Mesh*, TriangleMeshData> triangleMeshes;
+        static std::map<std::string, uint64_t> sourceHashes;
+        static std::string diskCacheDir;
+        static bool diskCacheDirSet;
+        static size_t diskCacheLimit;
+        static bool retainUnused;
+    };
+}
+
+#endif
@@ -27,16 +27,56 @@
 #define __Stonefish_PerformanceMonitor__
 
 #include <SDL2/SDL_mutex.h>
+#include <atomic>
 #include <chrono>
-#include <deque>
 #include <vector>
+#include <deque>
+#include <map>
+#include <string>
 
 namespace sf
 {
+    struct HydrodynamicsStats
+    {
+        unsigned long long evaluations; // Number of hydrodynamics updates concerning the body
+        unsigned long long recomputations; // Number of updates in which the forces were recomputed
+    };
+
+    // Counters of the adaptive hydrodynamics of a single body (updated lock-free by the thread computing the forces of the body).
+    struct HydrodynamicsCounters
+    {
+        std::string name;
+        std::atomic<unsigned long long> evaluations;
+        std::atomic<unsigned long long> recomputations;
+        
+        HydrodynamicsCounters(const std::string& bodyName) : name(bodyName), evaluations(0), recomputations(0) {}
+        void Count(bool recomputed);
+    };
+
+    // Phases of the simulation step measured by the monitor.
+    // PHYSICS covers the whole world step, the others are measured once per internal step.
+    enum class PerformancePhase {PHYSICS, ACTUATORS, JOINT_DAMPING, GRAVITY, TRIGGERS, TERRAIN, AERODYNAMICS, HYDRODYNAMICS, 
+                                 BROADPHASE, NARROWPHASE, SOLVER, SENSORS, COMMS, CONTACTS, COUNT};
+
+    // Statistics of a phase over the measurement window (in microseconds).
+    struct PerformanceStats
+    {
+        double last;
+        double min;
+        double mean;
+        double p95;
+        double p99;
+        size_t samples;
+    };
+
+    // Subsystems whose memory usage is accounted by the monitor.
+    enum class MemoryCategory {GRAPHICS_MESHES, PHYSICS_MESHES, SENSOR_HISTORY, CONTACT_HISTORY, BULLET, GL_BUFFERS, GL_TEXTURES, COMMS, COUNT};
+
     class PerformanceMonitor
     {
     public:
-        PerformanceMonitor(size_t averageMaxCount);
+        PerformanceMonitor(size_t windowSize);
+        PerformanceMonitor(const PerformanceMonitor&) = delete;
         ~PerformanceMonitor();
         
         void SimulationStarted();
@@ -46,44 +86,71 @@ namespace sf
         void HydrodynamicsStarted();
         void HydrodynamicsFinished();
 
+        // Lock-free phase measurement (to be called from the simulation thread).
+        void PhaseStarted(PerformancePhase phase);
+        void PhaseFinished(PerformancePhase phase);
+
         // In seconds.
         double getSimulationTime();
         
         // In microseconds.
         double getPhysicsTime();
         double getPhysicsTimeAverage();
-        template<typename T> std::vector<T> getPhysicsTimeHistory(size_t len) { return getHistory<T>(phyTime, len); };
+        template<typename T> std::vector<T> getPhysicsTimeHistory(size_t len) { return getPhaseTimeHistory<T>(PerformancePhase::PHYSICS, len); };
 
         double getHydrodynamicsTime();
         double getHydrodynamicsTimeAverage();
-        template<typename T> std::vector<T> getHydrodynamicsTimeHistory(size_t len) { return getHistory<T>(hydroTime, len); };
+        template<typename T> std::vector<T> getHydrodynamicsTimeHistory(size_t len) { return getPhaseTimeHistory<T>(PerformancePhase::HYDRODYNAMICS, len); };
+
+        // Phase statistics (safe to call from any thread, percentiles computed on request).
+        PerformanceStats getPhaseStats(PerformancePhase phase);
+        template<typename T> std::vector<T> getPhaseTimeHistory(PerformancePhase phase, size_t len)
+        {
+            std::vector<double> data = getPhaseSamples(phase, len);
+            return std::vector<T>(data.begin(), data.end());
+        };
+        static const char* getPhaseName(PerformancePhase phase);
+
+        // Adaptive hydrodynamics (bodies are registered when the simulation starts, counters are updated without locking).
+        HydrodynamicsCounters* AddHydrodynamicsBody(const std::string& bodyName);
+        void ClearHydrodynamicsBodies();
+        std::map<std::string, HydrodynamicsStats> getHydrodynamicsStats();
+        double getHydrodynamicsRecomputeRatio();
+
+        // Memory accounting (in bytes, updated by the simulation manager on request).
+        void setMemoryUsage(MemoryCategory category, size_t bytes);
+        size_t getMemoryUsage(MemoryCategory category);
+        size_t getTotalMemoryUsage();
+        static const char* getMemoryCategoryName(MemoryCategory category);
+
+        // Counting allocator for Bullet (installed once per process at start, blocks are measured with the allocator).
+        static void InstallBulletAllocator();
+        static size_t getBulletMemoryUsage();
 
     private:
-        void Update(const std::chrono::high_resolution_clock::time_point& start, std::deque<double>& times, double& average);
-        template<typename T> std::vector<T> getHistory(std::deque<double>& data, size_t len)
-        { 
-            std::vector<T> dataOut; 
-            dataOut.resize(data.size() < len ? data.size() : len);
-            SDL_LockMutex(updateMtx);
-            size_t offset = data.size() - dataOut.size();
-            for(size_t i=data.size()-dataOut.size(); i<data.size(); ++i) 
-                dataOut[i-offset] = (T)(data[i]);
-            SDL_UnlockMutex(updateMtx);   
-            return dataOut;
+        // Single-producer ring buffer of phase durations.
+        struct PhaseBuffer
+        {
+            std::chrono::steady_clock::time_point start;
+            std::vector<std::atomic<double>> samples;
+            std::atomic<double> sum;
+            std::atomic<unsigned long long> count;
         };
 
-        size_t maxCount;
+        std::vector<double> getPhaseSamples(PerformancePhase phase, size_t len);
+        static void* BulletAlloc(size_t size);
+        static void BulletFree(void* ptr);
+
+        size_t window;
         std::chrono::high_resolution_clock::time_point simStart;
-        std::chrono::high_resolution_clock::time_point phyStart;
-        std::chrono::high_resolution_clock::time_point hydroStart;
         double simTime;
         bool simFinished;
-        std::deque<double> phyTime;
-        std::deque<double> hydroTime;
-        double phyTimeAvg;
-        double hydroTimeAvg;
+        PhaseBuffer* phases;
+        std::deque<HydrodynamicsCounters> hydroCounters; //Deque keeps the addresses of the counters stable
+        std::atomic<size_t> memory[(size_t)MemoryCategory::COUNT];
         SDL_mutex* updateMtx;
+        static std::atomic<int64_t> bulletMemory;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
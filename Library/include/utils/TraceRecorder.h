@@ -0,0 +1,149 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  TraceRecorder.h
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef __Stonefish_TraceRecorder__
+#define __Stonefish_TraceRecorder__
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace sf
+{
+    //! A static class implementing a recorder of timeline events of the simulation.
+    /*!
+     Events are recorded into per-thread ring buffers, which are written without locking by the owning thread,
+     so that the simulation thread, the rendering thread and the OpenMP workers can be traced at the same time.
+     When a buffer is full the oldest events are overwritten. The recorded timeline can be saved at any moment
+     in the Chrome trace format (JSON), readable by chrome://tracing and Perfetto.
+     */
+    class TraceRecorder
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+        
+        //! A static method starting the recording.
+        /*!
+         \param eventsPerThread the capacity of the buffer of each thread
+         */
+        static void Start(size_t eventsPerThread = DEFAULT_TRACE_EVENTS);
+        
+        //! A static method stopping the recording (recorded events are kept until the next start).
+        static void Stop();
+        
+        //! A static method to name the calling thread in the trace.
+        /*!
+         \param name the name of the thread
+         */
+        static void SetThreadName(const std::string& name);
+        
+        //! A static method recording a complete event on the calling thread.
+        /*!
+         \param name a pointer to a string literal with the name of the event
+         \param category a pointer to a string literal with the category of the event
+         \param start the time when the event started
+         \param end the time when the event finished
+         */
+        static void Record(const char* name, const char* category, Clock::time_point start, Clock::time_point end);
+        
+        //! A static method saving the recorded events in the Chrome trace format.
+        /*!
+         \param filename a path to the output file
+         \return was the file saved successfully?
+         */
+        static bool Dump(const std::string& filename);
+        
+        //! A static method informing if the recording is enabled.
+        static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+        
+        static constexpr size_t DEFAULT_TRACE_EVENTS = 65536;
+        
+    private:
+        struct Event
+        {
+            std::atomic<const char*> name;
+            std::atomic<const char*> category;
+            std::atomic<int64_t> start; //[ns]
+            std::atomic<int64_t> duration; //[ns]
+        };
+        
+        // Single-producer ring buffer owned by one thread.
+        struct ThreadBuffer
+        {
+            unsigned int tid;
+            std::string name;
+            std::vector<Event> events;
+            std::atomic<unsigned long long> count;
+            std::atomic<unsigned long long> generation;
+        };
+        
+        TraceRecorder() {}
+        static ThreadBuffer* getThreadBuffer();
+        static std::string EscapeJson(const std::string& str);
+        
+        static std::atomic<bool> enabled;
+        static std::atomic<unsigned long long> generation;
+        static std::atomic<size_t> capacity;
+        static std::mutex mutex;
+        static std::vector<ThreadBuffer*> buffers;
+        static std::atomic<int64_t> origin; //Start of the recording [ns since clock epoch]
+    };
+    
+    //! A class recording a trace event spanning its lifetime.
+    class TraceScope
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param name a pointer to a string literal with the name of the event
+         \param category a pointer to a string literal with the category of the event
+         */
+        TraceScope(const char* name, const char* category = "sim") : name(name), category(category), active(TraceRecorder::isEnabled())
+        {
+            if(active) start = TraceRecorder::Clock::now();
+        }
+        
+        //! A destructor.
+        ~TraceScope()
+        {
+            if(active) TraceRecorder::Record(name, category, start, TraceRecorder::Clock::now());
+        }
+        
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+        
+    private:
+        const char* name;
+        const char* category;
+        bool active;
+        TraceRecorder::Clock::time_point start;
+    };
+}
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
+#include "utils/MeshCache.h"
 #include <algorithm>
 
 namespace sf 
@@ -45,11 +46,8 @@ VariableBuoyancy::VariableBuoyancy(std::string uniqueName, const std::vector<std
     
     for(size_t i=0; i<volumeMeshPaths.size(); ++i)
     {
-        Mesh* mesh = LoadGeometryFromFile(volumeMeshPaths[i], 1.f);
-        if(mesh == NULL)
-            abort();
-        Vprops.push_back(ComputePhysicalProperties(mesh, Scalar(0), density));
-        delete mesh;
+        std::shared_ptr<const Mesh> mesh = MeshCache::GetMesh(volumeMeshPaths[i], 1.f, false);
+        Vprops.push_back(MeshCache::GetPhysicalProperties(mesh.get(), Scalar(0), density));
     }
     auto volumeCompare = [](MeshProperties& mp1, MeshProperties& mp2) { return mp1.volume < mp2.volume; };
     std::sort(Vprops.begin(), Vprops.end(), volumeCompare);
@@ -226,6 +226,14 @@ void AcousticModem::ProcessMessages()
     }
 }
 
+size_t AcousticModem::getInternalMemoryUsage()
+{
+    size_t bytes = 0;
+    for(auto mIt = propagating.begin(); mIt != propagating.end(); ++mIt)
+        bytes += getFrameMemoryUsage(mIt->first) + sizeof(AcousticDataFrame) - sizeof(CommDataFrame) + sizeof(Vector3);
+    return bytes;
+}
+
 void AcousticModem::InternalUpdate(Scalar dt)
 {
     //Propagate messages already sent
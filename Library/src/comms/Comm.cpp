@@ -71,6 +71,28 @@ std::string Comm::getName()
     return name;
 }
 
+size_t Comm::getBufferMemoryUsage()
+{
+    SDL_LockMutex(updateMutex);
+    size_t bytes = getInternalMemoryUsage();
+    for(size_t i=0; i<txBuffer.size(); ++i)
+        bytes += getFrameMemoryUsage(txBuffer[i]);
+    for(size_t i=0; i<rxBuffer.size(); ++i)
+        bytes += getFrameMemoryUsage(rxBuffer[i]);
+    SDL_UnlockMutex(updateMutex);
+    return bytes;
+}
+
+size_t Comm::getInternalMemoryUsage()
+{
+    return 0;
+}
+
+size_t Comm::getFrameMemoryUsage(const CommDataFrame* frame)
+{
+    return sizeof(CommDataFrame*) + sizeof(CommDataFrame) + frame->data.capacity();
+}
+
 uint64_t Comm::getDeviceId()
 {
     return id;
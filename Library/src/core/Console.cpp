@@ -26,20 +26,50 @@
 #include "core/Console.h"
 #include <iostream>
 #include <fstream>
+#include "utils/SystemUtil.hpp"
 
 namespace sf
 {
     
-Console::Console(bool useStdout)
+Console::Console(bool useStdout, size_t capacity) : capacity(capacity > 0 ? capacity : 1)
 {
     stdoutEnabled = useStdout;
     lines = std::vector<ConsoleMessage>(0);
+    echo = std::vector<char>(0);
     linesMutex = SDL_CreateMutex();
+    total = 0;
+    first = 0;
+    written = 0;
+    echoTotal = 0;
+    echoHandled = 0;
+    lastType = MessageType::INFO;
+    lastText = "";
+    repeats = 0;
+    rate = DEFAULT_CONSOLE_RATE;
+    tokens = rate;
+    lastRefill = GetTimeInMicroseconds();
+    suppressed = 0;
+    quit = false;
+    pending = SDL_CreateCond();
+    flushed = SDL_CreateCond();
+    writer = stdoutEnabled ? SDL_CreateThread(Console::WriteOutput, "consoleThread", this) : nullptr;
 }
 
 Console::~Console()
 {
+    if(writer != nullptr)
+    {
+        SDL_LockMutex(linesMutex);
+        FlushRepeats();
+        quit = true;
+        SDL_CondSignal(pending);
+        SDL_UnlockMutex(linesMutex);
+        SDL_WaitThread(writer, nullptr);
+    }
+    
     lines.clear();
+    SDL_DestroyCond(pending);
+    SDL_DestroyCond(flushed);
     SDL_DestroyMutex(linesMutex);
 }
     
@@ -48,9 +78,39 @@ SDL_mutex* Console::getLinesMutex()
     return linesMutex;
 }
 
+size_t Console::getNumOfLines() const
+{
+    return (size_t)(total - first);
+}
+
+const ConsoleMessage& Console::getLine(size_t index) const
+{
+    return lines[(first + index) % capacity];
+}
+
 std::vector<ConsoleMessage> Console::getLines()
 {
-    return lines;
+    std::vector<ConsoleMessage> messages;
+    getLines(0, messages);
+    return messages;
+}
+
+uint64_t Console::getLines(uint64_t cursor, std::vector<ConsoleMessage>& messages)
+{
+    SDL_LockMutex(linesMutex);
+    for(uint64_t i = std::max(cursor, first); i < total; ++i)
+        messages.push_back(lines[i % capacity]);
+    cursor = total;
+    SDL_UnlockMutex(linesMutex);
+    return cursor;
+}
+
+void Console::setRateLimit(Scalar messagesPerSecond)
+{
+    SDL_LockMutex(linesMutex);
+    rate = btMax(messagesPerSecond, Scalar(0));
+    tokens = rate;
+    SDL_UnlockMutex(linesMutex);
 }
 
 void Console::Print(MessageType t, std::string format, ...)
@@ -61,70 +121,202 @@ void Console::Print(MessageType t, std::string format, ...)
     vsnprintf(buffer, sizeof(buffer), format.c_str(), args);
     va_end(args);
     
-    if(stdoutEnabled)
+    SDL_LockMutex(linesMutex);
+    
+    //Collapse repeated messages
+    if(t != MessageType::CRITICAL && t == lastType && lastText == buffer && total > first)
     {
-#ifdef COLOR_CONSOLE
-        switch(t)
-        {
-            default:
-            case MessageType::INFO:
-                printf("[INFO] %s\n", buffer);
-                break;
-                
-            case MessageType::WARNING:
-                printf("\033[33m[WARN] %s\033[0m\n", buffer);
-                break;
-                
-            case MessageType::ERROR:
-                printf("\033[31m[ERROR] %s\033[0m\n", buffer);
-                break;
-                
-            case MessageType::CRITICAL:
-                printf("\033[1;31m[CRITICAL] %s\033[0m\n", buffer);
-                break;
-        }
-#else
-        switch(t)
+        ++repeats;
+        SDL_UnlockMutex(linesMutex);
+        return;
+    }
+    FlushRepeats();
+    
+    //Limit the rate of less important messages printed on the standard output (all messages are stored)
+    bool print = stdoutEnabled;
+    if(print && rate > Scalar(0) && (t == MessageType::INFO || t == MessageType::WARNING))
+    {
+        int64_t now = GetTimeInMicroseconds();
+        tokens = btMin(rate, tokens + rate * Scalar(now - lastRefill)/Scalar(1000000));
+        lastRefill = now;
+        
+        if(tokens < Scalar(1))
         {
-            default:
-            case MessageType::INFO:
-                printf("[INFO] %s\n", buffer);
-                break;
-                
-            case MessageType::WARNING:
-                printf("[WARN] %s\n", buffer);
-                break;
-                
-            case MessageType::ERROR:
-                printf("[ERROR] %s\n", buffer);
-                break;
-                
-            case MessageType::CRITICAL:
-                printf("[CRITICAL] %s\n", buffer);
-                break;
+            ++suppressed;
+            print = false;
         }
-#endif
+        else
+            tokens -= Scalar(1);
     }
-
+    
+    if(print && suppressed > 0)
+    {
+        ConsoleMessage msg;
+        msg.type = MessageType::WARNING;
+        msg.text = std::to_string(suppressed) + " messages not printed (rate limit).";
+        Push(msg, true);
+        suppressed = 0;
+    }
+    
     ConsoleMessage msg;
     msg.type = t;
     msg.text = std::string(buffer);
-    SDL_LockMutex(linesMutex);
-    lines.push_back(msg);
+    Push(msg, print);
+    lastType = t;
+    lastText = msg.text;
     SDL_UnlockMutex(linesMutex);
+    
+    if(t == MessageType::CRITICAL) //Application will be terminated
+        Flush();
 }
 
 void Console::AppendMessage(const ConsoleMessage& msg)
 {
     SDL_LockMutex(linesMutex);
-    lines.push_back(msg);
+    Push(msg, false);
     SDL_UnlockMutex(linesMutex);
 }
+
+void Console::Push(const ConsoleMessage& msg, bool e)
+{
+    size_t id = total % capacity;
+    if(id >= lines.size())
+    {
+        lines.resize(id + 1);
+        echo.resize(id + 1);
+    }
+    lines[id] = msg;
+    echo[id] = e;
+    ++total;
+    if(e)
+        ++echoTotal;
+    if(total - first > capacity)
+        first = total - capacity;
+    
+    if(e)
+        SDL_CondSignal(pending);
+}
+
+void Console::FlushRepeats()
+{
+    if(repeats == 0)
+        return;
+    
+    ConsoleMessage msg;
+    msg.type = lastType;
+    msg.text = "Last message repeated " + std::to_string(repeats) + " times.";
+    Push(msg, stdoutEnabled);
+    repeats = 0;
+}
+
+void Console::Flush()
+{
+    if(writer == nullptr)
+        return;
+    
+    SDL_LockMutex(linesMutex);
+    FlushRepeats();
+    uint64_t target = total;
+    while(written < target)
+        SDL_CondWait(flushed, linesMutex);
+    SDL_UnlockMutex(linesMutex);
+}
+
+int Console::WriteOutput(void* data)
+{
+    Console* console = (Console*)data;
+    std::vector<ConsoleMessage> batch;
+    
+    SDL_LockMutex(console->linesMutex);
+    while(true)
+    {
+        while(!console->quit && console->written == console->total)
+            SDL_CondWait(console->pending, console->linesMutex);
+        
+        if(console->written == console->total) //Quit and nothing left
+            break;
+        
+        //Collect the messages to print (older ones were overwritten if the writer fell behind)
+        uint64_t end = console->total;
+        uint64_t start = end - console->written > console->capacity ? end - console->capacity : console->written;
+        for(uint64_t i = start; i < end; ++i)
+            if(console->echo[i % console->capacity])
+                batch.push_back(console->lines[i % console->capacity]);
+        uint64_t dropped = console->echoTotal - console->echoHandled - batch.size(); //Only messages meant to be printed
+        console->echoHandled = console->echoTotal;
+        if(dropped > 0)
+        {
+            ConsoleMessage msg;
+            msg.type = MessageType::WARNING;
+            msg.text = std::to_string(dropped) + " messages dropped from the output.";
+            batch.insert(batch.begin(), msg);
+        }
+        SDL_UnlockMutex(console->linesMutex);
+        
+        for(size_t i = 0; i < batch.size(); ++i)
+            Write(batch[i]);
+        fflush(stdout);
+        batch.clear();
+        
+        SDL_LockMutex(console->linesMutex);
+        console->written = end;
+        SDL_CondBroadcast(console->flushed);
+    }
+    SDL_UnlockMutex(console->linesMutex);
+    return 0;
+}
+
+void Console::Write(const ConsoleMessage& msg)
+{
+    const char* text = msg.text.c_str();
+#ifdef COLOR_CONSOLE
+    switch(msg.type)
+    {
+        default:
+        case MessageType::INFO:
+            printf("[INFO] %s\n", text);
+            break;
+            
+        case MessageType::WARNING:
+            printf("\033[33m[WARN] %s\033[0m\n", text);
+            break;
+            
+        case MessageType::ERROR:
+            printf("\033[31m[ERROR] %s\033[0m\n", text);
+            break;
+            
+        case MessageType::CRITICAL:
+            printf("\033[1;31m[CRITICAL] %s\033[0m\n", text);
+            break;
+    }
+#else
+    switch(msg.type)
+    {
+        default:
+        case MessageType::INFO:
+            printf("[INFO] %s\n", text);
+            break;
+            
+        case MessageType::WARNING:
+            printf("[WARN] %s\n", text);
+            break;
+            
+        case MessageType::ERROR:
+            printf("[ERROR] %s\n", text);
+            break;
+            
+        case MessageType::CRITICAL:
+            printf("[CRITICAL] %s\n", text);
+            break;
+    }
+#endif
+}
     
 void Console::Clear()
 {
     SDL_LockMutex(linesMutex);
-    lines.clear();
+    repeats = 0;
+    first = total;
     SDL_UnlockMutex(linesMutex);
 }
 
@@ -133,26 +325,25 @@ bool Console::SaveToFile(std::string filename)
     std::ofstream outFile(filename);
     if(outFile.is_open())
     {
-        SDL_LockMutex(linesMutex);
-        for(size_t i=0; i<lines.size(); ++i)
+        std::vector<ConsoleMessage> messages = getLines();
+        for(size_t i=0; i<messages.size(); ++i)
         {
-            switch(lines[i].type)
+            switch(messages[i].type)
             {
                 case MessageType::INFO:
-                    outFile << "[INFO] " << lines[i].text << std::endl;
+                    outFile << "[INFO] " << messages[i].text << std::endl;
                     break;
                 case MessageType::WARNING:
-                    outFile << "[WARN] " << lines[i].text << std::endl;
+                    outFile << "[WARN] " << messages[i].text << std::endl;
                     break;
                 case MessageType::ERROR:
-                    outFile << "[ERROR] " << lines[i].text << std::endl;
+                    outFile << "[ERROR] " << messages[i].text << std::endl;
                     break;
                 case MessageType::CRITICAL:
-                    outFile << "[CRITICAL] " << lines[i].text << std::endl;
+                    outFile << "[CRITICAL] " << messages[i].text << std::endl;
                     break;
             }
         }
-        SDL_UnlockMutex(linesMutex);
         outFile.close();
         return true;
     }
@@ -30,6 +30,7 @@
 #include <omp.h>
 #include "core/SimulationManager.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/TraceRecorder.h"
 
 namespace sf
 {
@@ -98,6 +99,7 @@ int ConsoleSimulationApp::RunSimulation(void* data)
 
     int maxThreads = std::max(omp_get_max_threads()/2, 1);
     omp_set_num_threads(maxThreads);
+    TraceRecorder::SetThreadName("Simulation");
     
     while(stdata->app->isRunning())
         sim->AdvanceSimulation();
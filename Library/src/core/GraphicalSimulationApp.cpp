@@ -37,6 +37,7 @@
 #include "graphics/IMGUI.h"
 #include "graphics/OpenGLTrackball.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/TraceRecorder.h"
 #include "entities/Entity.h"
 #include "entities/StaticEntity.h"
 #include "entities/SolidEntity.h"
@@ -284,6 +285,7 @@ void GraphicalSimulationApp::InitializeSDL()
 
     //Initialize OpenGL pipeline
     cInfo("Window created. OpenGL %d.%d contexts created.", vmajor, vminor);
+    TraceRecorder::SetThreadName("Rendering");
     OpenGLState::Init();
     GLSLShader::Init();
     
@@ -375,6 +377,23 @@ void GraphicalSimulationApp::KeyDown(SDL_Event *event)
             displayConsole = !displayConsole;
             ((OpenGLConsole*)console)->ResetScroll();
             break;
+
+        case SDLK_t: //Timeline trace
+            if(TraceRecorder::isEnabled())
+            {
+                TraceRecorder::Stop();
+                TraceRecorder::Dump("stonefish_trace.json");
+            }
+            else
+            {
+                TraceRecorder::Start();
+                cInfo("Trace recording started.");
+            }
+            break;
+            
+        case SDLK_m: //Memory usage
+            getSimulationManager()->ReportMemoryUsage();
+            break;
             
         case SDLK_w: //Forward
         {
@@ -628,22 +647,34 @@ void GraphicalSimulationApp::LoopInternal()
 
 void GraphicalSimulationApp::RenderLoop()
 {
+    TraceScope trace("Frame", "render");
+    
     //Do some updates
     if(!isRunning())
     {
+        TraceScope traceQueue("Drawing queue update", "render");
         getSimulationManager()->UpdateDrawingQueue();
     }
     
     //Rendering
     glBeginQuery(GL_TIME_ELAPSED, timeQuery[timeQueryPingpong]);
-    glPipeline->Render(getSimulationManager());
-    glPipeline->DrawDisplay();
+    {
+        TraceScope traceRender("Render", "render");
+        glPipeline->Render(getSimulationManager());
+    }
+    {
+        TraceScope traceDisplay("Display", "render");
+        glPipeline->DrawDisplay();
+    }
     
     //GUI & Console
+    TraceScope traceGUI("GUI", "render");
     if(displayConsole)
     {
         gui->GenerateBackground();
+        SDL_LockMutex(console->getLinesMutex());
         ((OpenGLConsole*)console)->Render(true);
+        SDL_UnlockMutex(console->getLinesMutex());
     }
     else
     {
@@ -683,6 +714,7 @@ void GraphicalSimulationApp::RenderLoop()
     }
 
     //glFinish(); //Ensure that the frame was fully rendered
+    TraceScope traceSwap("Swap", "render");
     SDL_GL_SwapWindow(window);
 }
 
@@ -971,11 +1003,13 @@ void GraphicalSimulationApp::DoHUD()
     //Keymap
     if(displayKeymap)
     {
-        offset = getWindowHeight()-246.f;
+        offset = getWindowHeight()-278.f;
         GLfloat left = getWindowWidth()-130.f; 
-        gui->DoPanel(left - 10.f, offset, 130.f, 206.f); offset += 10.f;
+        gui->DoPanel(left - 10.f, offset, 130.f, 238.f); offset += 10.f;
         gui->DoLabel(left, offset, "[H] show/hide GUI"); offset += 16.f;
         gui->DoLabel(left, offset, "[C] show/hide console"); offset += 16.f;
+        gui->DoLabel(left, offset, "[T] start/save trace"); offset += 16.f;
+        gui->DoLabel(left, offset, "[M] report memory usage"); offset += 16.f;
         gui->DoLabel(left, offset, "[W] move forward"); offset += 16.f;
         gui->DoLabel(left, offset, "[S] move backward"); offset += 16.f;
         gui->DoLabel(left, offset, "[A] move left"); offset += 16.f;
@@ -998,6 +1032,63 @@ void GraphicalSimulationApp::DoHUD()
         id.owner = 4;
         id.item = 0;
         gui->DoTimePlot(id, getWindowWidth()-300, getWindowHeight()-200, 290, 160, perfData, "Performance Monitor", new Scalar[2]{-1, 10000});
+        
+        //Statistics of simulation step phases
+        GLfloat left = getWindowWidth()-300.f;
+        unsigned int nPhases = (unsigned int)PerformancePhase::COUNT;
+        offset = getWindowHeight() - 210.f - 14.f * (nPhases + 1) - 10.f;
+        gui->DoPanel(left, offset, 290.f, 14.f * (nPhases + 1) + 10.f);
+        offset += 5.f;
+        gui->DoLabel(left + 5.f, offset, "Phase [us]");
+        gui->DoLabel(left + 120.f, offset, "Mean");
+        gui->DoLabel(left + 175.f, offset, "P95");
+        gui->DoLabel(left + 230.f, offset, "P99");
+        offset += 14.f;
+        for(unsigned int i=0; i<nPhases; ++i)
+        {
+            PerformanceStats stats = getSimulationManager()->getPerformanceMonitor().getPhaseStats((PerformancePhase)i);
+            gui->DoLabel(left + 5.f, offset, PerformanceMonitor::getPhaseName((PerformancePhase)i));
+            std::sprintf(buf, "%1.1lf", stats.mean);
+            gui->DoLabel(left + 120.f, offset, std::string(buf));
+            std::sprintf(buf, "%1.1lf", stats.p95);
+            gui->DoLabel(left + 175.f, offset, std::string(buf));
+            std::sprintf(buf, "%1.1lf", stats.p99);
+            gui->DoLabel(left + 230.f, offset, std::string(buf));
+            offset += 14.f;
+        }
+        
+        //Most expensive bodies in fluid dynamics computation
+        std::vector<std::pair<std::string, FluidDynamicsCost>> costs = getSimulationManager()->getFluidDynamicsCosts();
+        if(costs.size() > 0)
+        {
+            unsigned int nBodies = std::min((unsigned int)costs.size(), 8u);
+            left = getWindowWidth()-650.f;
+            offset = getWindowHeight() - 10.f - 14.f * (nBodies + 1) - 10.f;
+            gui->DoPanel(left, offset, 340.f, 14.f * (nBodies + 1) + 10.f);
+            offset += 5.f;
+            gui->DoLabel(left + 5.f, offset, "Body");
+            gui->DoLabel(left + 110.f, offset, "Total [ms]");
+            gui->DoLabel(left + 175.f, offset, "Faces");
+            gui->DoLabel(left + 225.f, offset, "In/Cross/Out [%]");
+            offset += 14.f;
+            for(unsigned int i=0; i<nBodies; ++i)
+            {
+                const FluidDynamicsCost& c = costs[i].second;
+                unsigned long long evals = c.hydroEvaluations + c.aeroEvaluations;
+                unsigned long long states = c.inside + c.crossing + c.outside;
+                gui->DoLabel(left + 5.f, offset, costs[i].first.substr(0, 16));
+                std::sprintf(buf, "%1.1lf", c.getTotalTime()/1000.0);
+                gui->DoLabel(left + 110.f, offset, std::string(buf));
+                std::sprintf(buf, "%llu", c.faces/evals);
+                gui->DoLabel(left + 175.f, offset, std::string(buf));
+                if(states > 0)
+                    std::sprintf(buf, "%1.0lf/%1.0lf/%1.0lf", 100.0*c.inside/states, 100.0*c.crossing/states, 100.0*c.outside/states);
+                else
+                    std::sprintf(buf, "-");
+                gui->DoLabel(left + 225.f, offset, std::string(buf));
+                offset += 14.f;
+            }
+        }
     }
 }
 
@@ -1097,12 +1188,14 @@ int GraphicalSimulationApp::RunSimulation(void* data)
 
     int maxThreads = std::max(omp_get_max_threads()/2, 1);
     omp_set_num_threads(maxThreads);
+    TraceRecorder::SetThreadName("Simulation");
     
     while(stdata->app->isRunning())
     {
         sim->AdvanceSimulation();
         if(stdata->app->getGLPipeline()->isDrawingQueueEmpty())
         {
+            TraceScope trace("Drawing queue update", "sim");
             SDL_LockMutex(stdata->drawingQueueMutex);
             sim->UpdateDrawingQueue();
             SDL_UnlockMutex(stdata->drawingQueueMutex);
@@ -24,54 +24,66 @@
 //
 
 #include "core/NameManager.h"
+#include <cctype>
 
 namespace sf
 {
 
 NameManager::NameManager()
 {
-    names = std::vector<std::string>(0);
 }
 
 NameManager::~NameManager()
 {
-    names.clear();
+    ClearNames();
 }
 
 std::string NameManager::AddName(std::string proposedName)
 {
-    std::string goodName = proposedName;
-    int number = 1;
+    if(names.insert(proposedName).second)
+        return proposedName;
+    
+    //Find the first free numeric suffix (all suffixes below the stored one are taken)
+    int& number = nextNumber[proposedName];
+    if(number < 1)
+        number = 1;
     
-checkname:
-    for(unsigned int i = 0; i < names.size(); i++)
+    std::string goodName;
+    do
     {
-        if(goodName == names[i])
-        {
-            goodName = proposedName + std::to_string(number);
-            number++;
-            goto checkname;
-        }
+        goodName = proposedName + std::to_string(number);
+        number++;
     }
+    while(!names.insert(goodName).second);
     
-    names.push_back(goodName);
     return goodName;
 }
 
 void NameManager::RemoveName(std::string name)
 {
-    std::vector<std::string>::iterator it;
-    for(it = names.begin(); it < names.end(); it++)
-        if(*it == name)
+    if(names.erase(name) == 0)
+        return;
+    
+    //The name may have been created by adding a numeric suffix to a proposed name
+    for(size_t i = name.size(); i > 0 && name.size() - i < 9 && std::isdigit((unsigned char)name[i-1]); --i)
+    {
+        if(name[i-1] == '0') //Suffixes never start with zero
+            continue;
+        
+        auto it = nextNumber.find(name.substr(0, i-1));
+        if(it != nextNumber.end())
         {
-            names.erase(it);
-            break;
+            int number = std::stoi(name.substr(i-1));
+            if(number < it->second)
+                it->second = number;
         }
+    }
 }
 
 void NameManager::ClearNames()
 {
     names.clear();
+    nextNumber.clear();
 }
 
 }
@@ -0,0 +1,60 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ProfiledDynamicsWorld.cpp
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "core/ProfiledDynamicsWorld.h"
+
+#include "utils/PerformanceMonitor.h"
+
+namespace sf
+{
+
+ProfiledDynamicsWorld::ProfiledDynamicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* pairCache, btMultiBodyConstraintSolver* constraintSolver,
+                                             btCollisionConfiguration* collisionConfiguration, btSoftBodySolver* softBodySolver, PerformanceMonitor* monitor)
+    : btSoftMultiBodyDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration, softBodySolver), perfMon(monitor)
+{
+}
+
+void ProfiledDynamicsWorld::performDiscreteCollisionDetection()
+{
+    //Same as btCollisionWorld::performDiscreteCollisionDetection, split into phases
+    perfMon->PhaseStarted(PerformancePhase::BROADPHASE);
+    updateAabbs();
+    computeOverlappingPairs();
+    perfMon->PhaseFinished(PerformancePhase::BROADPHASE);
+    
+    perfMon->PhaseStarted(PerformancePhase::NARROWPHASE);
+    if(getDispatcher() != nullptr)
+        getDispatcher()->dispatchAllCollisionPairs(getBroadphase()->getOverlappingPairCache(), getDispatchInfo(), getDispatcher());
+    perfMon->PhaseFinished(PerformancePhase::NARROWPHASE);
+}
+
+void ProfiledDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
+{
+    perfMon->PhaseStarted(PerformancePhase::SOLVER);
+    btSoftMultiBodyDynamicsWorld::solveConstraints(solverInfo);
+    perfMon->PhaseFinished(PerformancePhase::SOLVER);
+}
+
+}
@@ -0,0 +1,260 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  RealtimeGovernor.cpp
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "core/RealtimeGovernor.h"
+#include <algorithm>
+#include "core/SimulationApp.h"
+#include "core/SimulationManager.h"
+#include "sensors/Sensor.h"
+
+namespace sf
+{
+
+RealtimeGovernor::RealtimeGovernor() : load(0.0), level(0)
+{
+    nominalPrescaler = 1;
+    sensorRate = Scalar(1);
+    visionRate = Scalar(1);
+    saturated = false;
+    accPhysicsTime = 0.0;
+    accElapsedTime = 0.0;
+}
+
+void RealtimeGovernor::setSettings(const RealtimeGovernorSettings& s)
+{
+    settings = s;
+    settings.degradeLoad = btMax(settings.degradeLoad, Scalar(0.01));
+    settings.restoreLoad = btClamped(settings.restoreLoad, Scalar(0), settings.degradeLoad);
+    settings.interval = btMax(settings.interval, Scalar(0.01));
+    settings.maxPrescalerMultiplier = std::max(settings.maxPrescalerMultiplier, 1u);
+    settings.minSensorRate = btClamped(settings.minSensorRate, Scalar(0.01), Scalar(1));
+    settings.minVisionRate = btClamped(settings.minVisionRate, Scalar(0.01), Scalar(1));
+}
+
+RealtimeGovernorSettings RealtimeGovernor::getSettings() const
+{
+    return settings;
+}
+
+unsigned int RealtimeGovernor::getDegradationLevel() const
+{
+    return level.load(std::memory_order_relaxed);
+}
+
+double RealtimeGovernor::getLoad() const
+{
+    return load.load(std::memory_order_relaxed);
+}
+
+void RealtimeGovernor::Update(SimulationManager* sm, double physicsTime, double elapsedTime)
+{
+    if(!settings.enabled)
+        return;
+    
+    accPhysicsTime += physicsTime;
+    accElapsedTime += elapsedTime;
+    if(accElapsedTime < settings.interval * 1000000.0)
+        return;
+    
+    double l = accPhysicsTime/accElapsedTime;
+    load.store(l, std::memory_order_relaxed);
+    accPhysicsTime = 0.0;
+    accElapsedTime = 0.0;
+    
+    if(l > settings.degradeLoad)
+    {
+        //Find the most expensive of the phases that can be influenced
+        PerformanceMonitor& perf = sm->getPerformanceMonitor();
+        double fluid = perf.getPhaseStats(PerformancePhase::HYDRODYNAMICS).mean + perf.getPhaseStats(PerformancePhase::AERODYNAMICS).mean;
+        double sensors = perf.getPhaseStats(PerformancePhase::SENSORS).mean;
+        
+        Lever order[4];
+        if(sensors > fluid)
+        {
+            order[0] = Lever::SENSOR_RATE;
+            order[1] = Lever::VISION_RATE;
+            order[2] = Lever::FLUID_DYNAMICS_PRESCALER;
+            order[3] = Lever::MESH_LOD;
+        }
+        else
+        {
+            order[0] = Lever::FLUID_DYNAMICS_PRESCALER;
+            order[1] = Lever::MESH_LOD;
+            order[2] = Lever::VISION_RATE;
+            order[3] = Lever::SENSOR_RATE;
+        }
+        
+        for(unsigned int i=0; i<4; ++i)
+            if(Degrade(sm, order[i]))
+            {
+                level.store((unsigned int)decisions.size(), std::memory_order_relaxed);
+                return;
+            }
+        
+        if(!saturated)
+        {
+            cWarning("Realtime governor: load %1.0lf%%, fidelity already reduced to the configured bounds!", l * 100.0);
+            saturated = true;
+        }
+    }
+    else if(l < settings.restoreLoad && decisions.size() > 0)
+    {
+        Restore(sm);
+        level.store((unsigned int)decisions.size(), std::memory_order_relaxed);
+    }
+}
+
+bool RealtimeGovernor::Degrade(SimulationManager* sm, Lever lever)
+{
+    Decision d;
+    d.lever = lever;
+    d.prescaler = sm->getFluidDynamicsPrescaler();
+    d.rate = Scalar(1);
+    
+    if(decisions.size() == 0)
+        nominalPrescaler = d.prescaler;
+    
+    switch(lever)
+    {
+        case Lever::FLUID_DYNAMICS_PRESCALER:
+        {
+            unsigned int presc = std::min(d.prescaler * 2, nominalPrescaler * settings.maxPrescalerMultiplier);
+            if(presc <= d.prescaler)
+                return false;
+            sm->setFluidDynamicsPrescaler(presc);
+            cInfo("Realtime governor: load %1.0lf%%, fluid dynamics prescaler raised to %u.", getLoad() * 100.0, presc);
+        }
+            break;
+            
+        case Lever::MESH_LOD:
+        {
+            if(!settings.meshLOD || decisions.end() != std::find_if(decisions.begin(), decisions.end(), [](const Decision& x){ return x.lever == Lever::MESH_LOD; }))
+                return false;
+            unsigned int n = ApplyMeshLOD(sm, true);
+            if(n == 0)
+                return false;
+            cInfo("Realtime governor: load %1.0lf%%, fluid dynamics of %u bodies switched to coarse physics meshes.", getLoad() * 100.0, n);
+        }
+            break;
+            
+        case Lever::VISION_RATE:
+        case Lever::SENSOR_RATE:
+        {
+            bool vision = lever == Lever::VISION_RATE;
+            Scalar& rate = vision ? visionRate : sensorRate;
+            Scalar newRate = btMax(rate * Scalar(0.5), vision ? settings.minVisionRate : settings.minSensorRate);
+            if(newRate >= rate)
+                return false;
+            d.rate = rate;
+            rate = newRate;
+            ApplySensorRates(sm, vision, rate);
+            cInfo("Realtime governor: load %1.0lf%%, update frequency of %s lowered to %1.0lf%%.", getLoad() * 100.0, 
+                  vision ? "vision sensors" : "sensors", rate * Scalar(100));
+        }
+            break;
+    }
+    
+    decisions.push_back(d);
+    return true;
+}
+
+void RealtimeGovernor::Restore(SimulationManager* sm)
+{
+    Decision d = decisions.back();
+    decisions.pop_back();
+    saturated = false;
+    
+    switch(d.lever)
+    {
+        case Lever::FLUID_DYNAMICS_PRESCALER:
+            sm->setFluidDynamicsPrescaler(d.prescaler);
+            cInfo("Realtime governor: load %1.0lf%%, fluid dynamics prescaler restored to %u.", getLoad() * 100.0, d.prescaler);
+            break;
+            
+        case Lever::MESH_LOD:
+            ApplyMeshLOD(sm, false);
+            cInfo("Realtime governor: load %1.0lf%%, fluid dynamics switched back to full physics meshes.", getLoad() * 100.0);
+            break;
+            
+        case Lever::VISION_RATE:
+        case Lever::SENSOR_RATE:
+        {
+            bool vision = d.lever == Lever::VISION_RATE;
+            (vision ? visionRate : sensorRate) = d.rate;
+            ApplySensorRates(sm, vision, d.rate);
+            cInfo("Realtime governor: load %1.0lf%%, update frequency of %s restored to %1.0lf%%.", getLoad() * 100.0, 
+                  vision ? "vision sensors" : "sensors", d.rate * Scalar(100));
+        }
+            break;
+    }
+}
+
+void RealtimeGovernor::Reset(SimulationManager* sm)
+{
+    while(decisions.size() > 0)
+        Restore(sm);
+    
+    nominalRates.clear();
+    sensorRate = Scalar(1);
+    visionRate = Scalar(1);
+    saturated = false;
+    accPhysicsTime = 0.0;
+    accElapsedTime = 0.0;
+    load.store(0.0, std::memory_order_relaxed);
+    level.store(0, std::memory_order_relaxed);
+}
+
+void RealtimeGovernor::ApplySensorRates(SimulationManager* sm, bool vision, Scalar factor)
+{
+    Sensor* sens;
+    unsigned int id = 0;
+    while((sens = sm->getSensor(id++)) != nullptr)
+    {
+        if((sens->getType() == SensorType::VISION) != vision)
+            continue;
+        
+        auto it = nominalRates.find(sens);
+        if(it == nominalRates.end())
+        {
+            if(sens->getUpdateFrequency() <= Scalar(0)) //Updated every simulation step
+                continue;
+            it = nominalRates.insert(std::make_pair(sens, sens->getUpdateFrequency())).first;
+        }
+        sens->setUpdateFrequency(it->second * factor);
+    }
+}
+
+unsigned int RealtimeGovernor::ApplyMeshLOD(SimulationManager* sm, bool enabled)
+{
+    std::vector<SolidEntity*> bodies = sm->getFluidDynamicsBodies();
+    unsigned int n = 0;
+    for(size_t i=0; i<bodies.size(); ++i)
+        if(bodies[i]->setPhysicsMeshLOD(enabled))
+            ++n;
+    return n;
+}
+
+}
@@ -31,6 +31,7 @@
 #include "entities/statics/Obstacle.h"
 #include "entities/statics/Plane.h"
 #include "entities/statics/Terrain.h"
+#include "entities/statics/TiledTerrain.h"
 #include "entities/AnimatedEntity.h"
 #include "entities/animation/ManualTrajectory.h"
 #include "entities/animation/PWLTrajectory.h"
@@ -45,6 +46,8 @@
 #include "entities/solids/Compound.h"
 #include "entities/forcefields/Uniform.h"
 #include "entities/forcefields/Jet.h"
+#include "entities/forcefields/Stream.h"
+#include "entities/forcefields/Gridded.h"
 #include "entities/FeatherstoneEntity.h"
 #include "sensors/scalar/Accelerometer.h"
 #include "sensors/scalar/Gyroscope.h"
@@ -84,8 +87,13 @@
 #include "joints/FixedJoint.h"
 #include "graphics/OpenGLDataStructs.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/GeometryFileUtil.h"
+#include "utils/MeshCache.h"
 #include "tinyexpr.h"
 #include <sstream>
+#include <set>
+#include <tuple>
+#include <omp.h>
 
 namespace sf
 {
@@ -93,6 +101,7 @@ namespace sf
 ScenarioParser::ScenarioParser(SimulationManager* sm) : log(false), sm(sm)
 {
     graphical = SimulationApp::getApp()->hasGraphics();
+    log.setRateLimit(Scalar(0)); //Keep the complete log
 }
 
 std::vector<ConsoleMessage> ScenarioParser::getLog()
@@ -109,6 +118,7 @@ bool ScenarioParser::Parse(std::string filename)
 {
     cInfo("Scenario parser: Loading scenario from '%s'.", filename.c_str());
     log.Print(MessageType::INFO, "Scenario file: %s", filename.c_str());
+    uint64_t startTime = GetTimeInMicroseconds();
     
     //Open file
     XMLError result = doc.LoadFile(filename.c_str());
@@ -153,6 +163,7 @@ bool ScenarioParser::Parse(std::string filename)
         log.Print(MessageType::ERROR, "Including files failed!");
         return false;
     }
+    uint64_t readTime = GetTimeInMicroseconds();
 
     //Load solver settings
     XMLElement* element = root->FirstChildElement("solver");
@@ -202,6 +213,11 @@ bool ScenarioParser::Parse(std::string filename)
             element = element->NextSiblingElement("looks");
         }
     }
+    uint64_t settingsTime = GetTimeInMicroseconds();
+    
+    //Load and process all referenced meshes in parallel
+    PrepareAssets(root);
+    uint64_t assetsTime = GetTimeInMicroseconds();
         
     //Load static objects (optional)
     element = root->FirstChildElement("static");
@@ -339,7 +355,13 @@ bool ScenarioParser::Parse(std::string filename)
         element = element->NextSiblingElement("contact");
     }
     
+    preparedMeshes.clear(); //Entities keep their own references
+    uint64_t endTime = GetTimeInMicroseconds();
+    
     log.Print(MessageType::INFO, "Parsing finished normally.");
+    log.Print(MessageType::INFO, "Parsing time: reading %1.1lf ms, settings %1.1lf ms, assets %1.1lf ms, entities %1.1lf ms, total %1.1lf ms.",
+              (readTime - startTime)/1000.0, (settingsTime - readTime)/1000.0, (assetsTime - settingsTime)/1000.0, 
+              (endTime - assetsTime)/1000.0, (endTime - startTime)/1000.0);
     return true;
 }
 
@@ -587,10 +609,38 @@ bool ScenarioParser::ParseSolver(XMLElement* element)
     }
     sm->setSolverParams(erp, stopErp, erp2, globalDamping, globalFriction, linSleep, angSleep);
     
-    unsigned int presc;
-    if((item = element->FirstChildElement("fluid_dynamics")) != nullptr
-        && item->QueryAttribute("prescaler", &presc) == XML_SUCCESS)
+    if((item = element->FirstChildElement("fluid_dynamics")) != nullptr)
+    {
+        unsigned int presc;
+        if(item->QueryAttribute("prescaler", &presc) == XML_SUCCESS)
             sm->setFluidDynamicsPrescaler(presc);
+        
+        bool adaptive = false;
+        Scalar linTol(0.05);
+        Scalar angTol(0.01);
+        unsigned int maxSkipped = 10;
+        if(item->QueryAttribute("adaptive", &adaptive) == XML_SUCCESS && adaptive)
+        {
+            item->QueryAttribute("linear_tolerance", &linTol); //Optional
+            item->QueryAttribute("angular_tolerance", &angTol); //Optional
+            item->QueryAttribute("max_skipped", &maxSkipped); //Optional
+            sm->setAdaptiveFluidDynamics(true, linTol, angTol, maxSkipped);
+        }
+    }
+    
+    if((item = element->FirstChildElement("realtime_governor")) != nullptr)
+    {
+        RealtimeGovernorSettings rgs;
+        rgs.enabled = true;
+        item->QueryAttribute("degrade_load", &rgs.degradeLoad); //Optional
+        item->QueryAttribute("restore_load", &rgs.restoreLoad); //Optional
+        item->QueryAttribute("interval", &rgs.interval); //Optional
+        item->QueryAttribute("max_prescaler_multiplier", &rgs.maxPrescalerMultiplier); //Optional
+        item->QueryAttribute("min_sensor_rate", &rgs.minSensorRate); //Optional
+        item->QueryAttribute("min_vision_rate", &rgs.minVisionRate); //Optional
+        item->QueryAttribute("mesh_lod", &rgs.meshLOD); //Optional
+        sm->setRealtimeGovernor(rgs);
+    }
 
     return true;
 }
@@ -826,6 +876,99 @@ bool ScenarioParser::ParseLooks(XMLElement* element)
     return true;
 }
 
+void ScenarioParser::PrepareAssets(XMLNode* root)
+{
+    //Collect all meshes with their processing parameters
+    uint64_t startTime = GetTimeInMicroseconds();
+    std::vector<AssetRequest> requests;
+    if(root->ToElement() != nullptr)
+        CollectAssets(root->ToElement(), false, requests);
+    
+    //Remove duplicates, so that the same product is never computed twice concurrently
+    std::vector<AssetRequest> assets;
+    std::set<std::tuple<AssetUse, std::string, Scalar, Scalar, Scalar, unsigned int, unsigned int, bool>> uniqueAssets;
+    std::vector<std::pair<std::string, Scalar>> sources;
+    std::vector<std::pair<std::string, Scalar>> refined;
+    std::set<std::pair<std::string, Scalar>> uniqueSources;
+    std::set<std::pair<std::string, Scalar>> uniqueRefined;
+    for(size_t i=0; i<requests.size(); ++i)
+    {
+        const AssetRequest& r = requests[i];
+        std::pair<std::string, Scalar> source(r.filename, r.scale);
+        if(uniqueSources.insert(source).second)
+            sources.push_back(source);
+        if((r.use == AssetUse::REFINED_MESH || r.use == AssetUse::SOLID) && uniqueRefined.insert(source).second)
+            refined.push_back(source);
+        if(r.use != AssetUse::MESH && r.use != AssetUse::REFINED_MESH
+           && uniqueAssets.insert(std::make_tuple(r.use, r.filename, r.scale, r.thickness, r.density, r.hullVertices, r.decompositionParts, r.convex)).second)
+            assets.push_back(r);
+    }
+    uint64_t collectedTime = GetTimeInMicroseconds();
+    
+    //Load and refine meshes
+    preparedMeshes.clear();
+    preparedMeshes.resize(sources.size() + refined.size());
+    #pragma omp parallel for schedule(dynamic)
+    for(int i=0; i<(int)sources.size(); ++i)
+        preparedMeshes[i] = MeshCache::GetMesh(sources[i].first, (GLfloat)sources[i].second, false);
+    
+    #pragma omp parallel for schedule(dynamic)
+    for(int i=0; i<(int)refined.size(); ++i)
+        preparedMeshes[sources.size() + i] = MeshCache::GetRefinedMesh(refined[i].first, (GLfloat)refined[i].second, false, 3.f);
+    uint64_t loadedTime = GetTimeInMicroseconds();
+    
+    //Compute the products requested by the entities
+    #pragma omp parallel for schedule(dynamic)
+    for(int i=0; i<(int)assets.size(); ++i)
+    {
+        const AssetRequest& a = assets[i];
+        switch(a.use)
+        {
+            case AssetUse::SOLID:
+            {
+                std::shared_ptr<const Mesh> mesh = MeshCache::GetRefinedMesh(a.filename, (GLfloat)a.scale, false, 3.f);
+                MeshCache::GetPhysicalProperties(mesh.get(), a.thickness, a.density);
+                if(a.decompositionParts > 1)
+                    MeshCache::GetConvexDecomposition(mesh.get(), a.decompositionParts, a.hullVertices);
+                else
+                    MeshCache::GetConvexHull(mesh.get(), a.hullVertices);
+            }
+                break;
+                
+            case AssetUse::OBSTACLE:
+            {
+                std::shared_ptr<const Mesh> mesh = MeshCache::GetMesh(a.filename, (GLfloat)a.scale, false);
+                if(a.convex)
+                    MeshCache::GetConvexHull(mesh.get());
+                else
+                    MeshCache::GetTriangleMeshShape(mesh);
+            }
+                break;
+                
+            case AssetUse::ANIMATED:
+                MeshCache::GetConvexHull(MeshCache::GetMesh(a.filename, (GLfloat)a.scale, false).get());
+                break;
+                
+            case AssetUse::VBS_VOLUME:
+                MeshCache::GetPhysicalProperties(MeshCache::GetMesh(a.filename, (GLfloat)a.scale, false).get(), Scalar(0), a.density);
+                break;
+                
+            default:
+                break;
+        }
+    }
+    uint64_t endTime = GetTimeInMicroseconds();
+#ifdef _OPENMP
+    int nThreads = omp_get_max_threads();
+#else
+    int nThreads = 1; //Pragmas ignored when compiled without OpenMP support
+#endif
+    
+    log.Print(MessageType::INFO, "Prepared %lu meshes (%lu refined) and %lu derived assets using %d threads (collecting %1.1lf ms, loading %1.1lf ms, processing %1.1lf ms).",
+              sources.size(), refined.size(), assets.size(), nThreads, (collectedTime - startTime)/1000.0, 
+              (loadedTime - collectedTime)/1000.0, (endTime - loadedTime)/1000.0);
+}
+
 VelocityField* ScenarioParser::ParseVelocityField(XMLElement* element)
 {
     //Get type of current
@@ -884,6 +1027,64 @@ VelocityField* ScenarioParser::ParseVelocityField(XMLElement* element)
         Vector3 dir = v.normalized();
         return new Jet(c, dir, radius, v.norm());
     }
+    else if(vfTypeStr == "stream")
+    {
+        XMLElement* item;
+        const char* point;
+        std::vector<Vector3> c;
+        std::vector<Scalar> r;
+        Scalar vin;
+        Scalar exponent(1);
+        
+        for(item = element->FirstChildElement("point"); item != nullptr; item = item->NextSiblingElement("point"))
+        {
+            Vector3 p;
+            Scalar radius;
+            if(item->QueryStringAttribute("xyz", &point) != XML_SUCCESS
+               || !ParseVector(point, p)
+               || item->QueryAttribute("radius", &radius) != XML_SUCCESS)
+            {
+                log.Print(MessageType::WARNING, "Point definition of stream velocity field incorrect - skipping.");
+                return nullptr;
+            }
+            c.push_back(p);
+            r.push_back(radius);
+        }
+        if(c.size() < 2)
+        {
+            log.Print(MessageType::WARNING, "Stream velocity field requires at least two points - skipping.");
+            return nullptr;
+        }
+        if((item = element->FirstChildElement("velocity")) == nullptr
+            || item->QueryAttribute("value", &vin) != XML_SUCCESS)
+        {
+            log.Print(MessageType::WARNING, "Velocity definition of stream velocity field missing - skipping.");
+            return nullptr;
+        }
+        if((item = element->FirstChildElement("exponent")) != nullptr)
+            item->QueryAttribute("value", &exponent); //Optional
+        return new Stream(c, r, vin, exponent);
+    }
+    else if(vfTypeStr == "gridded")
+    {
+        XMLElement* item;
+        const char* file;
+        Scalar offset(0);
+        bool loop = false;
+
+        if((item = element->FirstChildElement("file")) == nullptr
+            || item->QueryStringAttribute("name", &file) != XML_SUCCESS)
+        {
+            log.Print(MessageType::WARNING, "Data file of gridded velocity field missing - skipping.");
+            return nullptr;
+        }
+        if((item = element->FirstChildElement("time")) != nullptr)
+        {
+            item->QueryAttribute("offset", &offset);
+            item->QueryAttribute("loop", &loop);
+        }
+        return new Gridded(GetFullPath(std::string(file)), offset, loop);
+    }
     else
     {
         log.Print(MessageType::WARNING, "Velocity field type not supported - skipping.");
@@ -1067,6 +1268,27 @@ bool ScenarioParser::ParseStatic(XMLElement* element)
         }   
         object = new Terrain(objectName, GetFullPath(std::string(heightmap)), scaleX, scaleY, height, std::string(mat), std::string(look), uvScale);
     }
+    else if(typestr == "tiled_terrain")
+    {
+        const char* heights = nullptr;
+        Scalar loadDistance, evictDistance;
+        
+        if((item = element->FirstChildElement("height_map")) == nullptr
+           || item->QueryStringAttribute("filename", &heights) != XML_SUCCESS)
+        {
+            log.Print(MessageType::ERROR, "Heightmap of terrain '%s' not properly defined!", objectName.c_str());
+            return false;
+        }
+        if((item = element->FirstChildElement("streaming")) == nullptr
+            || item->QueryAttribute("load_distance", &loadDistance) != XML_SUCCESS)
+        {
+            log.Print(MessageType::ERROR, "Streaming of terrain '%s' not properly defined!", objectName.c_str());
+            return false;
+        }
+        evictDistance = Scalar(2) * loadDistance;
+        item->QueryAttribute("evict_distance", &evictDistance);
+        object = new TiledTerrain(objectName, GetFullPath(std::string(heights)), loadDistance, evictDistance, std::string(mat), std::string(look), uvScale);
+    }
     else
     {
         log.Print(MessageType::ERROR, "Unknown type of static body '%s'!", objectName.c_str());
@@ -1843,6 +2065,9 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             Scalar phyScale(1);
             Transform phyOrigin;
             Scalar thickness(-1);
+            unsigned int hullVertices(0);
+            unsigned int decompositionParts(0);
+            Polyhedron* poly;
 
             if((item = element->FirstChildElement("physical")) == nullptr)
             {
@@ -1859,6 +2084,10 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             item2->QueryAttribute("scale", &phyScale);
             if((item2 = item->FirstChildElement("thickness")) != nullptr)
                 item2->QueryAttribute("value", &thickness);
+            if((item2 = item->FirstChildElement("hull")) != nullptr)
+                item2->QueryAttribute("max_vertices", &hullVertices);
+            if((item2 = item->FirstChildElement("decomposition")) != nullptr)
+                item2->QueryAttribute("max_parts", &decompositionParts);
             if((item2 = item->FirstChildElement("origin")) == nullptr || !ParseTransform(item2, phyOrigin))
             {
                 log.Print(MessageType::ERROR, "Physical mesh of rigid body '%s' not properly defined!", solidName.c_str());
@@ -1883,12 +2112,15 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
                     log.Print(MessageType::ERROR, "Visual mesh of rigid body '%s' not properly defined!", solidName.c_str());
                     return false;
                 }          
-                solid = new Polyhedron(solidName, phy, GetFullPath(std::string(graMesh)), graScale, graOrigin, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), std::string(look), thickness); 
+                poly = new Polyhedron(solidName, phy, GetFullPath(std::string(graMesh)), graScale, graOrigin, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), std::string(look), thickness); 
             }
             else
             {
-                solid = new Polyhedron(solidName, phy, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), std::string(look), thickness); 
+                poly = new Polyhedron(solidName, phy, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), std::string(look), thickness); 
             }
+            poly->setMaxHullVertices(hullVertices);
+            poly->setConvexDecomposition(decompositionParts);
+            solid = poly;
         }
         else
         {
@@ -4458,12 +4690,19 @@ bool ScenarioParser::ParseContact(XMLElement* element)
             displayMask |= CONTACT_DISPLAY_PATH_B;
     }
     
-    unsigned int history = 0;
+    unsigned int history = DEFAULT_CONTACT_HISTORY;
+    unsigned int pointHistory = 0;
+    bool recordPoints = false;
     if((itemA = element->FirstChildElement("history")) != nullptr)
-        itemA->QueryAttribute("points", &history);
+    {
+        itemA->QueryAttribute("steps", &history);
+        recordPoints = itemA->QueryAttribute("points", &pointHistory) == XML_SUCCESS;
+    }
     
-    Contact* cnt = new Contact(contactName, entA, entB, history);
+    Contact* cnt = new Contact(contactName, entA, entB, pointHistory, history);
     cnt->setDisplayMask(displayMask);
+    if(!recordPoints)
+        cnt->setPointRecording(false);
     sm->AddContact(cnt);
     
     return true;
@@ -4613,6 +4852,94 @@ std::string ScenarioParser::GetFullPath(const std::string& path)
 }
 
 //Private
+void ScenarioParser::CollectAssets(XMLElement* element, bool actuator, std::vector<AssetRequest>& assets)
+{
+    AssetRequest a;
+    a.scale = Scalar(1);
+    a.thickness = Scalar(-1);
+    a.density = Scalar(1000);
+    a.hullVertices = 0;
+    a.decompositionParts = 0;
+    a.convex = false;
+    
+    for(XMLElement* child = element->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+    {
+        std::string name(child->Name());
+        const char* type = nullptr;
+        const char* filename = nullptr;
+        child->QueryStringAttribute("type", &type);
+        
+        XMLElement* physical = child->FirstChildElement("physical");
+        XMLElement* mesh = physical != nullptr ? physical->FirstChildElement("mesh") : nullptr;
+        if(type != nullptr && std::string(type) == "model" && mesh != nullptr 
+           && mesh->QueryStringAttribute("filename", &filename) == XML_SUCCESS && filename[0] != '\0')
+        {
+            AssetRequest body = a;
+            body.filename = GetFullPath(std::string(filename));
+            mesh->QueryAttribute("scale", &body.scale);
+            
+            if(name == "static")
+            {
+                body.use = AssetUse::OBSTACLE;
+                mesh->QueryAttribute("convex", &body.convex);
+            }
+            else if(name == "animated")
+                body.use = AssetUse::ANIMATED;
+            else //Rigid body, link or compound part
+            {
+                const char* mat = nullptr;
+                XMLElement* item;
+                body.use = AssetUse::SOLID;
+                if((item = child->FirstChildElement("material")) != nullptr && item->QueryStringAttribute("name", &mat) == XML_SUCCESS)
+                    body.density = sm->getMaterialManager()->getMaterial(std::string(mat)).density;
+                if((item = physical->FirstChildElement("thickness")) != nullptr)
+                    item->QueryAttribute("value", &body.thickness);
+                if((item = physical->FirstChildElement("hull")) != nullptr)
+                    item->QueryAttribute("max_vertices", &body.hullVertices);
+                if((item = physical->FirstChildElement("decomposition")) != nullptr)
+                    item->QueryAttribute("max_parts", &body.decompositionParts);
+                body.hullVertices = body.hullVertices == 0 ? 0 : (body.hullVertices < 4 ? 4 : body.hullVertices);
+            }
+            assets.push_back(body);
+        }
+        else if(name == "actuator" && type != nullptr && std::string(type) == "vbs")
+        {
+            XMLElement* volume = child->FirstChildElement("volume");
+            for(mesh = volume != nullptr ? volume->FirstChildElement("mesh") : nullptr; mesh != nullptr; mesh = mesh->NextSiblingElement("mesh"))
+                if(mesh->QueryStringAttribute("filename", &filename) == XML_SUCCESS && filename[0] != '\0')
+                {
+                    AssetRequest volumeMesh = a;
+                    volumeMesh.use = AssetUse::VBS_VOLUME;
+                    volumeMesh.filename = GetFullPath(std::string(filename));
+                    if(sm->getOcean() != nullptr)
+                        volumeMesh.density = sm->getOcean()->getLiquid().density;
+                    assets.push_back(volumeMesh);
+                }
+            continue;
+        }
+        else if(name == "mesh" && physical == nullptr && child->QueryStringAttribute("filename", &filename) == XML_SUCCESS && filename[0] != '\0')
+        {
+            //Visual meshes (propellers and rudders of actuators are refined)
+            AssetRequest visual = a;
+            visual.use = actuator ? AssetUse::REFINED_MESH : AssetUse::MESH;
+            visual.filename = GetFullPath(std::string(filename));
+            child->QueryAttribute("scale", &visual.scale);
+            assets.push_back(visual);
+        }
+        else if(name == "visual" && isGraphicalSim() && child->QueryStringAttribute("filename", &filename) == XML_SUCCESS && filename[0] != '\0')
+        {
+            //Visual representation of sensors
+            AssetRequest visual = a;
+            visual.use = AssetUse::MESH;
+            visual.filename = GetFullPath(std::string(filename));
+            child->QueryAttribute("scale", &visual.scale);
+            assets.push_back(visual);
+        }
+        
+        CollectAssets(child, actuator || name == "actuator", assets);
+    }
+}
+
 bool ScenarioParser::CopyNode(XMLNode* destParent, const XMLNode* src)
 {
     //Should not happen, could maybe return false
@@ -39,6 +39,7 @@
 #include <typeinfo>
 #include <omp.h>
 #include <algorithm>
+#include <unordered_set>
 #include "core/FilteredCollisionDispatcher.h"
 #include "core/GraphicalSimulationApp.h"
 #include "core/NameManager.h"
@@ -53,6 +54,8 @@
 #include "utils/SystemUtil.hpp"
 #include "utils/UnitSystem.h"
 #include "utils/RayTest.hpp"
+#include "utils/TraceRecorder.h"
+#include "utils/MeshCache.h"
 #include "entities/Entity.h"
 //#include "entities/CableEntity.h"
 #include "entities/FeatherstoneEntity.h"
@@ -62,11 +65,14 @@
 #include "entities/ForcefieldEntity.h"
 #include "entities/forcefields/Trigger.h"
 #include "entities/statics/Plane.h"
+#include "entities/statics/TiledTerrain.h"
+#include "core/ProfiledDynamicsWorld.h"
 #include "joints/Joint.h"
 #include "actuators/Actuator.h"
 #include "actuators/Light.h"
 #include "actuators/SuctionCup.h"
 #include "sensors/Sensor.h"
+#include "sensors/ScalarSensor.h"
 #include "comms/Comm.h"
 #include "sensors/Contact.h"
 #include "sensors/VisionSensor.h"
@@ -79,7 +85,7 @@ namespace sf
 {
 
 SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, CollisionFilteringType cft) 
-    : perfMon(PerformanceMonitor(100))
+    : perfMon(1000)
 {
     //Initialize simulation world
     realtimeFactor = Scalar(1);
@@ -91,6 +97,7 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, Colli
     linSleepThreshold = Scalar(0);
     angSleepThreshold = Scalar(0);
     fdCounter = 0;
+    setAdaptiveFluidDynamics(false);
     currentTime = 0;
     simulationTime = 0;
     mlcpFallbacks = 0;
@@ -137,6 +144,7 @@ void SimulationManager::AddRobot(Robot* robot, const Transform& worldTransform)
     if(robot != nullptr)
     {
         robots.push_back(robot);
+        robotIndex[robot->getName()] = robot;
         robot->AddToSimulation(this, worldTransform);
     }
 }
@@ -145,7 +153,7 @@ void SimulationManager::AddEntity(Entity *ent)
 {
     if(ent != nullptr)
     {
-        entities.push_back(ent);
+        RegisterEntity(ent);
         ent->AddToSimulation(this);
     }
 }
@@ -154,7 +162,7 @@ void SimulationManager::AddStaticEntity(StaticEntity* ent, const Transform& orig
 {
     if(ent != nullptr)
     {
-        entities.push_back(ent);
+        RegisterEntity(ent);
         ent->AddToSimulation(this, origin);
     }
 }
@@ -163,7 +171,7 @@ void SimulationManager::AddAnimatedEntity(AnimatedEntity* ent)
 {
     if(ent != nullptr)
     {
-        entities.push_back(ent);
+        RegisterEntity(ent);
         ent->AddToSimulation(this);
     }
 }
@@ -172,7 +180,7 @@ void SimulationManager::AddSolidEntity(SolidEntity* ent, const Transform& origin
 {
     if(ent != nullptr)
     {
-        entities.push_back(ent);
+        RegisterEntity(ent);
         ent->AddToSimulation(this, origin);
     }
 }
@@ -186,7 +194,7 @@ void SimulationManager::RemoveSolidEntity(SolidEntity* ent)
         {
             SolidEntity* solid = static_cast<SolidEntity*>(*it);
             solid->RemoveFromSimulation(this);
-            entities.erase(it);
+            UnregisterEntity(solid);
         }
     }
 }
@@ -195,7 +203,7 @@ void SimulationManager::AddFeatherstoneEntity(FeatherstoneEntity* ent, const Tra
 {
     if(ent != nullptr)
     {
-        entities.push_back(ent);
+        RegisterEntity(ent);
         ent->AddToSimulation(this, origin);
     }
 }
@@ -209,11 +217,56 @@ void SimulationManager::RemoveFeatherstoneEntity(FeatherstoneEntity* ent)
         {
             FeatherstoneEntity* fe = static_cast<FeatherstoneEntity*>(*it);
             fe->RemoveFromSimulation(this);
-            entities.erase(it);
+            UnregisterEntity(fe);
         }
     }
 }
     
+void SimulationManager::RegisterEntity(Entity* ent)
+{
+    entities.push_back(ent);
+    entityIndex[ent->getName()] = ent;
+    
+    switch(ent->getType())
+    {
+        case EntityType::SOLID:
+            solids.push_back((SolidEntity*)ent);
+            break;
+            
+        case EntityType::FEATHERSTONE:
+            multibodies.push_back((FeatherstoneEntity*)ent);
+            break;
+            
+        case EntityType::ANIMATED:
+            animated.push_back((AnimatedEntity*)ent);
+            break;
+            
+        case EntityType::STATIC:
+            if(((StaticEntity*)ent)->getStaticType() == StaticEntityType::TILED_TERRAIN)
+                terrains.push_back((TiledTerrain*)ent);
+            break;
+            
+        case EntityType::FORCEFIELD:
+            if(((ForcefieldEntity*)ent)->getForcefieldType() == ForcefieldType::TRIGGER)
+                triggers.push_back((Trigger*)ent);
+            break;
+            
+        default:
+            break;
+    }
+}
+
+void SimulationManager::UnregisterEntity(Entity* ent)
+{
+    entities.erase(std::find(entities.begin(), entities.end(), ent));
+    entityIndex.erase(ent->getName());
+    
+    if(ent->getType() == EntityType::SOLID)
+        solids.erase(std::find(solids.begin(), solids.end(), (SolidEntity*)ent));
+    else if(ent->getType() == EntityType::FEATHERSTONE)
+        multibodies.erase(std::find(multibodies.begin(), multibodies.end(), (FeatherstoneEntity*)ent));
+}
+
 void SimulationManager::EnableOcean(Scalar waves, Fluid f)
 {
     if(ocean != nullptr)
@@ -258,13 +311,19 @@ void SimulationManager::EnableAtmosphere()
 void SimulationManager::AddSensor(Sensor* sens)
 {
     if(sens != nullptr)
+    {
         sensors.push_back(sens);
+        sensorIndex[sens->getName()] = sens;
+    }
 }
 
 void SimulationManager::AddComm(Comm* comm)
 {
     if(comm != nullptr)
+    {
         comms.push_back(comm);
+        commIndex[comm->getName()] = comm;
+    }
 }
 
 void SimulationManager::AddJoint(Joint* jnt)
@@ -272,6 +331,7 @@ void SimulationManager::AddJoint(Joint* jnt)
     if(jnt != nullptr)
     {
         joints.push_back(jnt);
+        jointIndex[jnt->getName()] = jnt;
         jnt->AddToSimulation(this);
     }
 }
@@ -284,6 +344,7 @@ void SimulationManager::RemoveJoint(Joint* jnt)
         if(it != joints.end())
         {
             (*it)->RemoveFromSimulation(this);
+            jointIndex.erase((*it)->getName());
             delete *it;
             joints.erase(it);
         }
@@ -293,7 +354,12 @@ void SimulationManager::RemoveJoint(Joint* jnt)
 void SimulationManager::AddActuator(Actuator *act)
 {
     if(act != nullptr)
+    {
         actuators.push_back(act);
+        actuatorIndex[act->getName()] = act;
+        if(act->getType() == ActuatorType::SUCTION_CUP)
+            suctionCups.push_back((SuctionCup*)act);
+    }
 }
 
 void SimulationManager::AddContact(Contact* cnt)
@@ -301,6 +367,8 @@ void SimulationManager::AddContact(Contact* cnt)
     if(cnt != nullptr)
     {
         contacts.push_back(cnt);
+        contactIndex[cnt->getName()] = cnt;
+        contactPairs.emplace(MakeEntityPair(cnt->getEntityA(), cnt->getEntityB()), cnt);
         EnableCollision(cnt->getEntityA(), cnt->getEntityB());
     }
 }
@@ -352,23 +420,15 @@ void SimulationManager::DisableCollision(const Entity* entA, const Entity* entB)
     }
 }
 
+std::pair<const Entity*, const Entity*> SimulationManager::MakeEntityPair(const Entity* entA, const Entity* entB)
+{
+    return entA < entB ? std::make_pair(entA, entB) : std::make_pair(entB, entA);
+}
+
 Contact* SimulationManager::getContact(Entity* entA, Entity* entB)
 {
-    for(size_t i = 0; i < contacts.size(); ++i)
-    {
-        if(contacts[i]->getEntityA() == entA)
-        {
-            if(contacts[i]->getEntityB() == entB)
-                return contacts[i];
-        }
-        else if(contacts[i]->getEntityB() == entA)
-        {
-            if(contacts[i]->getEntityA() == entB)
-                return contacts[i];
-        }
-    }
-    
-    return nullptr;
+    auto it = contactPairs.find(MakeEntityPair(entA, entB));
+    return it != contactPairs.end() ? it->second : nullptr;
 }
 
 Contact* SimulationManager::getContact(unsigned int index)
@@ -381,11 +441,8 @@ Contact* SimulationManager::getContact(unsigned int index)
 
 Contact* SimulationManager::getContact(const std::string& name)
 {
-    for(size_t i = 0; i < contacts.size(); ++i)
-        if(contacts[i]->getName() == name)
-            return contacts[i];
-    
-    return nullptr;
+    auto it = contactIndex.find(name);
+    return it != contactIndex.end() ? it->second : nullptr;
 }
 
 CollisionFilteringType SimulationManager::getCollisionFilter() const
@@ -408,11 +465,8 @@ Robot* SimulationManager::getRobot(unsigned int index)
 
 Robot* SimulationManager::getRobot(const std::string& name)
 {
-    for(size_t i = 0; i < robots.size(); ++i)
-        if(robots[i]->getName() == name)
-            return robots[i];
-    
-    return nullptr;
+    auto it = robotIndex.find(name);
+    return it != robotIndex.end() ? it->second : nullptr;
 }
 
 Entity* SimulationManager::getEntity(unsigned int index)
@@ -425,11 +479,8 @@ Entity* SimulationManager::getEntity(unsigned int index)
 
 Entity* SimulationManager::getEntity(const std::string& name)
 {
-    for(size_t i = 0; i < entities.size(); ++i)
-        if(entities[i]->getName() == name)
-            return entities[i];
-    
-    return nullptr;
+    auto it = entityIndex.find(name);
+    return it != entityIndex.end() ? it->second : nullptr;
 }
 
 Joint* SimulationManager::getJoint(unsigned int index)
@@ -442,11 +493,8 @@ Joint* SimulationManager::getJoint(unsigned int index)
 
 Joint* SimulationManager::getJoint(const std::string& name)
 {
-    for(size_t i = 0; i < joints.size(); ++i)
-        if(joints[i]->getName() == name)
-            return joints[i];
-    
-    return nullptr;
+    auto it = jointIndex.find(name);
+    return it != jointIndex.end() ? it->second : nullptr;
 }
 
 Actuator* SimulationManager::getActuator(unsigned int index)
@@ -459,11 +507,8 @@ Actuator* SimulationManager::getActuator(unsigned int index)
 
 Actuator* SimulationManager::getActuator(const std::string& name)
 {
-    for(size_t i = 0; i < actuators.size(); ++i)
-        if(actuators[i]->getName() == name)
-            return actuators[i];
-    
-    return nullptr;
+    auto it = actuatorIndex.find(name);
+    return it != actuatorIndex.end() ? it->second : nullptr;
 }
 
 Sensor* SimulationManager::getSensor(unsigned int index)
@@ -476,11 +521,8 @@ Sensor* SimulationManager::getSensor(unsigned int index)
 
 Sensor* SimulationManager::getSensor(const std::string& name)
 {
-    for(size_t i = 0; i < sensors.size(); ++i)
-        if(sensors[i]->getName() == name)
-            return sensors[i];
-    
-    return nullptr;
+    auto it = sensorIndex.find(name);
+    return it != sensorIndex.end() ? it->second : nullptr;
 }
 
 Comm* SimulationManager::getComm(unsigned int index)
@@ -493,11 +535,8 @@ Comm* SimulationManager::getComm(unsigned int index)
 
 Comm* SimulationManager::getComm(const std::string& name)
 {
-    for(size_t i = 0; i < comms.size(); ++i)
-        if(comms[i]->getName() == name)
-            return comms[i];
-    
-    return nullptr;
+    auto it = commIndex.find(name);
+    return it != commIndex.end() ? it->second : nullptr;
 }
 
 NED* SimulationManager::getNED()
@@ -559,6 +598,116 @@ PerformanceMonitor& SimulationManager::getPerformanceMonitor()
     return perfMon;
 }
 
+void SimulationManager::setRealtimeGovernor(const RealtimeGovernorSettings& settings)
+{
+    SDL_LockMutex(simSettingsMutex);
+    governor.Reset(this);
+    governor.setSettings(settings);
+    SDL_UnlockMutex(simSettingsMutex);
+}
+
+const RealtimeGovernor& SimulationManager::getRealtimeGovernor() const
+{
+    return governor;
+}
+
+std::vector<SolidEntity*> SimulationManager::getFluidDynamicsBodies()
+{
+    std::vector<SolidEntity*> bodies(solids.begin(), solids.end());
+    for(size_t i=0; i<multibodies.size(); ++i)
+        for(unsigned int h=0; h<multibodies[i]->getNumOfLinks(); ++h)
+            bodies.push_back(multibodies[i]->getLink(h).solid);
+    return bodies;
+}
+
+std::vector<std::pair<std::string, FluidDynamicsCost>> SimulationManager::getFluidDynamicsCosts()
+{
+    std::vector<SolidEntity*> bodies = getFluidDynamicsBodies();
+    std::vector<std::pair<std::string, FluidDynamicsCost>> costs;
+    for(size_t i=0; i<bodies.size(); ++i)
+    {
+        FluidDynamicsCost c = bodies[i]->getFluidDynamicsCost();
+        if(c.hydroEvaluations > 0 || c.aeroEvaluations > 0)
+            costs.push_back(std::make_pair(bodies[i]->getName(), c));
+    }
+    std::sort(costs.begin(), costs.end(), [](const std::pair<std::string, FluidDynamicsCost>& a, const std::pair<std::string, FluidDynamicsCost>& b)
+              { return a.second.getTotalTime() > b.second.getTotalTime(); });
+    return costs;
+}
+
+void SimulationManager::UpdateMemoryUsage()
+{
+    //Lock the simulation settings so that the measurement is not run concurrently with a simulation step,
+    //which modifies the contact and sensor histories and may build meshes (realtime governor)
+    SDL_LockMutex(simSettingsMutex);
+    
+    //Meshes (meshes shared between entities or with the mesh cache are counted once)
+    std::vector<const Mesh*> graMeshes;
+    std::vector<const Mesh*> phyMeshes;
+    for(size_t i=0; i<entities.size(); ++i)
+        entities[i]->getMeshes(graMeshes, phyMeshes);
+    
+    std::unordered_set<const Mesh*> counted;
+    size_t bytes = 0;
+    for(size_t i=0; i<phyMeshes.size(); ++i)
+        if(counted.insert(phyMeshes[i]).second)
+            bytes += phyMeshes[i]->getMemoryUsage();
+    perfMon.setMemoryUsage(MemoryCategory::PHYSICS_MESHES, bytes);
+    
+    bytes = 0;
+    for(size_t i=0; i<graMeshes.size(); ++i)
+        if(counted.insert(graMeshes[i]).second)
+            bytes += graMeshes[i]->getMemoryUsage();
+    perfMon.setMemoryUsage(MemoryCategory::GRAPHICS_MESHES, bytes);
+    
+    //Histories and buffers
+    bytes = 0;
+    for(size_t i=0; i<sensors.size(); ++i)
+    {
+        ScalarSensor* sens = dynamic_cast<ScalarSensor*>(sensors[i]);
+        if(sens != nullptr)
+            bytes += sens->getHistoryMemoryUsage();
+    }
+    perfMon.setMemoryUsage(MemoryCategory::SENSOR_HISTORY, bytes);
+    
+    bytes = 0;
+    for(size_t i=0; i<contacts.size(); ++i)
+        bytes += contacts[i]->getHistoryMemoryUsage();
+    perfMon.setMemoryUsage(MemoryCategory::CONTACT_HISTORY, bytes);
+    
+    bytes = 0;
+    for(size_t i=0; i<comms.size(); ++i)
+        bytes += comms[i]->getBufferMemoryUsage();
+    perfMon.setMemoryUsage(MemoryCategory::COMMS, bytes);
+    
+    //Libraries
+    perfMon.setMemoryUsage(MemoryCategory::BULLET, PerformanceMonitor::getBulletMemoryUsage());
+    if(SimulationApp::getApp()->hasGraphics())
+    {
+        OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
+        perfMon.setMemoryUsage(MemoryCategory::GL_BUFFERS, content->getBufferMemoryUsage());
+        perfMon.setMemoryUsage(MemoryCategory::GL_TEXTURES, OpenGLContent::getTextureMemoryUsage());
+    }
+    else
+    {
+        perfMon.setMemoryUsage(MemoryCategory::GL_BUFFERS, 0);
+        perfMon.setMemoryUsage(MemoryCategory::GL_TEXTURES, 0);
+    }
+    
+    SDL_UnlockMutex(simSettingsMutex);
+}
+
+void SimulationManager::ReportMemoryUsage()
+{
+    UpdateMemoryUsage();
+    cInfo("Memory usage: %1.1lf MiB", (double)perfMon.getTotalMemoryUsage()/1048576.0);
+    for(size_t i=0; i<(size_t)MemoryCategory::COUNT; ++i)
+    {
+        MemoryCategory category = (MemoryCategory)i;
+        cInfo("  %s: %1.1lf MiB", PerformanceMonitor::getMemoryCategoryName(category), (double)perfMon.getMemoryUsage(category)/1048576.0);
+    }
+}
+
 OpenGLTrackball* SimulationManager::getTrackball()
 {
     return trackball;
@@ -584,6 +733,19 @@ void SimulationManager::setFluidDynamicsPrescaler(unsigned int presc)
         fdPrescaler = presc;
 }
 
+unsigned int SimulationManager::getFluidDynamicsPrescaler() const
+{
+    return fdPrescaler;
+}
+
+void SimulationManager::setAdaptiveFluidDynamics(bool enabled, Scalar linearTolerance, Scalar angularTolerance, unsigned int maxSkipped)
+{
+    fdAdaptive.enabled = enabled;
+    fdAdaptive.linearTolerance = btMax(linearTolerance, Scalar(0));
+    fdAdaptive.angularTolerance = btMax(angularTolerance, Scalar(0));
+    fdAdaptive.maxSkipped = maxSkipped;
+}
+
 void SimulationManager::setRealtimeFactor(Scalar f)
 {
     SDL_LockMutex(simInfoMutex);
@@ -764,7 +926,7 @@ void SimulationManager::InitializeSolver()
     sbSolver = new btDefaultSoftBodySolver();
 
     //Create dynamics world
-    dynamicsWorld = new btSoftMultiBodyDynamicsWorld(dwDispatcher, dwBroadphase, mbSolver, dwCollisionConfig, sbSolver);
+    dynamicsWorld = new ProfiledDynamicsWorld(dwDispatcher, dwBroadphase, mbSolver, dwCollisionConfig, sbSolver, &perfMon);
     
     //Basic configuration
     dynamicsWorld->getSolverInfo().m_solverMode = SOLVER_USE_WARMSTARTING | SOLVER_SIMD | SOLVER_USE_2_FRICTION_DIRECTIONS; //SOLVER_RANDMIZE_ORDER | SOLVER_ENABLE_FRICTION_DIRECTION_CACHING;
@@ -851,14 +1013,21 @@ void SimulationManager::RestartScenario()
     InitializeScenario();
     BuildScenario(); //Defined by specific application
     
+    //Resolve references between objects
+    for(size_t i = 0; i < sensors.size(); ++i)
+        sensors[i]->ResolveDependencies();
+    
     if(SimulationApp::getApp()->hasGraphics())
         ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->Finalize();
-
+    
+    ReportMemoryUsage();
     simulationFresh = true;
 }
 
 void SimulationManager::DestroyScenario()
 {
+    governor.Reset(this); //Restore settings of the objects before they are destroyed
+    
     if(dynamicsWorld != nullptr)
     {
         //remove objects from dynamic world
@@ -892,10 +1061,17 @@ void SimulationManager::DestroyScenario()
     for(size_t i=0; i<robots.size(); ++i)
         delete robots[i];
     robots.clear();
+    robotIndex.clear();
     
     for(size_t i=0; i<entities.size(); ++i)
         delete entities[i];
     entities.clear();
+    entityIndex.clear();
+    solids.clear();
+    multibodies.clear();
+    animated.clear();
+    terrains.clear();
+    triggers.clear();
     
     if(ocean != nullptr)
     {
@@ -912,22 +1088,29 @@ void SimulationManager::DestroyScenario()
     for(size_t i=0; i<joints.size(); ++i)
         delete joints[i];
     joints.clear();
+    jointIndex.clear();
     
     for(size_t i=0; i<contacts.size(); ++i)
         delete contacts[i];
     contacts.clear();
+    contactIndex.clear();
+    contactPairs.clear();
     
     for(size_t i=0; i<sensors.size(); ++i)
         delete sensors[i];
     sensors.clear();
+    sensorIndex.clear();
     
     for(size_t i=0; i<comms.size(); ++i)
         delete comms[i];
     comms.clear();
+    commIndex.clear();
     
     for(size_t i=0; i<actuators.size(); ++i)
         delete actuators[i];
     actuators.clear();
+    actuatorIndex.clear();
+    suctionCups.clear();
     
     if(nameManager != nullptr)
         nameManager->ClearNames();
@@ -940,6 +1123,10 @@ void SimulationManager::DestroyScenario()
         ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->DestroyContent();
 		trackball = nullptr;
 	}
+    
+    perfMon.ClearHydrodynamicsBodies();
+    if(!MeshCache::isRetainingUnused())
+        MeshCache::Purge();
 }
 
 bool SimulationManager::StartSimulation()
@@ -962,6 +1149,18 @@ bool SimulationManager::StartSimulation()
     for(unsigned int i = 0; i < sensors.size(); i++)
         sensors[i]->Reset();
 
+    //Reset fluid dynamics cost accounting and register the bodies in the performance monitor
+    std::vector<SolidEntity*> bodies = getFluidDynamicsBodies();
+    perfMon.ClearHydrodynamicsBodies();
+    for(size_t i = 0; i < bodies.size(); i++)
+    {
+        bodies[i]->ResetFluidDynamicsCost();
+        bodies[i]->setHydrodynamicsCounters(perfMon.AddHydrodynamicsBody(bodies[i]->getName()));
+    }
+    
+    //Restore full fidelity
+    governor.Reset(this);
+
     perfMon.SimulationStarted();
     
     return true;
@@ -1068,6 +1267,7 @@ void SimulationManager::AdvanceSimulation()
     perfMon.PhysicsStarted();
     dynamicsWorld->stepSimulation((Scalar)deltaTime/Scalar(1000000.0), 1000000, (Scalar)ssus/Scalar(1000000.0));
     perfMon.PhysicsFinished();
+    governor.Update(this, perfMon.getPhysicsTime(), (double)deltaTime);
     SDL_UnlockMutex(simSettingsMutex);
 
     SDL_LockMutex(simInfoMutex);
@@ -1359,76 +1559,65 @@ void SimulationManager::SolveICTickCallback(btDynamicsWorld* world, Scalar timeS
     if(simManager->icUseGravity)
     {
         //Apply gravity to bodies
-        for(size_t i = 0; i < simManager->entities.size(); ++i)
-        {
-            if(simManager->entities[i]->getType() == EntityType::SOLID)
-            {
-                SolidEntity* solid = (SolidEntity*)simManager->entities[i];
-                solid->ApplyGravity(world->getGravity());
-            }
-            else if(simManager->entities[i]->getType() == EntityType::FEATHERSTONE)
-            {
-                FeatherstoneEntity* feather = (FeatherstoneEntity*)simManager->entities[i];
-                feather->ApplyGravity(world->getGravity());
-            }
-        }
+        for(size_t i = 0; i < simManager->solids.size(); ++i)
+            simManager->solids[i]->ApplyGravity(world->getGravity());
+        for(size_t i = 0; i < simManager->multibodies.size(); ++i)
+            simManager->multibodies[i]->ApplyGravity(world->getGravity());
         
         if(simManager->simulationTime < Scalar(0.01)) //Wait for a few cycles to ensure bodies started moving
             objectsSettled = false;
         else
         {
             //Check if objects settled
-            for(size_t i = 0; i < simManager->entities.size(); ++i)
+            for(size_t i = 0; i < simManager->solids.size(); ++i)
             {
-                if(simManager->entities[i]->getType() == EntityType::SOLID)
+                SolidEntity* solid = simManager->solids[i];
+                if(solid->getLinearVelocity().length() > simManager->icLinTolerance * Scalar(100.) || solid->getAngularVelocity().length() > simManager->icAngTolerance * Scalar(100.))
                 {
-                    SolidEntity* solid = (SolidEntity*)simManager->entities[i];
-                    if(solid->getLinearVelocity().length() > simManager->icLinTolerance * Scalar(100.) || solid->getAngularVelocity().length() > simManager->icAngTolerance * Scalar(100.))
-                    {
-                        objectsSettled = false;
-                        break;
-                    }
+                    objectsSettled = false;
+                    break;
                 }
-                else if(simManager->entities[i]->getType() == EntityType::FEATHERSTONE)
+            }
+            
+            for(size_t i = 0; i < simManager->multibodies.size() && objectsSettled; ++i)
+            {
+                FeatherstoneEntity* multibody = simManager->multibodies[i];
+                
+                //Check base velocity
+                Vector3 baseLinVel = multibody->getLinkLinearVelocity(0);
+                Vector3 baseAngVel = multibody->getLinkAngularVelocity(0);
+                
+                if(baseLinVel.length() > simManager->icLinTolerance * Scalar(100.) || baseAngVel.length() > simManager->icAngTolerance * Scalar(100.0))
                 {
-                    FeatherstoneEntity* multibody = (FeatherstoneEntity*)simManager->entities[i];
-                    
-                    //Check base velocity
-                    Vector3 baseLinVel = multibody->getLinkLinearVelocity(0);
-                    Vector3 baseAngVel = multibody->getLinkAngularVelocity(0);
-                    
-                    if(baseLinVel.length() > simManager->icLinTolerance * Scalar(100.) || baseAngVel.length() > simManager->icAngTolerance * Scalar(100.0))
-                    {
-                        objectsSettled = false;
-                        break;
-                    }
+                    objectsSettled = false;
+                    break;
+                }
+                
+                //Loop through all joints
+                for(size_t h = 0; h < multibody->getNumOfJoints(); ++h)
+                {
+                    Scalar jVelocity;
+                    btMultibodyLink::eFeatherstoneJointType jType;
+                    multibody->getJointVelocity((unsigned int)h, jVelocity, jType);
                     
-                    //Loop through all joints
-                    for(size_t h = 0; h < multibody->getNumOfJoints(); ++h)
+                    switch(jType)
                     {
-                        Scalar jVelocity;
-                        btMultibodyLink::eFeatherstoneJointType jType;
-                        multibody->getJointVelocity((unsigned int)h, jVelocity, jType);
-                        
-                        switch(jType)
-                        {
-                            case btMultibodyLink::eRevolute:
-                                if(Vector3(jVelocity,0,0).length() > simManager->icAngTolerance * Scalar(100.))
-                                    objectsSettled = false;
-                                break;
-                                
-                            case btMultibodyLink::ePrismatic:
-                                if(Vector3(jVelocity,0,0).length() > simManager->icLinTolerance * Scalar(100.))
-                                    objectsSettled = false;
-                                break;
-                                
-                            default:
-                                break;
-                        }
-                        
-                        if(!objectsSettled)
+                        case btMultibodyLink::eRevolute:
+                            if(Vector3(jVelocity,0,0).length() > simManager->icAngTolerance * Scalar(100.))
+                                objectsSettled = false;
+                            break;
+                            
+                        case btMultibodyLink::ePrismatic:
+                            if(Vector3(jVelocity,0,0).length() > simManager->icLinTolerance * Scalar(100.))
+                                objectsSettled = false;
+                            break;
+                            
+                        default:
                             break;
                     }
+                    
+                    if(!objectsSettled)
+                        break;
                 }
             }
         }
@@ -1459,62 +1648,61 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
     mbDynamicsWorld->clearForces(); //Includes clearing of multibody forces!
         
     //loop through all actuators -> apply forces to bodies (free and connected by joints)
+    simManager->perfMon.PhaseStarted(PerformancePhase::ACTUATORS);
     for(size_t i = 0; i < simManager->actuators.size(); ++i)
         simManager->actuators[i]->Update(timeStep);
+    simManager->perfMon.PhaseFinished(PerformancePhase::ACTUATORS);
     
     //loop through all joints -> apply damping forces to bodies connected by joints
+    simManager->perfMon.PhaseStarted(PerformancePhase::JOINT_DAMPING);
     for(size_t i = 0; i < simManager->joints.size(); ++i)
         simManager->joints[i]->ApplyDamping();
+    simManager->perfMon.PhaseFinished(PerformancePhase::JOINT_DAMPING);
+    
+    //loop through all dynamic entities -> apply gravity (and damping of multibodies)
+    simManager->perfMon.PhaseStarted(PerformancePhase::GRAVITY);
+    Vector3 gravity = mbDynamicsWorld->getGravity();
+    for(size_t i = 0; i < simManager->solids.size(); ++i)
+        simManager->solids[i]->ApplyGravity(gravity);
+    for(size_t i = 0; i < simManager->multibodies.size(); ++i)
+    {
+        simManager->multibodies[i]->ApplyGravity(gravity);
+        simManager->multibodies[i]->ApplyDamping();
+    }
+    simManager->perfMon.PhaseFinished(PerformancePhase::GRAVITY);
     
-    //loop through all entities that may need special actions
-    for(size_t i = 0; i < simManager->entities.size(); ++i)
+    //loop through all tiled terrains -> stream tiles
+    simManager->perfMon.PhaseStarted(PerformancePhase::TERRAIN);
+    for(size_t i = 0; i < simManager->terrains.size(); ++i)
+        simManager->terrains[i]->UpdateTiles(world);
+    simManager->perfMon.PhaseFinished(PerformancePhase::TERRAIN);
+    
+    //loop through all triggers -> update state
+    simManager->perfMon.PhaseStarted(PerformancePhase::TRIGGERS);
+    for(size_t i = 0; i < simManager->triggers.size(); ++i)
     {
-        Entity* ent = simManager->entities[i];
-        
-        if(ent->getType() == EntityType::SOLID)
-        {
-            SolidEntity* solid = (SolidEntity*)ent;
-            solid->ApplyGravity(mbDynamicsWorld->getGravity());
-        }
-        else if(ent->getType() == EntityType::FEATHERSTONE)
-        {
-            FeatherstoneEntity* multibody = (FeatherstoneEntity*)ent;
-            multibody->ApplyGravity(mbDynamicsWorld->getGravity());
-            multibody->ApplyDamping();
-        }
-        /*else if(ent->getType() == EntityType::CABLE)
-        {
-            CableEntity* cable = (CableEntity*)ent;
-            cable->ApplyGravity(mbDynamicsWorld->getGravity());
-        }*/
-        else if(ent->getType() == EntityType::FORCEFIELD)
+        Trigger* trigger = simManager->triggers[i];
+        trigger->Clear();
+        btBroadphasePairArray& pairArray = trigger->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
+        int numPairs = pairArray.size();
+            
+        for(int h = 0; h < numPairs; ++h)
         {
-            ForcefieldEntity* ff = (ForcefieldEntity*)ent;
-            if(ff->getForcefieldType() == ForcefieldType::TRIGGER)
-            {				
-                Trigger* trigger = (Trigger*)ff;
-                trigger->Clear();
-                btBroadphasePairArray& pairArray = trigger->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
-                int numPairs = pairArray.size();
-                    
-                for(int h = 0; h < numPairs; ++h)
-                {
-                    const btBroadphasePair& pair = pairArray[h];
-                    btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
-                    if(!colPair)
-                        continue;
-                    
-                    btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
-                    btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
-                
-                    if(co1 == trigger->getGhost())
-                        trigger->Activate(co2);
-                    else if(co2 == trigger->getGhost())
-                        trigger->Activate(co1);
-                }
-            }
+            const btBroadphasePair& pair = pairArray[h];
+            btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
+            if(!colPair)
+                continue;
+            
+            btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
+            btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
+        
+            if(co1 == trigger->getGhost())
+                trigger->Activate(co2);
+            else if(co2 == trigger->getGhost())
+                trigger->Activate(co1);
         }
     }
+    simManager->perfMon.PhaseFinished(PerformancePhase::TRIGGERS);
     
     //Geometry-based forces
     bool recompute = simManager->fdCounter % simManager->fdPrescaler == 0;
@@ -1523,14 +1711,17 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
     //Aerodynamic forces
     if(simManager->atmosphere != nullptr)
     {
+        simManager->perfMon.PhaseStarted(PerformancePhase::AERODYNAMICS);
+        simManager->atmosphere->UpdateVelocityFields(simManager->simulationTime); //Time-dependent velocity fields
         btBroadphasePairArray& pairArray = simManager->atmosphere->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
         int numPairs = pairArray.size();
         
         if(numPairs > 0)
         {
-            #pragma omp parallel for schedule(dynamic)
+            #pragma omp parallel for schedule(dynamic) if(false) //Serial until the fluid force computation is made thread-safe
             for(int h=0; h<numPairs; ++h)
             {
+                TraceScope trace("Aerodynamic forces", "fluid");
                 const btBroadphasePair& pair = pairArray[h];
                 btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
                 if (!colPair)
@@ -1541,26 +1732,29 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
                 
                 if(co1 == simManager->atmosphere->getGhost())
                     simManager->atmosphere->ApplyFluidForces(world, co2, recompute);
-                else if(co2 == simManager->ocean->getGhost())
+                else if(co2 == simManager->atmosphere->getGhost())
                     simManager->atmosphere->ApplyFluidForces(world, co1, recompute);
             }
         }
+        simManager->perfMon.PhaseFinished(PerformancePhase::AERODYNAMICS);
     }
     
     //Hydrodynamic forces
     if(simManager->ocean != nullptr)
     {
-        if(recompute) SDL_LockMutex(simManager->simHydroMutex);
         simManager->perfMon.HydrodynamicsStarted();
+        simManager->ocean->UpdateVelocityFields(simManager->simulationTime); //Time-dependent velocity fields
+        if(recompute) SDL_LockMutex(simManager->simHydroMutex);
         
         btBroadphasePairArray& pairArray = simManager->ocean->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
         int numPairs = pairArray.size();
         
         if(numPairs > 0)
         {
-            #pragma omp parallel for schedule(dynamic)
+            #pragma omp parallel for schedule(dynamic) if(false) //Serial until the fluid force computation is made thread-safe
             for(int h=0; h<numPairs; ++h)
             {
+                TraceScope trace("Hydrodynamic forces", "fluid");
                 const btBroadphasePair& pair = pairArray[h];
                 btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
                 if (!colPair)
@@ -1570,9 +1764,9 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
                 btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
                 
                 if(co1 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co2, recompute);
+                    simManager->ocean->ApplyFluidForces(world, co2, recompute, simManager->fdAdaptive);
                 else if(co2 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co1, recompute);
+                    simManager->ocean->ApplyFluidForces(world, co1, recompute, simManager->fdAdaptive);
             }
         }
         
@@ -1587,43 +1781,33 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
     SimulationManager* simManager = (SimulationManager*)world->getWorldUserInfo();
     
     //Update motion data
-    for(size_t i = 0; i < simManager->entities.size(); ++i)
-    {
-        Entity* ent = simManager->entities[i];
-            
-        if(ent->getType() == EntityType::SOLID)
-        {
-            SolidEntity* solid = (SolidEntity*)ent;
-            solid->UpdateAcceleration(timeStep);
-        }
-        else if(ent->getType() == EntityType::FEATHERSTONE)
-        {
-            FeatherstoneEntity* fe = (FeatherstoneEntity*)ent;
-            fe->UpdateAcceleration(timeStep);
-        }
-        else if(ent->getType() == EntityType::ANIMATED)
-        {
-            AnimatedEntity* anim = (AnimatedEntity*)ent;
-            anim->Update(timeStep);
-        }
-    }
+    for(size_t i = 0; i < simManager->solids.size(); ++i)
+        simManager->solids[i]->UpdateAcceleration(timeStep);
+    for(size_t i = 0; i < simManager->multibodies.size(); ++i)
+        simManager->multibodies[i]->UpdateAcceleration(timeStep);
+    for(size_t i = 0; i < simManager->animated.size(); ++i)
+        simManager->animated[i]->Update(timeStep);
 
     //Special treatment of suction cup actuator
-    for(size_t i = 0; i < simManager->actuators.size(); ++i)
-        if(simManager->actuators[i]->getType() == ActuatorType::SUCTION_CUP)
-            ((SuctionCup*)simManager->actuators[i])->Engage(simManager);
+    for(size_t i = 0; i < simManager->suctionCups.size(); ++i)
+        simManager->suctionCups[i]->Engage(simManager);
 
     //Loop through all sensors -> update measurements
+    simManager->perfMon.PhaseStarted(PerformancePhase::SENSORS);
     for(size_t i = 0; i < simManager->sensors.size(); ++i)
         simManager->sensors[i]->Update(timeStep);
+    simManager->perfMon.PhaseFinished(PerformancePhase::SENSORS);
         
     //Loop through all comms -> update state and measurements
+    simManager->perfMon.PhaseStarted(PerformancePhase::COMMS);
     for(size_t i = 0; i < simManager->comms.size(); ++i)
         simManager->comms[i]->Update(timeStep);
+    simManager->perfMon.PhaseFinished(PerformancePhase::COMMS);
     
     //Loop through contact manifolds -> update contacts
-    if(simManager->getContact(0) != nullptr) // If at least one contact is defined
+    if(simManager->contacts.size() > 0) // If at least one contact is defined
     {
+        simManager->perfMon.PhaseStarted(PerformancePhase::CONTACTS);
         int numManifolds = world->getDispatcher()->getNumManifolds();
         for(int i=0; i<numManifolds; ++i)
         {
@@ -1636,6 +1820,9 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
             if(contact != nullptr && contactManifold->getNumContacts() > 0)
                 contact->AddContactPoint(contactManifold, contact->getEntityA() != entA, timeStep);        
         }
+        for(size_t i = 0; i < simManager->contacts.size(); ++i)
+            simManager->contacts[i]->StepCompleted(simManager->simulationTime);
+        simManager->perfMon.PhaseFinished(PerformancePhase::CONTACTS);
     }
 
     //Update simulation time
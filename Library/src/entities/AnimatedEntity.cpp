@@ -29,6 +29,7 @@
 #include "core/SimulationManager.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "utils/MeshCache.h"
 
 namespace sf
 {
@@ -131,9 +132,9 @@ AnimatedEntity::AnimatedEntity(std::string uniqueName, Trajectory* traj, std::st
     if(traj == nullptr)
         return;
 
-    //Load geometry from files
-    Mesh* graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false);
-    Mesh* phyMesh;
+    //Load geometry from files (shared with the mesh cache)
+    std::shared_ptr<const Mesh> graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false);
+    std::shared_ptr<const Mesh> phyMesh;
     T_O2G = graphicsOrigin;
     T_CG2O = I4();
     
@@ -149,34 +150,24 @@ AnimatedEntity::AnimatedEntity(std::string uniqueName, Trajectory* traj, std::st
     }
 
     //Build rigid body
-    btConvexHullShape* shape = new btConvexHullShape();
-    for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
+    std::shared_ptr<const std::vector<Vector3>> hull = MeshCache::GetConvexHull(phyMesh.get());
+    if(hull->empty())
     {
-        glm::vec3 pos = phyMesh->getVertexPos(i);
-        Vector3 v(pos.x, pos.y, pos.z);
-        shape->addPoint(v);
+        cError("Failed to build the collision shape of '%s' (empty mesh)!", getName().c_str());
+        BuildRigidBody(new btEmptyShape(), false);
     }
-    shape->optimizeConvexHull();
-    BuildRigidBody(shape, collides);
+    else
+        BuildRigidBody(new btConvexHullShape(&(*hull)[0].x(), (int)hull->size(), sizeof(Vector3)), collides);
 
     //Build graphical objects
     if(SimulationApp::getApp()->hasGraphics())
     { 
-        phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
+        phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh.get());
         if(graMesh != phyMesh)
-            graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(graMesh);
+            graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(graMesh.get());
         else
             graObjectId = phyObjectId;
     }
-
-    //Delete mesh data
-    if(graMesh != phyMesh)
-    {
-        delete phyMesh;
-        delete graMesh;
-    }
-    else
-        delete phyMesh;
 }
 
 AnimatedEntity::~AnimatedEntity()
@@ -58,5 +58,9 @@ std::string Entity::getName() const
 {
     return name;
 }
-        
+
+void Entity::getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics)
+{
+}
+
 }
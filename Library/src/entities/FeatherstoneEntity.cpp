@@ -69,6 +69,12 @@ EntityType FeatherstoneEntity::getType() const
     return EntityType::FEATHERSTONE;
 }
 
+void FeatherstoneEntity::getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics)
+{
+    for(size_t i = 0; i < links.size(); ++i)
+        links[i].solid->getMeshes(graphics, physics);
+}
+
 void FeatherstoneEntity::getAABB(Vector3& min, Vector3& max)
 {
     //Initialize AABB
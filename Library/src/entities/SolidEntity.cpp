@@ -30,6 +30,8 @@
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/MeshCache.h"
+#include "utils/PerformanceMonitor.h"
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
 #include <iostream>
@@ -92,11 +94,20 @@ SolidEntity::SolidEntity(std::string uniqueName, BodyPhysicsSettings phy, std::s
     lastV.setZero();
     lastOmega.setZero();
     linearAcc.setZero();
+    hydroCached = false;
+    hydroSkipped = 0;
+    hydroT = Transform::getIdentity();
+    hydroV.setZero();
+    hydroOmega.setZero();
+    hydroBf = BodyFluidPosition::OUTSIDE;
+    hydroBfFresh = false;
+    hydroCounters = nullptr;
     angularAcc.setZero();
+    ResetFluidDynamicsCost();
+    useLOD = false;
     
     //Set pointers
     multibodyCollider = nullptr;
-    phyMesh = nullptr;
     graObjectId = -1;
     phyObjectId = -1;
     dm = DisplayMode::GRAPHICAL;
@@ -106,8 +117,6 @@ SolidEntity::SolidEntity(std::string uniqueName, BodyPhysicsSettings phy, std::s
 
 SolidEntity::~SolidEntity()
 {
-    if(phyMesh != nullptr) 
-        delete phyMesh;
 }
 
 EntityType SolidEntity::getType() const
@@ -200,6 +209,59 @@ bool SolidEntity::isBuoyant() const
 {
     return (phy.mode == BodyPhysicsMode::SUBMERGED || phy.mode == BodyPhysicsMode::FLOATING) && phy.buoyancy;
 }
+
+FluidDynamicsCost SolidEntity::getFluidDynamicsCost() const
+{
+    FluidDynamicsCost cost;
+    cost.hydroEvaluations = fdcHydroEvaluations.load(std::memory_order_relaxed);
+    cost.hydroReused = fdcHydroReused.load(std::memory_order_relaxed);
+    cost.aeroEvaluations = fdcAeroEvaluations.load(std::memory_order_relaxed);
+    cost.faces = fdcFaces.load(std::memory_order_relaxed);
+    cost.hydroTime = fdcHydroTime.load(std::memory_order_relaxed);
+    cost.aeroTime = fdcAeroTime.load(std::memory_order_relaxed);
+    cost.inside = fdcPosition[(size_t)BodyFluidPosition::INSIDE].load(std::memory_order_relaxed);
+    cost.outside = fdcPosition[(size_t)BodyFluidPosition::OUTSIDE].load(std::memory_order_relaxed);
+    cost.crossing = fdcPosition[(size_t)BodyFluidPosition::CROSSING_SURFACE].load(std::memory_order_relaxed);
+    return cost;
+}
+
+void SolidEntity::ResetFluidDynamicsCost()
+{
+    fdcHydroEvaluations = 0;
+    fdcHydroReused = 0;
+    fdcAeroEvaluations = 0;
+    fdcFaces = 0;
+    fdcHydroTime = 0.0;
+    fdcAeroTime = 0.0;
+    for(size_t i=0; i<3; ++i)
+        fdcPosition[i] = 0;
+}
+
+void SolidEntity::setHydrodynamicsCounters(HydrodynamicsCounters* counters)
+{
+    hydroCounters = counters;
+}
+
+void SolidEntity::AddFluidDynamicsTime(double us, bool aerodynamics)
+{
+    //Only one thread computes the forces of a body, so the counters do not need atomic read-modify-write
+    std::atomic<double>& t = aerodynamics ? fdcAeroTime : fdcHydroTime;
+    t.store(t.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+}
+
+void SolidEntity::CountHydrodynamicsEvaluation(BodyFluidPosition bf, size_t faces)
+{
+    fdcHydroEvaluations.store(fdcHydroEvaluations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    fdcFaces.store(fdcFaces.load(std::memory_order_relaxed) + faces, std::memory_order_relaxed);
+    std::atomic<unsigned long long>& pos = fdcPosition[(size_t)bf];
+    pos.store(pos.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void SolidEntity::CountAerodynamicsEvaluation(size_t faces)
+{
+    fdcAeroEvaluations.store(fdcAeroEvaluations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    fdcFaces.store(fdcFaces.load(std::memory_order_relaxed) + faces, std::memory_order_relaxed);
+}
     
 BodyPhysicsMode SolidEntity::getBodyPhysicsMode() const
 {
@@ -219,6 +281,14 @@ void SolidEntity::getAABB(Vector3& min, Vector3& max)
     }
 }
 
+void SolidEntity::getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics)
+{
+    if(phyMesh != nullptr)
+        physics.push_back(phyMesh.get());
+    if(phyMeshLOD != nullptr)
+        physics.push_back(phyMeshLOD.get());
+}
+
 std::vector<Renderable> SolidEntity::Render()
 {
     std::vector<Renderable> items(0);
@@ -648,7 +718,42 @@ void SolidEntity::getGeometryApprox(GeometryApproxType& type, std::vector<Scalar
 
 const Mesh* SolidEntity::getPhysicsMesh()
 {
-    return phyMesh;
+    return useLOD ? phyMeshLOD.get() : phyMesh.get();
+}
+
+const MeshFaceData& SolidEntity::getPhysicsFaceData()
+{
+    return useLOD ? phyFacesLOD : phyFaces;
+}
+
+bool SolidEntity::setPhysicsMeshLOD(bool enabled)
+{
+    if(enabled == useLOD)
+        return true;
+    
+    if(enabled)
+    {
+        if(phyMeshLOD == nullptr)
+        {
+            if((phyMeshLOD = BuildPhysicsMeshLOD()) == nullptr)
+                return false;
+            BuildFaceData(phyMeshLOD.get(), phyFacesLOD);
+        }
+    }
+    
+    useLOD = enabled;
+    hydroCached = false; //Forces computed with the other mesh cannot be reused
+    return true;
+}
+
+bool SolidEntity::isUsingPhysicsMeshLOD() const
+{
+    return useLOD;
+}
+
+std::shared_ptr<const Mesh> SolidEntity::BuildPhysicsMeshLOD()
+{
+    return nullptr; //No coarse version by default
 }
 
 std::vector<Vector3>* SolidEntity::getMeshVertices() const
@@ -667,6 +772,9 @@ std::vector<Vector3>* SolidEntity::getMeshVertices() const
 
 void SolidEntity::ComputeFluidDynamicsApprox(GeometryApproxType t)
 {
+    //Face data used by the aerodynamics, built once together with the physics mesh
+    BuildFaceData(phyMesh.get(), phyFaces);
+    
     switch(t)
     {
         case  GeometryApproxType::SPHERE:
@@ -821,9 +929,64 @@ void SolidEntity::ComputeEllipsoidalApprox()
 #ifdef DEBUG
     cInfo("---- Computing ellipsoidal approximation of geometry for %s ----", getName().c_str());
 #endif
+    //Fitting is expensive, reuse results for meshes shared through the mesh cache
+    Vector3 d;
+    if(!MeshCache::FindEllipsoid(phyMesh.get(), T_CG2C, P_CB, d))
+    {
+        if(!FitEllipsoid(d))
+            return;
+        MeshCache::StoreEllipsoid(phyMesh.get(), T_CG2C, P_CB, d);
+    }
+#ifdef DEBUG
+    cInfo("Ellipsoid axis: %1.3lf %1.3lf %1.3lf", d.x(), d.y(), d.z());
+#endif
+
+    fdApproxType =  GeometryApproxType::ELLIPSOID;
+    fdApproxParams.resize(3);
+    fdApproxParams[0] = d.getX();
+    fdApproxParams[1] = d.getY();
+    fdApproxParams[2] = d.getZ();
+    
+    //Compute added mass
+    Scalar rho = Scalar(1000);
+    Ocean* ocn;
+    if((ocn = SimulationApp::getApp()->getSimulationManager()->getOcean()) != nullptr)
+        rho = ocn->getLiquid().density;
+
+    Scalar r12 = (fdApproxParams[1] + fdApproxParams[2])/Scalar(2);
+    aMass.setX(LambKFactor(fdApproxParams[0], r12)*Scalar(4)/Scalar(3)*M_PI*rho*fdApproxParams[0]*r12*r12);
+    aMass.setY(Scalar(4)/Scalar(3)*M_PI*rho*fdApproxParams[2]*fdApproxParams[2]*fdApproxParams[0]);
+    aMass.setZ(Scalar(4)/Scalar(3)*M_PI*rho*fdApproxParams[1]*fdApproxParams[1]*fdApproxParams[0]);
+    aI.setX(0); //THIS SHOULD BE > 0
+    aI.setY(Scalar(1)/Scalar(12)*M_PI*rho*fdApproxParams[1]*fdApproxParams[1]*btPow(fdApproxParams[0], Scalar(3)));
+    aI.setZ(Scalar(1)/Scalar(12)*M_PI*rho*fdApproxParams[2]*fdApproxParams[2]*btPow(fdApproxParams[0], Scalar(3)));
+    
+    //Set transform with respect to geometry
+    Transform ellipsoidTransform;
+    ellipsoidTransform.getBasis().setIdentity(); //Aligned with CG frame (for now)
+    ellipsoidTransform.setOrigin(P_CB);
+    T_CG2H = ellipsoidTransform;
+
+    Vector3 Cd(Scalar(1)/fdApproxParams[0] , Scalar(1)/fdApproxParams[1], Scalar(1)/fdApproxParams[2]);
+    Scalar maxCd = btMax(btMax(Cd.x(), Cd.y()), Cd.z());
+    Cd /= maxCd;
+    Cd = T_CG2O.getBasis().inverse() * Cd; // To origin frame
+    Cd = Vector3(btFabs(Cd.getX()), btFabs(Cd.getY()), btFabs(Cd.getZ()));
+    SetHydrodynamicCoefficients(Cd, Scalar(0.1)*Cd);
+
+#ifdef DEBUG
+    cInfo("--------------------------------------------------------------------");
+#endif
+}
+
+bool SolidEntity::FitEllipsoid(Vector3& axes)
+{
     std::vector<Vector3>* x = getMeshVertices();
     if(x->size() < 2)
-        return;
+    {
+        delete x;
+        return false;
+    }
     for(size_t i=0; i<x->size(); ++i)
         x->at(i) = T_CG2C * x->at(i) - P_CB; //Points in CG frame around center of buoyancy
     
@@ -951,47 +1114,12 @@ void SolidEntity::ComputeEllipsoidalApprox()
     }
 #ifdef DEBUG
     cInfo("Ellipsoid center: %1.3lf %1.3lf %1.3lf", c.x(), c.y(), c.z());
-    cInfo("Ellipsoid axis: %1.3lf %1.3lf %1.3lf", d.x(), d.y(), d.z());
     cInfo("Ellipsoid core points: %d", x0.size());
 #endif
     
-    fdApproxType =  GeometryApproxType::ELLIPSOID;
-    fdApproxParams.resize(3);
-    fdApproxParams[0] = d.getX();
-    fdApproxParams[1] = d.getY();
-    fdApproxParams[2] = d.getZ();
-    
-    //Compute added mass
-    Scalar rho = Scalar(1000);
-    Ocean* ocn;
-    if((ocn = SimulationApp::getApp()->getSimulationManager()->getOcean()) != nullptr)
-        rho = ocn->getLiquid().density;
-
-    Scalar r12 = (fdApproxParams[1] + fdApproxParams[2])/Scalar(2);
-    aMass.setX(LambKFactor(fdApproxParams[0], r12)*Scalar(4)/Scalar(3)*M_PI*rho*fdApproxParams[0]*r12*r12);
-    aMass.setY(Scalar(4)/Scalar(3)*M_PI*rho*fdApproxParams[2]*fdApproxParams[2]*fdApproxParams[0]);
-    aMass.setZ(Scalar(4)/Scalar(3)*M_PI*rho*fdApproxParams[1]*fdApproxParams[1]*fdApproxParams[0]);
-    aI.setX(0); //THIS SHOULD BE > 0
-    aI.setY(Scalar(1)/Scalar(12)*M_PI*rho*fdApproxParams[1]*fdApproxParams[1]*btPow(fdApproxParams[0], Scalar(3)));
-    aI.setZ(Scalar(1)/Scalar(12)*M_PI*rho*fdApproxParams[2]*fdApproxParams[2]*btPow(fdApproxParams[0], Scalar(3)));
-    
-    //Set transform with respect to geometry
-    Transform ellipsoidTransform;
-    ellipsoidTransform.getBasis().setIdentity(); //Aligned with CG frame (for now)
-    ellipsoidTransform.setOrigin(P_CB);
-    T_CG2H = ellipsoidTransform;
-
-    Vector3 Cd(Scalar(1)/fdApproxParams[0] , Scalar(1)/fdApproxParams[1], Scalar(1)/fdApproxParams[2]);
-    Scalar maxCd = btMax(btMax(Cd.x(), Cd.y()), Cd.z());
-    Cd /= maxCd;
-    Cd = T_CG2O.getBasis().inverse() * Cd; // To origin frame
-    Cd = Vector3(btFabs(Cd.getX()), btFabs(Cd.getY()), btFabs(Cd.getZ()));
-    SetHydrodynamicCoefficients(Cd, Scalar(0.1)*Cd);
-
-#ifdef DEBUG
-    cInfo("--------------------------------------------------------------------");
-#endif
+    axes = d;
     delete x;
+    return true;
 }
 
 Scalar SolidEntity::LambKFactor(Scalar r1, Scalar r2)
@@ -1013,7 +1141,7 @@ void SolidEntity::BuildGraphicalObject()
     if(phyMesh == nullptr || !SimulationApp::getApp()->hasGraphics())
         return;
         
-    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
+    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh.get());
     phyObjectId = graObjectId;
 }
 
@@ -1207,6 +1335,11 @@ BodyFluidPosition SolidEntity::CheckBodyFluidPosition(Ocean* ocn)
 {
     Vector3 aabbMin, aabbMax;
     getAABB(aabbMin, aabbMax);
+    return CheckBodyFluidPosition(ocn, aabbMin, aabbMax);
+}
+
+BodyFluidPosition SolidEntity::CheckBodyFluidPosition(Ocean* ocn, const Vector3& aabbMin, const Vector3& aabbMax)
+{
     Vector3 d = aabbMax-aabbMin;
     
     unsigned int underwater = 0;
@@ -1227,6 +1360,58 @@ BodyFluidPosition SolidEntity::CheckBodyFluidPosition(Ocean* ocn)
         return BodyFluidPosition::CROSSING_SURFACE;
 }
 
+BodyFluidPosition SolidEntity::GetBodyFluidPosition(Ocean* ocn)
+{
+    //Reuse the position checked when deciding about the recomputation
+    if(hydroBfFresh)
+    {
+        hydroBfFresh = false;
+        return hydroBf;
+    }
+    return CheckBodyFluidPosition(ocn);
+}
+
+bool SolidEntity::CheckHydrodynamicsRecompute(const AdaptiveHydrodynamicsSettings& settings, Ocean* ocn)
+{
+    //Current state
+    Transform T = getCGTransform();
+    Vector3 v = getLinearVelocity() - ocn->GetFluidVelocity(T.getOrigin()); //Relative to fluid
+    Vector3 omega = getAngularVelocity();
+    Vector3 aabbMin, aabbMax;
+    getAABB(aabbMin, aabbMax);
+    BodyFluidPosition bf = CheckBodyFluidPosition(ocn, aabbMin, aabbMax);
+    Scalar linTol = settings.linearTolerance * Scalar(0.5) * (aabbMax - aabbMin).length(); //Relative to body size
+    
+    bool recompute = !hydroCached
+                     || hydroSkipped >= settings.maxSkipped
+                     || bf != hydroBf
+                     || (bf == BodyFluidPosition::CROSSING_SURFACE && ocn->hasWaves()) //Surface moves on its own
+                     || (T.getOrigin() - hydroT.getOrigin()).length() > linTol
+                     || (v - hydroV).length() > linTol
+                     || (omega - hydroOmega).length() > settings.angularTolerance
+                     || T.getRotation().angleShortestPath(hydroT.getRotation()) > settings.angularTolerance;
+    
+    if(recompute)
+    {
+        hydroCached = true;
+        hydroSkipped = 0;
+        hydroT = T;
+        hydroV = v;
+        hydroOmega = omega;
+        hydroBf = bf;
+        hydroBfFresh = true;
+    }
+    else
+    {
+        ++hydroSkipped;
+        fdcHydroReused.store(fdcHydroReused.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    if(hydroCounters != nullptr)
+        hydroCounters->Count(recompute);
+    return recompute;
+}
+
 void SolidEntity::CorrectHydrodynamicForces(Ocean* ocn, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fdf, Vector3& _Tdf)
 {
     Vector3 Fdq = getOTransform().getBasis().inverse() * _Fdq; // In origin frame
@@ -1299,6 +1484,10 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     glm::vec3 p0 = p; //Point used as a center of mesh for volume calculation.
     p0.z = 0.f;       //When the robot is far from the world origin numerical erros would explode without translating the mesh data!
     
+    //Spatially uniform flow --> fluid velocity hoisted out of the face loop
+    bool uniformFlow = ocn->isFlowUniform();
+    glm::vec3 vf = uniformFlow ? ocn->GetFluidVelocity(p) : glm::vec3(0.f);
+    
     //Loop through all faces...
     for(size_t i=0; i<mesh->faces.size(); ++i)
     {
@@ -1626,7 +1815,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
         //Damping force
         if(settings.dampingForces)
         {
-            glm::vec3 vc = ocn->GetFluidVelocity(fc) - (v + glm::cross(omega, fc-p));
+            glm::vec3 vc = (uniformFlow ? vf : ocn->GetFluidVelocity(fc)) - (v + glm::cross(omega, fc-p));
             GLfloat vc_n = glm::dot(vc, fn1);
             glm::vec3 vn = vc_n  * fn1; //Normal velocity
             glm::vec3 vt = vc - vn; //Tangent velocity
@@ -1710,6 +1899,10 @@ void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* oc
     
     //Calculate fluid dynamics forces and torques
     glm::vec3 p = glm::vec3(TCG[3]);
+    
+    //Spatially uniform flow --> fluid velocity hoisted out of the face loop
+    bool uniformFlow = ocn->isFlowUniform();
+    glm::vec3 vf = uniformFlow ? ocn->GetFluidVelocity(p) : glm::vec3(0.f);
 
     //Loop through all faces...
     for(size_t i=0; i<mesh->faces.size(); ++i)
@@ -1734,7 +1927,7 @@ void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* oc
         glm::vec3 fc = (p1+p2+p3)/3.f; //Face centroid
      
         //Forces
-        glm::vec3 vc = ocn->GetFluidVelocity(fc) - (v + glm::cross(omega, fc-p));
+        glm::vec3 vc = (uniformFlow ? vf : ocn->GetFluidVelocity(fc)) - (v + glm::cross(omega, fc-p));
         GLfloat vc_n = glm::dot(vc, fn1);
         glm::vec3 vn = vc_n  * fn1; //Normal velocity
         glm::vec3 vt = vc - vn; //Tangent velocity
@@ -1764,11 +1957,17 @@ void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* oc
 
 void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn)
 {
-    if(phy.mode != BodyPhysicsMode::FLOATING && phy.mode != BodyPhysicsMode::SUBMERGED) return;
+    if(phy.mode != BodyPhysicsMode::FLOATING && phy.mode != BodyPhysicsMode::SUBMERGED)
+    {
+        hydroBfFresh = false;
+        return;
+    }
     
     submerged.points.clear();
 
-    BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
+    BodyFluidPosition bf = GetBodyFluidPosition(ocn);
+
+    CountHydrodynamicsEvaluation(bf, bf == BodyFluidPosition::OUTSIDE ? 0 : getPhysicsMesh()->faces.size());
     
     //If completely outside fluid just set all torques and forces to 0
     if(bf == BodyFluidPosition::OUTSIDE)
@@ -1822,68 +2021,164 @@ void SolidEntity::ComputeAerodynamicForces(Atmosphere* atm)
     Vector3 omega = getAngularVelocity();
     
     //Compute drag
-    ComputeAerodynamicForces(getPhysicsMesh(), atm, getCGTransform(), getCTransform(), v, omega, Fda, Tda);
+    const MeshFaceData& faces = getPhysicsFaceData();
+    CountAerodynamicsEvaluation(faces.area.size());
+    ComputeAerodynamicForces(faces, atm, getCGTransform(), getCTransform(), v, omega, Fda, Tda);
     CorrectAerodynamicForces(atm, Fda, Tda);
 }
 
 void SolidEntity::ComputeAerodynamicForces(const Mesh* mesh, Atmosphere* atm, const Transform& T_CG, const Transform& T_C,
                                            const Vector3& _v, const Vector3& _omega, Vector3& _Fda, Vector3& _Tda)
 {
-    if(mesh == nullptr) 
+    MeshFaceData faces;
+    BuildFaceData(mesh, faces);
+    ComputeAerodynamicForces(faces, atm, T_CG, T_C, _v, _omega, _Fda, _Tda);
+}
+
+void SolidEntity::BuildFaceData(const Mesh* mesh, MeshFaceData& faces)
+{
+    faces = MeshFaceData();
+    if(mesh == nullptr)
+        return;
+    
+    size_t n = mesh->faces.size();
+    faces.cx.reserve(n);
+    faces.cy.reserve(n);
+    faces.cz.reserve(n);
+    faces.nx.reserve(n);
+    faces.ny.reserve(n);
+    faces.nz.reserve(n);
+    faces.area.reserve(n);
+    
+    for(size_t i=0; i<n; ++i)
+    {
+        glm::vec3 p1 = mesh->getVertexPos(i, 0);
+        glm::vec3 p2 = mesh->getVertexPos(i, 1);
+        glm::vec3 p3 = mesh->getVertexPos(i, 2);
+        glm::vec3 fn = glm::cross(p2-p1, p3-p1); //Normal of the face (length != 1)
+        GLfloat len = glm::length2(fn);
+        if(len < 1e-12f) continue;
+        len = glm::sqrt(len);
+        fn /= len;
+        glm::vec3 fc = (p1+p2+p3)/3.f;
+        
+        faces.cx.push_back(fc.x);
+        faces.cy.push_back(fc.y);
+        faces.cz.push_back(fc.z);
+        faces.nx.push_back(fn.x);
+        faces.ny.push_back(fn.y);
+        faces.nz.push_back(fn.z);
+        faces.area.push_back(len/2.f);
+    }
+    
+    faces.vrx.resize(faces.area.size());
+    faces.vry.resize(faces.area.size());
+    faces.vrz.resize(faces.area.size());
+}
+
+//Pressure drag coefficient of a face (non-zero only if air is approaching the surface)
+static inline GLfloat FacePressureDrag(GLfloat vcx, GLfloat vcy, GLfloat vcz, GLfloat nx, GLfloat ny, GLfloat nz, GLfloat area)
+{
+    GLfloat vcn = vcx * nx + vcy * ny + vcz * nz; //Normal velocity
+    return vcn < -1e-12f ? -vcn * vcn * area : 0.f;
+}
+
+void SolidEntity::ComputeAerodynamicForces(const MeshFaceData& faces, Atmosphere* atm, const Transform& T_CG, const Transform& T_C,
+                                           const Vector3& _v, const Vector3& _omega, Vector3& _Fda, Vector3& _Tda)
+{
+    size_t n = faces.area.size();
+    if(n == 0)
     {
         _Fda.setZero();
         _Tda.setZero();
         return;
     }
     
-    glm::vec3 Fda(0.f);
-    glm::vec3 Tda(0.f);
-    glm::mat4 TCG = glMatrixFromTransform(T_CG);
-    glm::mat4 TC = glMatrixFromTransform(T_C);
-    glm::vec3 v = glVectorFromVector(_v);
-    glm::vec3 omega = glVectorFromVector(_omega);
+    //Computation in the physics mesh frame (no per-face transformation of geometry)
+    Matrix3 Rt = T_C.getBasis().transpose();
+    Vector3 d = Rt * (T_C.getOrigin() - T_CG.getOrigin()); //Mesh origin relative to CG
+    Vector3 vb = Rt * _v + (Rt * _omega).cross(d); //Velocity of mesh origin
+    glm::vec3 omega = glVectorFromVector(Rt * _omega);
     
-    //Calculate fluid dynamics forces and torques
-    glm::vec3 p = glm::vec3(TCG[3]);
-
-    //Loop through all faces...
-    for(size_t i=0; i<mesh->faces.size(); ++i)
+    const GLfloat* cx = faces.cx.data();
+    const GLfloat* cy = faces.cy.data();
+    const GLfloat* cz = faces.cz.data();
+    const GLfloat* nx = faces.nx.data();
+    const GLfloat* ny = faces.ny.data();
+    const GLfloat* nz = faces.nz.data();
+    const GLfloat* A = faces.area.data();
+    GLfloat Fx(0.f), Fy(0.f), Fz(0.f);
+    GLfloat Tx(0.f), Ty(0.f), Tz(0.f);
+    
+    //Loop through all faces (separate loops for uniform and non-uniform flow, without branches in their bodies)
+    if(atm->isFlowUniform())
     {
-        //Global coordinates
-        glm::vec3 p1gl = mesh->getVertexPos(i, 0);
-        glm::vec3 p2gl = mesh->getVertexPos(i, 1);
-        glm::vec3 p3gl = mesh->getVertexPos(i, 2);
-        glm::vec3 p1 = glm::vec3(TC * glm::vec4(p1gl, 1.f));
-        glm::vec3 p2 = glm::vec3(TC * glm::vec4(p2gl, 1.f));
-        glm::vec3 p3 = glm::vec3(TC * glm::vec4(p3gl, 1.f));
+        //Fluid velocity relative to mesh origin
+        glm::vec3 vr = glVectorFromVector(Rt * atm->GetFluidVelocity(T_CG.getOrigin()) - vb);
         
-        //Calculate face properties
-        glm::vec3 fv1 = p2-p1; //One side of the face (triangle)
-        glm::vec3 fv2 = p3-p1; //Another side of the face (triangle)
-        glm::vec3 fn = glm::cross(fv1, fv2); //Normal of the face (length != 1)
-        GLfloat len = glm::length2(fn);
-        if(len < 1e-12f) continue;
-        len = glm::sqrt(len);
-        glm::vec3 fn1 = fn/len; //Normalised normal (length = 1)
-        GLfloat A = len/2.f; //Area of the face (triangle)
-        glm::vec3 fc = (p1+p2+p3)/3.f; //Face centroid
-
-        //Damping forces
-        glm::vec3 vc = atm->GetFluidVelocity(fc) - (v + glm::cross(omega, fc-p));
-        glm::vec3 vn = glm::dot(vc, fn1) * fn1; //Normal velocity
+        #pragma omp simd reduction(+:Fx,Fy,Fz,Tx,Ty,Tz)
+        for(size_t i=0; i<n; ++i)
+        {
+            //Relative velocity at face centroid
+            GLfloat vcx = vr.x - (omega.y * cz[i] - omega.z * cy[i]);
+            GLfloat vcy = vr.y - (omega.z * cx[i] - omega.x * cz[i]);
+            GLfloat vcz = vr.z - (omega.x * cy[i] - omega.y * cx[i]);
+            GLfloat q = FacePressureDrag(vcx, vcy, vcz, nx[i], ny[i], nz[i], A[i]);
+            GLfloat fx = q * nx[i];
+            GLfloat fy = q * ny[i];
+            GLfloat fz = q * nz[i];
+            
+            //Accumulate
+            Fx += fx;
+            Fy += fy;
+            Fz += fz;
+            Tx += cy[i] * fz - cz[i] * fy;
+            Ty += cz[i] * fx - cx[i] * fz;
+            Tz += cx[i] * fy - cy[i] * fx;
+        }
+    }
+    else
+    {
+        //Fluid velocity relative to mesh origin, per face (stored in the scratch buffers of the face data)
+        GLfloat* vfx = faces.vrx.data();
+        GLfloat* vfy = faces.vry.data();
+        GLfloat* vfz = faces.vrz.data();
+        for(size_t i=0; i<n; ++i)
+        {
+            Vector3 vfc = Rt * atm->GetFluidVelocity(T_C * Vector3(cx[i], cy[i], cz[i])) - vb;
+            vfx[i] = (GLfloat)vfc.x();
+            vfy[i] = (GLfloat)vfc.y();
+            vfz[i] = (GLfloat)vfc.z();
+        }
         
-        if(glm::dot(fn1, vn) < -1e-12f)
+        #pragma omp simd reduction(+:Fx,Fy,Fz,Tx,Ty,Tz)
+        for(size_t i=0; i<n; ++i)
         {
-            glm::vec3 quadratic = vn * vn.length() * A;
+            //Relative velocity at face centroid
+            GLfloat vcx = vfx[i] - (omega.y * cz[i] - omega.z * cy[i]);
+            GLfloat vcy = vfy[i] - (omega.z * cx[i] - omega.x * cz[i]);
+            GLfloat vcz = vfz[i] - (omega.x * cy[i] - omega.y * cx[i]);
+            GLfloat q = FacePressureDrag(vcx, vcy, vcz, nx[i], ny[i], nz[i], A[i]);
+            GLfloat fx = q * nx[i];
+            GLfloat fy = q * ny[i];
+            GLfloat fz = q * nz[i];
+            
             //Accumulate
-            Fda += quadratic;
-            Tda += glm::cross(fc - p, quadratic);
+            Fx += fx;
+            Fy += fy;
+            Fz += fz;
+            Tx += cy[i] * fz - cz[i] * fy;
+            Ty += cz[i] * fx - cx[i] * fz;
+            Tz += cx[i] * fy - cy[i] * fx;
         }
     }
-
+    
+    //Back to world frame (torque about CG)
+    Vector3 Fb(Fx, Fy, Fz);
+    Vector3 Tb = Vector3(Tx, Ty, Tz) + d.cross(Fb);
     Scalar density = atm->getGas().density;
-    _Fda = Scalar(0.5) * density * Vector3(Fda.x, Fda.y, Fda.z);
-    _Tda = Scalar(0.5) * density * Vector3(Tda.x, Tda.y, Tda.z);
+    _Fda = Scalar(0.5) * density * (T_C.getBasis() * Fb);
+    _Tda = Scalar(0.5) * density * (T_C.getBasis() * Tb);
 }
 
 void SolidEntity::CorrectAerodynamicForces(Atmosphere* atm, Vector3& _Fda, Vector3& _Tda)
@@ -94,6 +94,12 @@ void StaticEntity::getAABB(Vector3& min, Vector3& max)
         rigidBody->getAabb(min, max);
 }
 
+void StaticEntity::getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics)
+{
+    if(phyMesh != nullptr)
+        physics.push_back(phyMesh);
+}
+
 void StaticEntity::setDisplayMode(DisplayMode m)
 {
     dm = m;
@@ -44,6 +44,8 @@ Atmosphere::Atmosphere(std::string uniqueName, Fluid g) : ForcefieldEntity(uniqu
     gas = g;
     wind = std::vector<VelocityField*>(0);
     glAtmosphere = NULL;
+    uniformFlow = true;
+    uniformVelocity = V0();
 }
     
 Atmosphere::~Atmosphere()
@@ -109,6 +111,35 @@ void Atmosphere::SetupSunPosition(Scalar azimuthDeg, Scalar elevationDeg)
 void Atmosphere::AddVelocityField(VelocityField* field)
 {
     wind.push_back(field);
+    UpdateUniformFlow();
+}
+
+void Atmosphere::UpdateVelocityFields(Scalar t)
+{
+    for(size_t i=0; i<wind.size(); ++i)
+        wind[i]->Update(t);
+    UpdateUniformFlow();
+}
+
+void Atmosphere::UpdateUniformFlow()
+{
+    uniformFlow = true;
+    uniformVelocity = V0();
+    
+    for(size_t i=0; i<wind.size(); ++i)
+    {
+        if(wind[i]->getType() != VelocityFieldType::UNIFORM)
+        {
+            uniformFlow = false;
+            break;
+        }
+        uniformVelocity += wind[i]->GetVelocityAtPoint(V0());
+    }
+}
+
+bool Atmosphere::isFlowUniform() const
+{
+    return uniformFlow;
 }
     
 void Atmosphere::GetSunPosition(Scalar &azimuthDeg, Scalar &elevationDeg)
@@ -126,6 +157,9 @@ void Atmosphere::GetSunPosition(Scalar &azimuthDeg, Scalar &elevationDeg)
 
 Vector3 Atmosphere::GetFluidVelocity(const Vector3& point) const
 {
+    if(uniformFlow)
+        return uniformVelocity;
+    
     Vector3 fv(0,0,0);
     for(size_t i=0; i<wind.size(); ++i)
         fv += wind[i]->GetVelocityAtPoint(point);
@@ -169,7 +203,9 @@ void Atmosphere::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co,
     {
         if(recompute)
         {
+            auto start = std::chrono::steady_clock::now();
             ((SolidEntity*)ent)->ComputeAerodynamicForces(this);
+            ((SolidEntity*)ent)->AddFluidDynamicsTime(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count(), true);
         }
         
         ((SolidEntity*)ent)->ApplyAerodynamicForces();
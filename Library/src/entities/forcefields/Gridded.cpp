@@ -0,0 +1,320 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Gridded.cpp
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "entities/forcefields/Gridded.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "core/SimulationApp.h"
+
+namespace sf
+{
+
+//Packing of the time slice index and the interpolation factor into a single word
+static inline uint64_t PackSlices(unsigned int k0, float alpha)
+{
+    uint32_t a;
+    memcpy(&a, &alpha, sizeof(a));
+    return ((uint64_t)a << 32) | (uint64_t)k0;
+}
+
+static inline void UnpackSlices(uint64_t packed, unsigned int& k0, float& alpha)
+{
+    uint32_t a = (uint32_t)(packed >> 32);
+    memcpy(&alpha, &a, sizeof(alpha));
+    k0 = (unsigned int)(packed & 0xFFFFFFFFu);
+}
+
+Gridded::Gridded(const std::string& filename, Scalar timeOffset, bool loop)
+{
+    map = nullptr;
+    mapSize = 0;
+    pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    tOffset = timeOffset;
+    looped = loop;
+    slices = PackSlices(0, 0.f);
+    residentFirst = 1;
+    residentLast = 0;
+
+    //Map file
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+        cCritical("Failed to open gridded velocity field file '%s'!", filename.c_str());
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < 24)
+    {
+        close(fd);
+        cCritical("Gridded velocity field file '%s' is corrupted!", filename.c_str());
+    }
+    mapSize = (size_t)st.st_size;
+    map = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        map = nullptr;
+        cCritical("Failed to map gridded velocity field file '%s'!", filename.c_str());
+    }
+    madvise(map, mapSize, MADV_RANDOM); //Interpolation does not access data sequentially
+
+    //Parse header
+    const char* bytes = (const char*)map;
+    uint32_t header[5];
+    memcpy(header, bytes + 4, sizeof(header));
+    if(strncmp(bytes, "SFVF", 4) != 0 || header[0] != 1)
+        cCritical("Gridded velocity field file '%s' has unsupported format!", filename.c_str());
+    unsigned int nx = header[1];
+    unsigned int ny = header[2];
+    unsigned int nz = header[3];
+    unsigned int nt = header[4];
+    if(nx == 0 || ny == 0 || nz == 0 || nt == 0)
+        cCritical("Gridded velocity field file '%s' defines an empty grid!", filename.c_str());
+
+    size_t coordsOffset = 24;
+    dataOffset = coordsOffset + sizeof(double) * ((size_t)nx + ny + nz + nt);
+    sliceSize = sizeof(float) * 3 * (size_t)nx * ny * nz;
+    if(mapSize < dataOffset + sliceSize * nt)
+        cCritical("Gridded velocity field file '%s' is truncated!", filename.c_str());
+
+    const double* coords = (const double*)(bytes + coordsOffset);
+    SetupAxis(ax, coords, nx);
+    SetupAxis(ay, coords + nx, ny);
+    SetupAxis(az, coords + nx + ny, nz);
+    SetupAxis(at, coords + nx + ny + nz, nt);
+    data = (const float*)(bytes + dataOffset);
+
+    Update(Scalar(0));
+    cInfo("Mapped gridded velocity field %ux%ux%u with %u time slices from '%s'.", nx, ny, nz, nt, filename.c_str());
+}
+
+Gridded::~Gridded()
+{
+    if(map != nullptr)
+        munmap(map, mapSize);
+}
+
+VelocityFieldType Gridded::getType() const
+{
+    return VelocityFieldType::GRIDDED;
+}
+
+void Gridded::getDomain(Vector3& min, Vector3& max) const
+{
+    min = Vector3(ax.c[0], ay.c[0], az.c[0]);
+    max = Vector3(ax.c[ax.n-1], ay.c[ay.n-1], az.c[az.n-1]);
+}
+
+void Gridded::getTimeSpan(Scalar& start, Scalar& end) const
+{
+    start = at.c[0];
+    end = at.c[at.n-1];
+}
+
+void Gridded::SetupAxis(GridAxis& axis, const double* coords, unsigned int n)
+{
+    axis.c = coords;
+    axis.n = n;
+    axis.step = n > 1 ? (coords[n-1] - coords[0])/(double)(n-1) : 0.0;
+    axis.regular = true;
+    for(unsigned int i=1; i<n; ++i)
+    {
+        if(coords[i] <= coords[i-1])
+            cCritical("Gridded velocity field coordinates have to be strictly increasing!");
+        if(std::abs(coords[i] - coords[i-1] - axis.step) > 1e-6 * axis.step)
+            axis.regular = false;
+    }
+}
+
+bool Gridded::FindCell(const GridAxis& axis, Scalar x, unsigned int& i0, unsigned int& i1, Scalar& f) const
+{
+    if(axis.n == 1) //Field constant along this axis
+    {
+        i0 = i1 = 0;
+        f = Scalar(0);
+        return true;
+    }
+
+    if(x < axis.c[0] || x > axis.c[axis.n-1])
+        return false;
+
+    if(axis.regular)
+    {
+        Scalar s = (x - axis.c[0])/axis.step;
+        i0 = std::min((unsigned int)s, axis.n-2);
+    }
+    else
+        i0 = std::min((unsigned int)(std::upper_bound(axis.c, axis.c + axis.n, (double)x) - axis.c) - 1, axis.n-2);
+
+    i1 = i0 + 1;
+    f = (x - axis.c[i0])/(axis.c[i1] - axis.c[i0]);
+    return true;
+}
+
+Vector3 Gridded::SampleSlice(unsigned int k, unsigned int ix[2], unsigned int iy[2], unsigned int iz[2], Scalar fx, Scalar fy, Scalar fz) const
+{
+    const float* slice = data + (size_t)k * sliceSize/sizeof(float);
+    Scalar wx[2] = {Scalar(1)-fx, fx};
+    Scalar wy[2] = {Scalar(1)-fy, fy};
+    Scalar wz[2] = {Scalar(1)-fz, fz};
+    Vector3 v(0,0,0);
+
+    for(unsigned int c=0; c<8; ++c)
+    {
+        unsigned int i = c & 1;
+        unsigned int j = (c >> 1) & 1;
+        unsigned int l = (c >> 2) & 1;
+        Scalar w = wx[i] * wy[j] * wz[l];
+        if(w == Scalar(0))
+            continue;
+        const float* s = slice + 3 * (((size_t)iz[l] * ay.n + iy[j]) * ax.n + ix[i]);
+        if(std::isfinite(s[0]) && std::isfinite(s[1]) && std::isfinite(s[2]))
+            v += w * Vector3(s[0], s[1], s[2]);
+    }
+    return v;
+}
+
+Vector3 Gridded::GetVelocityAtPoint(const Vector3& p) const
+{
+    unsigned int ix[2], iy[2], iz[2];
+    Scalar fx, fy, fz;
+
+    if(!FindCell(ax, p.getX(), ix[0], ix[1], fx)
+       || !FindCell(ay, p.getY(), iy[0], iy[1], fy)
+       || !FindCell(az, p.getZ(), iz[0], iz[1], fz))
+        return Vector3(0,0,0);
+
+    //The slice following k0 is only sampled when interpolating between two slices
+    unsigned int k0;
+    float alpha;
+    UnpackSlices(slices.load(std::memory_order_acquire), k0, alpha);
+    
+    Vector3 v = SampleSlice(k0, ix, iy, iz, fx, fy, fz);
+    if(alpha > 0.f)
+        v = v * (Scalar(1)-alpha) + SampleSlice(k0 + 1, ix, iy, iz, fx, fy, fz) * Scalar(alpha);
+    return v;
+}
+
+void Gridded::Update(Scalar t)
+{
+    //Compute time in data
+    Scalar td = t + tOffset;
+    Scalar tStart = at.c[0];
+    Scalar tEnd = at.c[at.n-1];
+
+    if(looped && tEnd > tStart)
+    {
+        td = std::fmod(td - tStart, tEnd - tStart);
+        if(td < Scalar(0))
+            td += tEnd - tStart;
+        td += tStart;
+    }
+
+    //Find surrounding slices
+    unsigned int k0, k1;
+    Scalar alpha;
+    if(at.n == 1 || td <= tStart)
+    {
+        k0 = k1 = 0;
+        alpha = Scalar(0);
+    }
+    else if(td >= tEnd)
+    {
+        k0 = k1 = at.n-1;
+        alpha = Scalar(0);
+    }
+    else
+    {
+        unsigned int i0, i1;
+        Scalar f;
+        FindCell(at, td, i0, i1, f);
+        k0 = i0;
+        k1 = i1;
+        alpha = f;
+    }
+    slices.store(PackSlices(k0, (float)alpha), std::memory_order_release);
+
+    //Keep the current slices and the next one resident
+    unsigned int last = std::min(k1 + 1, at.n-1);
+    if(k0 != residentFirst || last != residentLast)
+        PageSlices(k0, last);
+}
+
+void Gridded::PageSlices(unsigned int first, unsigned int last)
+{
+    char* base = (char*)map;
+
+    //Release slices that are no longer needed
+    for(unsigned int k=residentFirst; k<=residentLast; ++k)
+    {
+        if(k >= first && k <= last)
+            continue;
+        size_t start = dataOffset + k * sliceSize;
+        size_t end = start + sliceSize;
+        start = (start + pageSize - 1)/pageSize * pageSize; //Do not touch pages shared with neighbours
+        end = end/pageSize * pageSize;
+        if(end > start)
+            madvise(base + start, end - start, MADV_DONTNEED);
+    }
+
+    //Request slices surrounding current time
+    size_t start = (dataOffset + first * sliceSize)/pageSize * pageSize;
+    size_t end = dataOffset + (last + 1) * sliceSize;
+    madvise(base + start, end - start, MADV_WILLNEED);
+
+    residentFirst = first;
+    residentLast = last;
+}
+
+std::vector<Renderable> Gridded::Render(VelocityFieldUBO& ubo)
+{
+    ubo.posR = glm::vec4(0.f);
+    ubo.dirV = glm::vec4(0.f);
+    ubo.params = glm::vec3(0.f);
+    ubo.type = 0;
+
+    //Domain box
+    Vector3 min, max;
+    getDomain(min, max);
+    glm::vec3 c[8];
+    for(unsigned int i=0; i<8; ++i)
+        c[i] = glm::vec3((i & 1) ? max.x() : min.x(), (i & 2) ? max.y() : min.y(), (i & 4) ? max.z() : min.z());
+
+    Renderable box;
+    box.type = RenderableType::HYDRO_LINES;
+    box.model = glm::mat4(1.f);
+    unsigned int edges[24] = {0,1, 2,3, 4,5, 6,7, 0,2, 1,3, 4,6, 5,7, 0,4, 1,5, 2,6, 3,7};
+    for(unsigned int i=0; i<24; ++i)
+        box.points.push_back(c[edges[i]]);
+
+    std::vector<Renderable> items(0);
+    items.push_back(box);
+    return items;
+}
+
+}
@@ -26,6 +26,7 @@
 #include "entities/forcefields/Ocean.h"
 
 #include <algorithm>
+#include <chrono>
 #include "utils/SystemUtil.hpp"
 #include "entities/forcefields/VelocityField.h"
 #include "entities/SolidEntity.h"
@@ -51,6 +52,10 @@ Ocean::Ocean(std::string uniqueName, Scalar waves, Fluid l) : ForcefieldEntity(u
     
     currents = std::vector<VelocityField*>(0);
     currentsEnabled = false;
+    flowMutex = SDL_CreateMutex();
+    uniformFlow = true;
+    uniformVelocity = V0();
+    uniformVelocityGL = glm::vec3(0.f);
     
     liquid = l;
     wavesDebug.type = RenderableType::HYDRO_POINTS;
@@ -70,6 +75,8 @@ Ocean::~Ocean()
     
     if(glOcean != nullptr)
         delete glOcean;
+    
+    SDL_DestroyMutex(flowMutex);
 }
 
 bool Ocean::hasWaves() const
@@ -131,6 +138,53 @@ void Ocean::setParticles(bool enabled)
 void Ocean::AddVelocityField(VelocityField* field)
 {
     currents.push_back(field);
+    UpdateUniformFlow();
+}
+
+void Ocean::UpdateVelocityFields(Scalar t)
+{
+    if(currentsEnabled)
+    {
+        for(size_t i=0; i<currents.size(); ++i)
+            if(currents[i]->isEnabled())
+                currents[i]->Update(t);
+    }
+    UpdateUniformFlow(); //Fields could have been enabled/disabled/modified since last step
+}
+
+void Ocean::UpdateUniformFlow()
+{
+    bool uniform = true;
+    Vector3 velocity = V0();
+    
+    if(currentsEnabled)
+    {
+        for(size_t i=0; i<currents.size(); ++i)
+        {
+            if(!currents[i]->isEnabled())
+                continue;
+            if(currents[i]->getType() != VelocityFieldType::UNIFORM)
+            {
+                uniform = false;
+                break;
+            }
+            velocity += currents[i]->GetVelocityAtPoint(V0());
+        }
+    }
+    
+    SDL_LockMutex(flowMutex);
+    uniformFlow = uniform;
+    uniformVelocity = velocity;
+    uniformVelocityGL = glVectorFromVector(velocity);
+    SDL_UnlockMutex(flowMutex);
+}
+
+bool Ocean::isFlowUniform() const
+{
+    SDL_LockMutex(flowMutex);
+    bool uniform = uniformFlow;
+    SDL_UnlockMutex(flowMutex);
+    return uniform;
 }
 
 bool Ocean::IsInsideFluid(const Vector3& point)
@@ -174,7 +228,14 @@ Scalar Ocean::GetPressure(const Vector3& point)
 
 Vector3 Ocean::GetFluidVelocity(const Vector3& point) const
 {
-    if(currentsEnabled)
+    SDL_LockMutex(flowMutex);
+    bool uniform = uniformFlow;
+    Vector3 velocity = uniformVelocity;
+    SDL_UnlockMutex(flowMutex);
+    
+    if(uniform)
+        return velocity;
+    else if(currentsEnabled)
     {
         Vector3 fv = V0();
         for(size_t i=0; i<currents.size(); ++i)
@@ -189,17 +250,26 @@ Vector3 Ocean::GetFluidVelocity(const Vector3& point) const
 
 glm::vec3 Ocean::GetFluidVelocity(const glm::vec3& point) const
 {
+    SDL_LockMutex(flowMutex);
+    bool uniform = uniformFlow;
+    glm::vec3 velocity = uniformVelocityGL;
+    SDL_UnlockMutex(flowMutex);
+    
+    if(uniform)
+        return velocity;
     return glVectorFromVector(GetFluidVelocity(Vector3(point.x, point.y, point.z)));
 }
 
 void Ocean::EnableCurrents()
 {
     currentsEnabled = true;
+    UpdateUniformFlow();
 }
 
 void Ocean::DisableCurrents()
 {
     currentsEnabled = false;
+    UpdateUniformFlow();
 }
 
 void Ocean::UpdateCurrentsData()
@@ -208,7 +278,7 @@ void Ocean::UpdateCurrentsData()
         glOcean->UpdateOceanCurrentsData(glOceanCurrentsUBOData);
 }
 
-void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute)
+void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute, const AdaptiveHydrodynamicsSettings& adaptive)
 {
     Entity* ent;
     btRigidBody* rb = btRigidBody::upcast(co);
@@ -235,14 +305,24 @@ void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool
     
     if(ent->getType() == EntityType::SOLID)
     {
+        SolidEntity* solid = (SolidEntity*)ent;
+        
         if(recompute)
         {
-            settings.dampingForces = true;
-            settings.reallisticBuoyancy = true;
-            ((SolidEntity*)ent)->ComputeHydrodynamicForces(settings, this);
+            if(adaptive.enabled)
+                recompute = solid->CheckHydrodynamicsRecompute(adaptive, this);
+            
+            if(recompute)
+            {
+                settings.dampingForces = true;
+                settings.reallisticBuoyancy = true;
+                auto start = std::chrono::steady_clock::now();
+                solid->ComputeHydrodynamicForces(settings, this);
+                solid->AddFluidDynamicsTime(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count(), false);
+            }
         }
         
-        ((SolidEntity*)ent)->ApplyHydrodynamicForces();
+        solid->ApplyHydrodynamicForces();
     }
 }
 
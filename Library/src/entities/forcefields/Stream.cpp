@@ -25,15 +25,33 @@
 
 #include "entities/forcefields/Stream.h"
 
+#include <algorithm>
+#include "core/SimulationApp.h"
+#include "tinysplinecxx.h"
+
+#define STREAM_SAMPLES_PER_SPAN 16
+#define STREAM_BVH_LEAF_SIZE 4
+#define STREAM_BVH_STACK_SIZE 64
+
 namespace sf
 {
 
 Stream::Stream(const std::vector<Vector3>& streamline, const std::vector<Scalar>& radius, Scalar inputVelocity, Scalar exponent)
 {
+    if(streamline.size() < 2 || radius.size() != streamline.size())
+        cCritical("Stream velocity field requires at least two points with a radius defined for each of them!");
+    
     c = streamline;
     r = radius;
     vin = inputVelocity;
     gamma = exponent;
+    
+    BuildPolyline();
+    segs.resize(pts.size()-1);
+    for(unsigned int i=0; i<segs.size(); ++i)
+        segs[i] = i;
+    bvh.reserve(2 * segs.size()/STREAM_BVH_LEAF_SIZE + 1);
+    BuildBVH(0, (unsigned int)segs.size());
 }
 
 VelocityFieldType Stream::getType() const
@@ -41,18 +59,234 @@ VelocityFieldType Stream::getType() const
     return VelocityFieldType::STREAM;
 }
 
+Scalar Stream::getLength() const
+{
+    return arc.back();
+}
+
+void Stream::BuildPolyline()
+{
+    //Sample spline passing through stream line points (radius interpolated as the 4th dimension)
+    if(c.size() >= 3)
+    {
+        std::vector<Scalar> cp(c.size() * 4);
+        for(size_t i=0; i<c.size(); ++i)
+        {
+            cp[i*4+0] = c[i].getX();
+            cp[i*4+1] = c[i].getY();
+            cp[i*4+2] = c[i].getZ();
+            cp[i*4+3] = r[i];
+        }
+        tinyspline::BSpline spline = tinyspline::BSpline::interpolateCubicNatural(cp, 4);
+        std::vector<Scalar> samples = spline.sample((c.size()-1) * STREAM_SAMPLES_PER_SPAN + 1);
+        
+        for(size_t i=0; i<samples.size()/4; ++i)
+        {
+            Vector3 p(samples[i*4+0], samples[i*4+1], samples[i*4+2]);
+            if(!pts.empty() && (p - pts.back()).length2() < SIMD_EPSILON) //Skip degenerate segments
+                continue;
+            pts.push_back(p);
+            rad.push_back(btMax(samples[i*4+3], Scalar(0)));
+        }
+    }
+    else
+    {
+        pts = c;
+        rad = r;
+    }
+    
+    if(pts.size() < 2)
+        cCritical("Stream velocity field has zero length!");
+    
+    //Arc length parametrisation
+    arc.resize(pts.size());
+    arc[0] = Scalar(0);
+    for(size_t i=1; i<pts.size(); ++i)
+        arc[i] = arc[i-1] + (pts[i]-pts[i-1]).length();
+    
+    //Vertex tangents (averaged between neighbouring segments for a continuous flow direction)
+    tan.resize(pts.size());
+    tan.front() = (pts[1]-pts[0]).normalized();
+    tan.back() = (pts.back()-pts[pts.size()-2]).normalized();
+    for(size_t i=1; i<pts.size()-1; ++i)
+    {
+        Vector3 t = (pts[i]-pts[i-1]).normalized() + (pts[i+1]-pts[i]).normalized();
+        tan[i] = t.length2() > SIMD_EPSILON ? t.normalized() : (pts[i+1]-pts[i]).normalized();
+    }
+}
+
+unsigned int Stream::BuildBVH(unsigned int first, unsigned int count)
+{
+    unsigned int id = (unsigned int)bvh.size();
+    bvh.push_back(BVHNode());
+    
+    //Bounding box of segments inflated by the stream radius
+    Vector3 aabbMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+    Vector3 aabbMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+    for(unsigned int i=first; i<first+count; ++i)
+    {
+        unsigned int s = segs[i];
+        Vector3 inf(btMax(rad[s], rad[s+1]), btMax(rad[s], rad[s+1]), btMax(rad[s], rad[s+1]));
+        aabbMin.setMin(pts[s] - inf);
+        aabbMin.setMin(pts[s+1] - inf);
+        aabbMax.setMax(pts[s] + inf);
+        aabbMax.setMax(pts[s+1] + inf);
+    }
+    bvh[id].aabbMin = aabbMin;
+    bvh[id].aabbMax = aabbMax;
+    
+    if(count <= STREAM_BVH_LEAF_SIZE)
+    {
+        bvh[id].first = first;
+        bvh[id].count = count;
+        return id;
+    }
+    
+    //Split at the median of segment centres along the longest axis
+    int axis = (aabbMax - aabbMin).maxAxis();
+    unsigned int half = count/2;
+    std::nth_element(segs.begin() + first, segs.begin() + first + half, segs.begin() + first + count,
+                     [&](unsigned int a, unsigned int b)
+                     { return pts[a][axis] + pts[a+1][axis] < pts[b][axis] + pts[b+1][axis]; });
+    
+    BuildBVH(first, half); //Left child stored right after parent
+    unsigned int right = BuildBVH(first + half, count - half);
+    bvh[id].first = right;
+    bvh[id].count = 0;
+    return id;
+}
+
 Vector3 Stream::GetVelocityAtPoint(const Vector3& p) const
 {
-    return Vector3(0,0,0);
+    //Find the closest projection onto the stream line, among the segments which could contain the point
+    unsigned int stack[STREAM_BVH_STACK_SIZE];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+    
+    Scalar bestRelD(1);
+    unsigned int bestSeg = 0;
+    Scalar bestT(0);
+    Scalar bestR(0);
+    Scalar bestD(0);
+    unsigned int lastSeg = (unsigned int)pts.size()-2;
+    
+    while(stackSize > 0)
+    {
+        unsigned int id = stack[--stackSize];
+        const BVHNode& node = bvh[id];
+        if(p.x() < node.aabbMin.x() || p.x() > node.aabbMax.x()
+           || p.y() < node.aabbMin.y() || p.y() > node.aabbMax.y()
+           || p.z() < node.aabbMin.z() || p.z() > node.aabbMax.z())
+            continue;
+        
+        if(node.count == 0)
+        {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = id + 1;
+            continue;
+        }
+        
+        for(unsigned int i=node.first; i<node.first+node.count; ++i)
+        {
+            unsigned int s = segs[i];
+            Vector3 ab = pts[s+1]-pts[s];
+            Scalar t = (p-pts[s]).dot(ab)/ab.length2();
+            if((s == 0 && t < Scalar(0)) || (s == lastSeg && t > Scalar(1))) //Beyond the ends of the stream
+                continue;
+            t = btClamped(t, Scalar(0), Scalar(1));
+            Scalar rt = rad[s] + (rad[s+1]-rad[s]) * t;
+            if(rt <= Scalar(0))
+                continue;
+            Scalar d = (p - (pts[s] + ab * t)).length();
+            if(d/rt < bestRelD)
+            {
+                bestRelD = d/rt;
+                bestSeg = s;
+                bestT = t;
+                bestR = rt;
+                bestD = d;
+            }
+        }
+    }
+    
+    if(bestRelD >= Scalar(1))
+        return Vector3(0,0,0);
+    
+    //Calculate central velocity (flow direction tangent to the stream line)
+    Vector3 n = (tan[bestSeg] * (Scalar(1)-bestT) + tan[bestSeg+1] * bestT).normalized();
+    Vector3 v = rad[0]/bestR * vin * n;
+    
+    //Calculate fraction of central velocity
+    Scalar f = btPow(Scalar(1)-bestD/bestR, gamma);
+    
+    return f*v;
 }
 
 std::vector<Renderable> Stream::Render(VelocityFieldUBO& ubo)
 {
+    std::vector<Renderable> items(0);
     ubo.posR = glm::vec4(0.f);
     ubo.dirV = glm::vec4(0.f);
     ubo.params = glm::vec3(0.f);
     ubo.type = 0;
-    return std::vector<Renderable>(0);
+    
+    //Stream line
+    Renderable line;
+    line.type = RenderableType::HYDRO_LINE_STRIP;
+    line.model = glm::mat4(1.f);
+    for(size_t i=0; i<pts.size(); ++i)
+        line.points.push_back(glm::vec3((GLfloat)pts[i].x(), (GLfloat)pts[i].y(), (GLfloat)pts[i].z()));
+    items.push_back(line);
+    
+    //Cross-sections along the stream line and tube outline
+    std::vector<size_t> sections;
+    size_t step = c.size() >= 3 ? STREAM_SAMPLES_PER_SPAN/4 : 1;
+    for(size_t i=0; i<pts.size()-1; i+=step)
+        sections.push_back(i);
+    sections.push_back(pts.size()-1);
+    
+    Renderable tube;
+    tube.type = RenderableType::HYDRO_LINES;
+    tube.model = glm::mat4(1.f);
+    Vector3 x_, y_;
+    btPlaneSpace1(tan[0], x_, y_);
+    std::vector<glm::vec3> prev(0);
+    
+    for(size_t i : sections)
+    {
+        //Transport frame along the stream line to avoid twisting
+        Vector3 xt = x_ - tan[i] * x_.dot(tan[i]);
+        if(xt.length2() > SIMD_EPSILON)
+        {
+            x_ = xt.normalized();
+            y_ = tan[i].cross(x_);
+        }
+        else
+            btPlaneSpace1(tan[i], x_, y_);
+        
+        Renderable ring;
+        ring.type = RenderableType::HYDRO_LINE_STRIP;
+        ring.model = glm::mat4(1.f);
+        for(unsigned int h=0; h<=12; ++h)
+        {
+            Scalar alpha = Scalar(h)/Scalar(12) * M_PI * Scalar(2);
+            Vector3 v = pts[i] + (x_ * btCos(alpha) + y_ * btSin(alpha)) * rad[i];
+            ring.points.push_back(glm::vec3((GLfloat)v.x(), (GLfloat)v.y(), (GLfloat)v.z()));
+        }
+        
+        if(!prev.empty())
+        {
+            for(unsigned int h=0; h<12; h+=3)
+            {
+                tube.points.push_back(prev[h]);
+                tube.points.push_back(ring.points[h]);
+            }
+        }
+        prev = ring.points;
+        items.push_back(ring);
+    }
+    items.push_back(tube);
+    return items;
 }
     
 }
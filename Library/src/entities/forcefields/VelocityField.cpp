@@ -36,6 +36,10 @@ VelocityField::~VelocityField()
 {
 }
 
+void VelocityField::Update(Scalar t)
+{
+}
+
 void VelocityField::setEnabled(bool en)
 {
     enabled = en;
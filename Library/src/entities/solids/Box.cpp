@@ -69,7 +69,7 @@ Box::Box(std::string uniqueName, BodyPhysicsSettings phy, const Vector3& dimensi
     
     //Build geometry
 	glm::vec3 glHalfExtents(halfExtents.x(), halfExtents.y(), halfExtents.z());
-	phyMesh = OpenGLContent::BuildBox(glHalfExtents, 3, uvMode);
+	phyMesh.reset(OpenGLContent::BuildBox(glHalfExtents, 3, uvMode));
     
     //Compute hydrodynamic properties
     ComputeFluidDynamicsApprox( GeometryApproxType::ELLIPSOID);
@@ -81,6 +81,12 @@ SolidType Box::getSolidType()
     return SolidType::BOX;
 }
 
+std::shared_ptr<const Mesh> Box::BuildPhysicsMeshLOD()
+{
+    glm::vec3 glHalfExtents(halfExtents.x(), halfExtents.y(), halfExtents.z());
+    return std::shared_ptr<const Mesh>(OpenGLContent::BuildBox(glHalfExtents, 1));
+}
+
 btCollisionShape* Box::BuildCollisionShape()
 {
     btCollisionShape* box = new btBoxShape(halfExtents);
@@ -36,7 +36,7 @@ Compound::Compound(std::string uniqueName, BodyPhysicsSettings phy, SolidEntity*
     : SolidEntity(uniqueName, phy, "", "", Scalar(-1))
 {
     //All transformations are zero -> transforming the origin of a compound body doesn't make sense...
-    phyMesh = NULL; // There is no single mesh
+    phyMesh.reset(); // There is no single mesh
     volume = 0;
     mass = 0;
     Ipri = Vector3(0,0,0);
@@ -128,6 +128,20 @@ std::vector<Vector3>* Compound::getMeshVertices() const
         
     return pVert;
 }
+
+bool Compound::setPhysicsMeshLOD(bool enabled)
+{
+    bool switched = false;
+    for(size_t i=0; i<parts.size(); ++i)
+        switched = parts[i].solid->setPhysicsMeshLOD(enabled) || switched;
+    
+    if(switched)
+    {
+        useLOD = enabled;
+        hydroCached = false;
+    }
+    return switched;
+}
     
 void Compound::AddInternalPart(SolidEntity* solid, const Transform& origin, bool alwaysVisible)
 {
@@ -281,8 +295,21 @@ btCollisionShape* Compound::BuildCollisionShape()
         {
             Transform childTrans = parts[i].origin * parts[i].solid->getCG2OTransform().inverse() * parts[i].solid->getCG2CTransform();
             btCollisionShape* partColShape = parts[i].solid->BuildCollisionShape();
-            colShape->addChildShape(childTrans, partColShape);
-            collisionPartId.push_back(i);
+            if(partColShape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE) //Flatten decomposed parts, so that child indices map to parts
+            {
+                btCompoundShape* partCompound = (btCompoundShape*)partColShape;
+                for(int h=0; h<partCompound->getNumChildShapes(); ++h)
+                {
+                    colShape->addChildShape(childTrans * partCompound->getChildTransform(h), partCompound->getChildShape(h));
+                    collisionPartId.push_back(i);
+                }
+                delete partCompound;
+            }
+            else
+            {
+                colShape->addChildShape(childTrans, partColShape);
+                collisionPartId.push_back(i);
+            }
         }
     }
     return colShape;
@@ -290,11 +317,24 @@ btCollisionShape* Compound::BuildCollisionShape()
 
 void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn)
 {
-    if(phy.mode != BodyPhysicsMode::FLOATING && phy.mode != BodyPhysicsMode::SUBMERGED) return;
+    if(phy.mode != BodyPhysicsMode::FLOATING && phy.mode != BodyPhysicsMode::SUBMERGED)
+    {
+        hydroBfFresh = false;
+        return;
+    }
     
     submerged.points.clear();
 
-    BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
+    BodyFluidPosition bf = GetBodyFluidPosition(ocn);
+
+    size_t faces = 0;
+    if(bf != BodyFluidPosition::OUTSIDE)
+        for(size_t i=0; i<parts.size(); ++i)
+            if((parts[i].isExternal || bf == BodyFluidPosition::CROSSING_SURFACE)
+                && (parts[i].solid->getBodyPhysicsMode() == BodyPhysicsMode::SUBMERGED
+                || parts[i].solid->getBodyPhysicsMode() == BodyPhysicsMode::FLOATING))
+                faces += parts[i].solid->getPhysicsMesh()->faces.size();
+    CountHydrodynamicsEvaluation(bf, faces);
      
     //If completely outside fluid just set all torques and forces to 0
     if(bf == BodyFluidPosition::OUTSIDE)
@@ -443,15 +483,26 @@ void Compound::ComputeAerodynamicForces(Atmosphere* atm)
     Vector3 Fdap(0,0,0);
     Vector3 Tdap(0,0,0);
             
+    size_t faces = 0;
     for(size_t i=0; i<parts.size(); ++i) //Go through all parts
         if(parts[i].isExternal) //Compute drag only for external parts
         {
             Transform T_C_part = getOTransform() * parts[i].origin * parts[i].solid->getO2CTransform();
-            SolidEntity::ComputeAerodynamicForces(parts[i].solid->getPhysicsMesh(), atm, getCGTransform(), T_C_part, v, omega, Fdap, Tdap);
+            const MeshFaceData& partFaces = parts[i].solid->getPhysicsFaceData();
+            faces += partFaces.area.size();
+            SolidEntity::ComputeAerodynamicForces(partFaces, atm, getCGTransform(), T_C_part, v, omega, Fdap, Tdap);
             parts[i].solid->CorrectAerodynamicForces(atm, Fdap, Tdap);
             Fda += Fdap;
             Tda += Tdap;
         }
+    CountAerodynamicsEvaluation(faces);
+}
+
+void Compound::getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics)
+{
+    SolidEntity::getMeshes(graphics, physics);
+    for(size_t i=0; i<parts.size(); ++i)
+        parts[i].solid->getMeshes(graphics, physics);
 }
 
 void Compound::BuildGraphicalObject()
@@ -67,7 +67,7 @@ Cylinder::Cylinder(std::string uniqueName, BodyPhysicsSettings phy, Scalar radiu
     }
     
     //Build geometry
-    phyMesh = OpenGLContent::BuildCylinder((GLfloat)r, (GLfloat)(halfHeight*2), (unsigned int)btMax(ceil(2.0*M_PI*r/0.1), 32.0)); //Max 0.1 m cylinder wall slice width
+    phyMesh.reset(OpenGLContent::BuildCylinder((GLfloat)r, (GLfloat)(halfHeight*2), (unsigned int)btMax(ceil(2.0*M_PI*r/0.1), 32.0))); //Max 0.1 m cylinder wall slice width
     
     //Compute hydrodynamic properties
     ComputeFluidDynamicsApprox( GeometryApproxType::CYLINDER);
@@ -79,6 +79,11 @@ SolidType Cylinder::getSolidType()
     return SolidType::CYLINDER;
 }
 
+std::shared_ptr<const Mesh> Cylinder::BuildPhysicsMeshLOD()
+{
+    return std::shared_ptr<const Mesh>(OpenGLContent::BuildCylinder((GLfloat)r, (GLfloat)(halfHeight*2), (unsigned int)btMax(ceil(M_PI*r/0.1), 16.0))); //Half of the slices
+}
+
 btCollisionShape* Cylinder::BuildCollisionShape()
 {
     btCollisionShape* cyl = new btCylinderShapeZ(Vector3(r, r, halfHeight));
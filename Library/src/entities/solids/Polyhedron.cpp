@@ -25,10 +25,12 @@
 
 #include "entities/solids/Polyhedron.h"
 
+#include "core/SimulationApp.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "utils/SystemUtil.hpp"
 #include "utils/GeometryFileUtil.h"
+#include "utils/MeshCache.h"
 
 namespace sf
 {
@@ -39,27 +41,36 @@ Polyhedron::Polyhedron(std::string uniqueName, BodyPhysicsSettings phy,
                        std::string material, std::string look, Scalar thickness, GeometryApproxType approx)
                         : SolidEntity(uniqueName, phy, material, look, thickness)
 {
-    //1.Load geometry from file
-    graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false);
+    //1.Load geometry from file (meshes are shared between instances through the mesh cache)
     T_O2G = graphicsOrigin;
+    hullVertices = 0;
+    decompositionParts = 0;
     
     if(physicsFilename != "")
     {
-        phyMesh = OpenGLContent::LoadMesh(physicsFilename, physicsScale, false);
+        graMesh = MeshCache::GetMesh(graphicsFilename, graphicsScale, false);
+        phyMesh = MeshCache::GetRefinedMesh(physicsFilename, physicsScale, false, 3.f);
+        phyFilename = physicsFilename;
+        phyScale = (GLfloat)physicsScale;
         T_O2C = physicsOrigin;
     }
     else
     {
-        phyMesh = graMesh;
+        phyMesh = MeshCache::GetRefinedMesh(graphicsFilename, graphicsScale, false, 3.f);
+        phyFilename = graphicsFilename;
+        phyScale = (GLfloat)graphicsScale;
+        graMesh = phyMesh;
         T_O2C = T_O2G;
     }
     
-    OpenGLContent::Refine(phyMesh, 3.f);
-    
     //2. Compute physical properties
-    Vector3 CG;
-    Matrix3 Irot;
-    ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
+    MeshProperties mp = MeshCache::GetPhysicalProperties(phyMesh.get(), thickness, mat.density);
+    mass = mp.mass;
+    volume = mp.volume;
+    surface = mp.surface;
+    Ipri = mp.Ipri;
+    Vector3 CG = mp.CG;
+    Matrix3 Irot = mp.Irot;
     T_CG2C.setOrigin(-CG); //Set CG position
     T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
     T_CG2O = T_CG2C * T_O2C.inverse();
@@ -80,8 +91,6 @@ Polyhedron::Polyhedron(std::string uniqueName, BodyPhysicsSettings phy,
 
 Polyhedron::~Polyhedron()
 {
-    if(graMesh != nullptr && graMesh != phyMesh)
-        delete graMesh;
 }
     
 SolidType Polyhedron::getSolidType()
@@ -91,25 +100,78 @@ SolidType Polyhedron::getSolidType()
 
 btCollisionShape* Polyhedron::BuildCollisionShape()
 {
-    btConvexHullShape* convex = new btConvexHullShape();
-    for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
+    if(decompositionParts > 1)
+    {
+        std::shared_ptr<const std::vector<std::vector<Vector3>>> parts = MeshCache::GetConvexDecomposition(phyMesh.get(), decompositionParts, hullVertices);
+        if(parts->size() > 1)
+        {
+            btCompoundShape* compound = new btCompoundShape();
+            for(size_t i=0; i<parts->size(); ++i)
+            {
+                if((*parts)[i].empty())
+                    continue;
+                btConvexHullShape* convex = new btConvexHullShape(&(*parts)[i][0].x(), (int)(*parts)[i].size(), sizeof(Vector3));
+                convex->setMargin(0);
+                compound->addChildShape(I4(), convex);
+            }
+            return compound;
+        }
+    }
+    
+    std::shared_ptr<const std::vector<Vector3>> hull = MeshCache::GetConvexHull(phyMesh.get(), hullVertices);
+    if(hull->empty())
     {
-        glm::vec3 pos = phyMesh->getVertexPos(i);
-        Vector3 v(pos.x, pos.y, pos.z);
-        convex->addPoint(v);
+        cError("Failed to build the collision shape of '%s' (empty mesh)!", getName().c_str());
+        return new btEmptyShape();
     }
-    //convex->optimizeConvexHull();
+    btConvexHullShape* convex = new btConvexHullShape(&(*hull)[0].x(), (int)hull->size(), sizeof(Vector3));
     convex->setMargin(0);
     return convex;
 }
 
+std::shared_ptr<const Mesh> Polyhedron::BuildPhysicsMeshLOD()
+{
+    //The coarse version is the mesh before refinement (shared through the mesh cache)
+    std::shared_ptr<const Mesh> mesh = MeshCache::GetMesh(phyFilename, phyScale, false);
+    if(mesh == nullptr || mesh->faces.size() >= phyMesh->faces.size())
+        return nullptr;
+    return mesh;
+}
+
+void Polyhedron::setMaxHullVertices(unsigned int n)
+{
+    hullVertices = n == 0 ? 0 : (n < 4 ? 4 : n);
+}
+
+unsigned int Polyhedron::getMaxHullVertices() const
+{
+    return hullVertices;
+}
+
+void Polyhedron::setConvexDecomposition(unsigned int maxParts)
+{
+    decompositionParts = maxParts;
+}
+
+unsigned int Polyhedron::getConvexDecomposition() const
+{
+    return decompositionParts;
+}
+
+void Polyhedron::getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics)
+{
+    SolidEntity::getMeshes(graphics, physics);
+    if(graMesh != nullptr && graMesh != phyMesh)
+        graphics.push_back(graMesh.get());
+}
+
 void Polyhedron::BuildGraphicalObject()
 {
-    if(graMesh == NULL || !SimulationApp::getApp()->hasGraphics())
+    if(graMesh == nullptr || !SimulationApp::getApp()->hasGraphics())
         return;
     
-    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(graMesh);
-    phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
+    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(graMesh.get());
+    phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh.get());
 }
 
 }
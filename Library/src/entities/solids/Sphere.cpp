@@ -60,7 +60,7 @@ Sphere::Sphere(std::string uniqueName, BodyPhysicsSettings phy, Scalar radius, c
     }
     
     //Build geometry
-    phyMesh = OpenGLContent::BuildSphere((GLfloat)r);
+    phyMesh.reset(OpenGLContent::BuildSphere((GLfloat)r));
     
     //Compute hydrodynamic properties
     ComputeFluidDynamicsApprox( GeometryApproxType::SPHERE);
@@ -72,6 +72,11 @@ SolidType Sphere::getSolidType()
     return SolidType::SPHERE;
 }
 
+std::shared_ptr<const Mesh> Sphere::BuildPhysicsMeshLOD()
+{
+    return std::shared_ptr<const Mesh>(OpenGLContent::BuildSphere((GLfloat)r, 2));
+}
+
 btCollisionShape* Sphere::BuildCollisionShape()
 {
     return new btSphereShape(r); //Note: Entire radius is a collision margin.
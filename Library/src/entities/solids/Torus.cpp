@@ -66,7 +66,7 @@ Torus::Torus(std::string uniqueName, BodyPhysicsSettings phy, Scalar majorRadius
     }
     
     //Build geometry
-    phyMesh = OpenGLContent::BuildTorus(MR, mR);
+    phyMesh.reset(OpenGLContent::BuildTorus(MR, mR));
     
     //Compute hydrodynamic properties
     ComputeFluidDynamicsApprox( GeometryApproxType::CYLINDER);
@@ -78,6 +78,11 @@ SolidType Torus::getSolidType()
     return SolidType::TORUS;
 }
 
+std::shared_ptr<const Mesh> Torus::BuildPhysicsMeshLOD()
+{
+    return std::shared_ptr<const Mesh>(OpenGLContent::BuildTorus(MR, mR, 24, 12));
+}
+
 btCollisionShape* Torus::BuildCollisionShape()
 {   
     btCollisionShape* torus = new TorusShape(MR, mR);
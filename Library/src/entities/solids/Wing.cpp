@@ -25,8 +25,10 @@
 
 #include "entities/solids/Wing.h"
 
+#include "core/SimulationApp.h"
 #include "graphics/OpenGLContent.h"
 #include "utils/GeometryFileUtil.h"
+#include "utils/MeshCache.h"
 
 namespace sf
 {
@@ -45,13 +47,13 @@ Wing::Wing(std::string uniqueName, BodyPhysicsSettings phy, Scalar baseChordLeng
     wingLength = wingLength < Scalar(0) ? Scalar(0) : wingLength;
     
     //1. Build wing geometry
-    phyMesh = OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
-                                       (GLfloat)profileThickness, (GLfloat)wingLength);
+    phyMesh.reset(OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
+                                           (GLfloat)profileThickness, (GLfloat)wingLength));
     
     //2. Compute physical properties
     Vector3 CG;
     Matrix3 Irot;
-    ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
+    ComputePhysicalProperties(phyMesh.get(), thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
     T_CG2C.setOrigin(-CG); //Set CG position
     T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
     T_CG2O = T_CG2C * T_O2C.inverse();
@@ -97,14 +99,14 @@ Wing::Wing(std::string uniqueName, BodyPhysicsSettings phy, Scalar baseChordLeng
     }
     
     //2. Build wing geometry
-    phyMesh = OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
-                                       (GLfloat)profileThickness, (GLfloat)wingLength);
+    phyMesh.reset(OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
+                                           (GLfloat)profileThickness, (GLfloat)wingLength));
     
     
     //3. Compute physical properties
     Vector3 CG;
     Matrix3 Irot;
-    ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
+    ComputePhysicalProperties(phyMesh.get(), thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
     T_CG2C.setOrigin(-CG); //Set CG position
     T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
     T_CG2O = T_CG2C * T_O2C.inverse();
@@ -123,14 +125,13 @@ SolidType Wing::getSolidType()
     
 btCollisionShape* Wing::BuildCollisionShape()
 {
-    btConvexHullShape* convex = new btConvexHullShape();
-    for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
+    std::shared_ptr<const std::vector<Vector3>> hull = MeshCache::GetConvexHull(phyMesh.get());
+    if(hull->empty())
     {
-        glm::vec3 pos = phyMesh->getVertexPos(i);
-        Vector3 v(pos.x, pos.y, pos.z);
-        convex->addPoint(v);
+        cError("Failed to build the collision shape of '%s' (empty mesh)!", getName().c_str());
+        return new btEmptyShape();
     }
-    //convex->optimizeConvexHull();
+    btConvexHullShape* convex = new btConvexHullShape(&(*hull)[0].x(), (int)hull->size(), sizeof(Vector3));
     convex->setMargin(0);
     return convex;
 }
@@ -28,6 +28,7 @@
 #include "core/GraphicalSimulationApp.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "utils/MeshCache.h"
 
 namespace sf
 {
@@ -37,58 +38,54 @@ Obstacle::Obstacle(std::string uniqueName,
          std::string physicsFilename, Scalar physicsScale, const Transform& physicsOrigin, bool convexHull,
          std::string material, std::string look) : StaticEntity(uniqueName, material, look)
 {
+    //Meshes are shared with the mesh cache, their origins are applied when rendering
     graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false);
-    OpenGLContent::TransformMesh(graMesh, graphicsOrigin);
+    T_O2G = graphicsOrigin;
     
     if(physicsFilename != "")
     {
-        phyMesh = OpenGLContent::LoadMesh(physicsFilename, physicsScale, false);
-        OpenGLContent::TransformMesh(phyMesh, physicsOrigin);
+        sharedPhyMesh = OpenGLContent::LoadMesh(physicsFilename, physicsScale, false);
+        T_O2C = physicsOrigin;
     }
     else
-        phyMesh = graMesh;
+    {
+        sharedPhyMesh = graMesh;
+        T_O2C = graphicsOrigin;
+    }
         
     graObjectId = -1;
 
-    //Buidling collision shape
-    if(convexHull) // Convex approximation
+    //Buidling collision shape (from the shared mesh transformed to the origin)
+    const std::shared_ptr<const Mesh>& sharedMesh = sharedPhyMesh;
+    const Transform& T = T_O2C;
+    
+    if(convexHull) // Convex approximation (hull vertices are mapped by the affine transformation)
     {
-        btConvexHullShape* shape = new btConvexHullShape();
-        for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
+        std::shared_ptr<const std::vector<Vector3>> hull = MeshCache::GetConvexHull(sharedMesh.get());
+        if(hull->empty())
         {
-            glm::vec3 pos = phyMesh->getVertexPos(i);
-            Vector3 v(pos.x, pos.y, pos.z);
-            shape->addPoint(v);
+            cError("Failed to build the collision shape of '%s' (empty mesh)!", getName().c_str());
+            BuildRigidBody(new btEmptyShape());
+            return;
         }
-        //shape->optimizeConvexHull();
+        btConvexHullShape* shape = new btConvexHullShape();
+        for(size_t i=0; i<hull->size(); ++i)
+            shape->addPoint(T * (*hull)[i], false);
+        shape->recalcLocalAabb();
         shape->setMargin(0);
         BuildRigidBody(shape);    
     }
-    else // Non-convex (arbitrary triangle mesh)
+    else // Non-convex (arbitrary triangle mesh, hierarchy shared between instances and cached on disk)
     {
-        Scalar* vertices = new Scalar[phyMesh->getNumOfVertices() * 3];
-        int* indices = new int[phyMesh->faces.size()*3];
-        
-        for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
-        {
-            glm::vec3 pos = phyMesh->getVertexPos(i);
-            vertices[i*3+0] = pos.x;
-            vertices[i*3+1] = pos.y;
-            vertices[i*3+2] = pos.z;
-        }
-        
-        for(size_t i=0; i<phyMesh->faces.size(); ++i)
+        triangleShape = MeshCache::GetTriangleMeshShape(sharedMesh);
+        if(T == I4())
+            BuildRigidBody(triangleShape.get());
+        else
         {
-            indices[i*3+0] = phyMesh->faces[i].vertexID[0];
-            indices[i*3+1] = phyMesh->faces[i].vertexID[1];
-            indices[i*3+2] = phyMesh->faces[i].vertexID[2];
+            btCompoundShape* cShape = new btCompoundShape();
+            cShape->addChildShape(T, triangleShape.get());
+            BuildRigidBody(cShape);
         }
-        
-        btTriangleIndexVertexArray* triangleArray = new btTriangleIndexVertexArray((int)phyMesh->faces.size(), indices, 3*sizeof(int),
-                                                                                (int)phyMesh->getNumOfVertices(), vertices, 3*sizeof(Scalar));
-        btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(triangleArray, true);
-        shape->setMargin(0);
-        BuildRigidBody(shape);
     }
 }
     
@@ -100,8 +97,8 @@ Obstacle::Obstacle(std::string uniqueName, std::string modelFilename, Scalar sca
 Obstacle::Obstacle(std::string uniqueName, Scalar sphereRadius, const Transform& origin, std::string material, std::string look) : StaticEntity(uniqueName, material, look)
 {
     phyMesh = OpenGLContent::BuildSphere(sphereRadius);
-    graMesh = phyMesh;
     graObjectId = -1;
+    T_O2G = T_O2C = I4();
     
     btSphereShape* shape = new btSphereShape(sphereRadius);
     if(origin == I4())
@@ -120,8 +117,8 @@ Obstacle::Obstacle(std::string uniqueName, Vector3 boxDimensions, const Transfor
     Vector3 halfExtents = boxDimensions/Scalar(2);
     glm::vec3 glHalfExtents(halfExtents.x(), halfExtents.y(), halfExtents.z());
 	phyMesh = OpenGLContent::BuildBox(glHalfExtents, 0, uvMode);
-    graMesh = phyMesh;
 	graObjectId = -1;
+    T_O2G = T_O2C = I4();
     
     btBoxShape* shape = new btBoxShape(halfExtents);
     shape->setMargin(COLLISION_MARGIN);
@@ -140,8 +137,8 @@ Obstacle::Obstacle(std::string uniqueName, Scalar cylinderRadius, Scalar cylinde
 {
     Scalar halfHeight = cylinderHeight/Scalar(2);
     phyMesh = OpenGLContent::BuildCylinder((GLfloat)cylinderRadius, (GLfloat)cylinderHeight, (unsigned int)btMax(ceil(2.0*M_PI*cylinderRadius/0.1), 32.0)); //Max 0.1 m cylinder wall slice width
-    graMesh = phyMesh;
     graObjectId = -1;
+    T_O2G = T_O2C = I4();
     
     btCylinderShape* shape = new btCylinderShapeZ(Vector3(cylinderRadius, cylinderRadius, halfHeight));
     shape->setMargin(COLLISION_MARGIN);
@@ -158,8 +155,6 @@ Obstacle::Obstacle(std::string uniqueName, Scalar cylinderRadius, Scalar cylinde
     
 Obstacle::~Obstacle()
 {
-    if(graMesh != nullptr && graMesh != phyMesh)
-        delete graMesh;
 }
 
 StaticEntityType Obstacle::getStaticType()
@@ -167,13 +162,24 @@ StaticEntityType Obstacle::getStaticType()
     return StaticEntityType::OBSTACLE;
 }
     
+void Obstacle::getMeshes(std::vector<const Mesh*>& graphics, std::vector<const Mesh*>& physics)
+{
+    StaticEntity::getMeshes(graphics, physics);
+    if(sharedPhyMesh != nullptr)
+        physics.push_back(sharedPhyMesh.get());
+    if(graMesh != nullptr && graMesh != sharedPhyMesh)
+        graphics.push_back(graMesh.get());
+}
+    
 void Obstacle::BuildGraphicalObject()
 {
-    if(graMesh == nullptr || !SimulationApp::getApp()->hasGraphics())
+    const Mesh* mesh = phyMesh != nullptr ? phyMesh : sharedPhyMesh.get();
+    if(mesh == nullptr || !SimulationApp::getApp()->hasGraphics())
         return;
-        
-    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(graMesh);
-    phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
+    
+    OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
+    phyObjectId = content->BuildObject(mesh);
+    graObjectId = graMesh != nullptr && graMesh.get() != mesh ? (int)content->BuildObject(graMesh.get()) : phyObjectId;
 }
 
 std::vector<Renderable> Obstacle::Render()
@@ -190,14 +196,14 @@ std::vector<Renderable> Obstacle::Render()
         { 
             item.objectId = graObjectId;
             item.lookId = lookId;
-            item.model = glMatrixFromTransform(getTransform());
+            item.model = glMatrixFromTransform(getTransform() * T_O2G);
             items.push_back(item);
         }
         else if(dm == DisplayMode::PHYSICAL && phyObjectId >= 0)
         {
             item.objectId = phyObjectId;
             item.lookId = -1;
-            item.model = glMatrixFromTransform(getTransform());
+            item.model = glMatrixFromTransform(getTransform() * T_O2C);
             items.push_back(item);
         }
     }
@@ -0,0 +1,407 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  TiledTerrain.cpp
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "entities/statics/TiledTerrain.h"
+
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "LinearMath/btAabbUtil2.h"
+#include "core/SimulationApp.h"
+#include "core/SimulationManager.h"
+#include "graphics/OpenGLContent.h"
+
+#define TILED_TERRAIN_HEADER_SIZE 40
+
+namespace sf
+{
+
+TiledTerrain::TiledTerrain(std::string uniqueName, std::string pathToHeights, Scalar loadDistance, Scalar evictDistance,
+                           std::string material, std::string look, float uvScale) : StaticEntity(uniqueName, material, look)
+{
+    map = nullptr;
+    mapSize = 0;
+    pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    loadDist = btMax(loadDistance, Scalar(0));
+    evictDist = evictDistance;
+    if(evictDist < loadDist)
+    {
+        cWarning("Evict distance of tiled terrain '%s' smaller than load distance! Using load distance.", uniqueName.c_str());
+        evictDist = loadDist;
+    }
+    origin = Transform::getIdentity();
+    updateId = 0;
+
+    //Map file
+    int fd = open(pathToHeights.c_str(), O_RDONLY);
+    if(fd < 0)
+        cCritical("Failed to open tiled terrain file '%s'!", pathToHeights.c_str());
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < TILED_TERRAIN_HEADER_SIZE)
+    {
+        close(fd);
+        cCritical("Tiled terrain file '%s' is corrupted!", pathToHeights.c_str());
+    }
+    mapSize = (size_t)st.st_size;
+    map = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        map = nullptr;
+        cCritical("Failed to map tiled terrain file '%s'!", pathToHeights.c_str());
+    }
+    madvise(map, mapSize, MADV_RANDOM); //Tiles are accessed depending on the motion of bodies
+
+    //Parse header
+    const char* bytes = (const char*)map;
+    uint32_t header[5];
+    double spacing[2];
+    memcpy(header, bytes + 4, sizeof(header));
+    memcpy(spacing, bytes + 24, sizeof(spacing));
+    if(strncmp(bytes, "SFHT", 4) != 0 || header[0] != 1)
+        cCritical("Tiled terrain file '%s' has unsupported format!", pathToHeights.c_str());
+    nx = header[1];
+    ny = header[2];
+    tileSize = header[3];
+    dx = Scalar(spacing[0]);
+    dy = Scalar(spacing[1]);
+    if(nx < 2 || ny < 2 || tileSize == 0 || dx <= Scalar(0) || dy <= Scalar(0))
+        cCritical("Tiled terrain file '%s' defines an empty grid!", pathToHeights.c_str());
+    ntx = (nx - 2)/tileSize + 1;
+    nty = (ny - 2)/tileSize + 1;
+    if(mapSize < TILED_TERRAIN_HEADER_SIZE + sizeof(float) * (size_t)(nx - 1 + ntx) * (size_t)(ny - 1 + nty))
+        cCritical("Tiled terrain file '%s' is truncated!", pathToHeights.c_str());
+    data = (const float*)(bytes + TILED_TERRAIN_HEADER_SIZE);
+    
+    Tile empty;
+    empty.shape = nullptr;
+    empty.body = nullptr;
+    empty.used = 0;
+    tiles.resize((size_t)ntx * nty, empty);
+    
+    //Generate downsampled graphical mesh
+    if(SimulationApp::getApp()->hasGraphics())
+    {
+        unsigned int rx = btMin(nx, (unsigned int)TILED_TERRAIN_RENDER_SAMPLES);
+        unsigned int ry = btMin(ny, (unsigned int)TILED_TERRAIN_RENDER_SAMPLES);
+        GLfloat* heightmap = new GLfloat[rx*ry];
+        for(unsigned int i=0; i<ry; ++i)
+        {
+            unsigned int iy = (unsigned int)((double)i * (ny-1)/(ry-1) + 0.5);
+            for(unsigned int j=0; j<rx; ++j)
+                heightmap[i*rx+j] = Sample((unsigned int)((double)j * (nx-1)/(rx-1) + 0.5), iy);
+        }
+        phyMesh = OpenGLContent::BuildTerrain(heightmap, rx, ry, (GLfloat)(dx*(nx-1)/(rx-1)), (GLfloat)(dy*(ny-1)/(ry-1)), 0.f, uvScale);
+        delete [] heightmap;
+        madvise(map, mapSize, MADV_DONTNEED); //Release pages touched during downsampling
+        BuildGraphicalObject();
+    }
+    
+    cInfo("Mapped tiled terrain %ux%u with %ux%u tiles from '%s'.", nx, ny, ntx, nty, pathToHeights.c_str());
+}
+
+TiledTerrain::~TiledTerrain()
+{
+    //Bodies are owned by the dynamics world
+    for(size_t i=0; i<loaded.size(); ++i)
+        delete tiles[loaded[i]].shape;
+    if(map != nullptr)
+        munmap(map, mapSize);
+}
+
+StaticEntityType TiledTerrain::getStaticType()
+{
+    return StaticEntityType::TILED_TERRAIN;
+}
+
+void TiledTerrain::getAABB(Vector3& min, Vector3& max)
+{
+    //Terrain shouldn't affect shadow calculation
+    min.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+    max.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+}
+
+unsigned int TiledTerrain::getNumOfTiles() const
+{
+    return (unsigned int)tiles.size();
+}
+
+unsigned int TiledTerrain::getNumOfLoadedTiles() const
+{
+    return (unsigned int)loaded.size();
+}
+
+void TiledTerrain::AddToSimulation(SimulationManager* sm, const Transform& origin)
+{
+    //Tiles are added to the world when needed
+    this->origin = origin;
+}
+
+std::vector<Renderable> TiledTerrain::Render()
+{
+    std::vector<Renderable> items(0);
+    
+    if(phyObjectId >= 0 && isRenderable())
+    {
+        Renderable item;
+        item.type = RenderableType::SOLID;
+        item.materialName = mat.name;
+        item.objectId = phyObjectId;
+        item.lookId = dm == DisplayMode::GRAPHICAL ? lookId : -1;
+        item.model = glMatrixFromTransform(origin);
+        items.push_back(item);
+    }
+    
+    return items;
+}
+
+void TiledTerrain::TileSize(unsigned int tx, unsigned int ty, unsigned int& w, unsigned int& h) const
+{
+    w = btMin(tileSize, nx - 1 - tx * tileSize) + 1;
+    h = btMin(tileSize, ny - 1 - ty * tileSize) + 1;
+}
+
+size_t TiledTerrain::TileOffset(unsigned int tx, unsigned int ty) const
+{
+    //All rows of tiles but the last one, and all tiles in a row but the last one, have full size
+    unsigned int w, h;
+    TileSize(tx, ty, w, h);
+    return (size_t)ty * (tileSize + 1) * (nx - 1 + ntx) + (size_t)tx * (tileSize + 1) * h;
+}
+
+float TiledTerrain::Sample(unsigned int ix, unsigned int iy) const
+{
+    unsigned int tx = btMin(ix/tileSize, ntx-1);
+    unsigned int ty = btMin(iy/tileSize, nty-1);
+    unsigned int w, h;
+    TileSize(tx, ty, w, h);
+    return data[TileOffset(tx, ty) + (size_t)(iy - ty * tileSize) * w + (ix - tx * tileSize)];
+}
+
+void TiledTerrain::UpdateTiles(btDynamicsWorld* world)
+{
+    ++updateId;
+    MarkTiles(world, evictDist, false); //Keep loaded tiles
+    MarkTiles(world, loadDist, true); //Load missing tiles
+    
+    for(size_t i=0; i<loaded.size();)
+    {
+        if(tiles[loaded[i]].used != updateId)
+        {
+            EvictTile(world, loaded[i]);
+            loaded[i] = loaded.back();
+            loaded.pop_back();
+        }
+        else
+            ++i;
+    }
+}
+
+void TiledTerrain::MarkTiles(btDynamicsWorld* world, Scalar distance, bool load)
+{
+    Transform invOrigin = origin.inverse();
+    Scalar tileX = dx * tileSize;
+    Scalar tileY = dy * tileSize;
+    Scalar x0 = -dx * (nx - 1)/Scalar(2);
+    Scalar y0 = -dy * (ny - 1)/Scalar(2);
+    
+    btCollisionObjectArray& objects = world->getCollisionObjectArray();
+    for(int i=0; i<objects.size(); ++i)
+    {
+        //Only bodies which can collide with the terrain
+        btCollisionObject* co = objects[i];
+        btBroadphaseProxy* proxy = co->getBroadphaseHandle();
+        if(co->isStaticObject() || proxy == nullptr || (proxy->m_collisionFilterMask & MASK_STATIC) == 0
+           || (co->getInternalType() != btCollisionObject::CO_RIGID_BODY && co->getInternalType() != btCollisionObject::CO_FEATHERSTONE_LINK))
+            continue;
+        
+        Vector3 aabbMin, aabbMax;
+        btTransformAabb(proxy->m_aabbMin, proxy->m_aabbMax, Scalar(0), invOrigin, aabbMin, aabbMax);
+        Scalar fx0 = std::floor((aabbMin.getX() - distance - x0)/tileX);
+        Scalar fx1 = std::floor((aabbMax.getX() + distance - x0)/tileX);
+        Scalar fy0 = std::floor((aabbMin.getY() - distance - y0)/tileY);
+        Scalar fy1 = std::floor((aabbMax.getY() + distance - y0)/tileY);
+        if(fx1 < Scalar(0) || fy1 < Scalar(0) || fx0 >= Scalar(ntx) || fy0 >= Scalar(nty))
+            continue;
+        
+        unsigned int tx0 = (unsigned int)btMax(fx0, Scalar(0));
+        unsigned int tx1 = (unsigned int)btMin(fx1, Scalar(ntx-1));
+        unsigned int ty0 = (unsigned int)btMax(fy0, Scalar(0));
+        unsigned int ty1 = (unsigned int)btMin(fy1, Scalar(nty-1));
+        
+        for(unsigned int ty=ty0; ty<=ty1; ++ty)
+            for(unsigned int tx=tx0; tx<=tx1; ++tx)
+            {
+                unsigned int id = ty * ntx + tx;
+                if(tiles[id].body == nullptr)
+                {
+                    if(!load)
+                        continue;
+                    LoadTile(world, id);
+                }
+                tiles[id].used = updateId;
+            }
+    }
+}
+
+void TiledTerrain::LoadTile(btDynamicsWorld* world, unsigned int id)
+{
+    unsigned int tx = id % ntx;
+    unsigned int ty = id / ntx;
+    unsigned int w, h;
+    TileSize(tx, ty, w, h);
+    const float* heights = data + TileOffset(tx, ty);
+    
+    //Heightfield shape is centred at the middle of its height range
+    float minHeight = heights[0];
+    float maxHeight = heights[0];
+    for(size_t i=1; i<(size_t)w*h; ++i)
+    {
+        minHeight = heights[i] < minHeight ? heights[i] : minHeight;
+        maxHeight = heights[i] > maxHeight ? heights[i] : maxHeight;
+    }
+    
+    btHeightfieldTerrainShape* shape = new btHeightfieldTerrainShape(w, h, heights, Scalar(minHeight), Scalar(maxHeight), 2, false);
+    shape->setLocalScaling(Vector3(dx, dy, Scalar(1)));
+    shape->setUseDiamondSubdivision(true);
+    shape->setMargin(0);
+    
+    Vector3 centre((tx * tileSize + (w - 1)/Scalar(2)) * dx - dx * (nx - 1)/Scalar(2),
+                   (ty * tileSize + (h - 1)/Scalar(2)) * dy - dy * (ny - 1)/Scalar(2),
+                   (Scalar(minHeight) + Scalar(maxHeight))/Scalar(2));
+    btDefaultMotionState* motionState = new btDefaultMotionState(origin * Transform(IQ(), centre));
+    
+    btRigidBody::btRigidBodyConstructionInfo rigidBodyCI(Scalar(0), motionState, shape, Vector3(0,0,0));
+    rigidBodyCI.m_friction = rigidBodyCI.m_rollingFriction = rigidBodyCI.m_restitution = Scalar(0); //not used
+    rigidBodyCI.m_linearDamping = rigidBodyCI.m_angularDamping = Scalar(0); //not used
+    rigidBodyCI.m_linearSleepingThreshold = rigidBodyCI.m_angularSleepingThreshold = Scalar(0); //not used
+    rigidBodyCI.m_additionalDamping = false;
+    
+    btRigidBody* body = new btRigidBody(rigidBodyCI);
+    body->setUserPointer(this);
+    body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
+    world->addRigidBody(body, MASK_STATIC, MASK_DYNAMIC);
+    
+    tiles[id].shape = shape;
+    tiles[id].body = body;
+    loaded.push_back(id);
+}
+
+void TiledTerrain::EvictTile(btDynamicsWorld* world, unsigned int id)
+{
+    Tile& tile = tiles[id];
+    world->removeRigidBody(tile.body);
+    delete tile.body->getMotionState();
+    delete tile.body;
+    delete tile.shape;
+    tile.body = nullptr;
+    tile.shape = nullptr;
+    
+    //Release pages of the tile
+    unsigned int w, h;
+    TileSize(id % ntx, id / ntx, w, h);
+    size_t start = TILED_TERRAIN_HEADER_SIZE + sizeof(float) * TileOffset(id % ntx, id / ntx);
+    size_t end = start + sizeof(float) * w * h;
+    start = (start + pageSize - 1)/pageSize * pageSize; //Do not touch pages shared with neighbours
+    end = end/pageSize * pageSize;
+    if(end > start)
+        madvise((char*)map + start, end - start, MADV_DONTNEED);
+}
+
+bool TiledTerrain::ConvertRawHeightmap(const std::string& rawPath, unsigned int nx, unsigned int ny, Scalar dx, Scalar dy,
+                                       unsigned int tileSize, const std::string& outputPath)
+{
+    if(nx < 2 || ny < 2 || tileSize == 0 || dx <= Scalar(0) || dy <= Scalar(0))
+    {
+        cError("Wrong parameters of the tiled terrain conversion!");
+        return false;
+    }
+    
+    //Map input
+    int fd = open(rawPath.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        cError("Failed to open raw heightmap file '%s'!", rawPath.c_str());
+        return false;
+    }
+    struct stat st;
+    size_t rawSize = sizeof(float) * (size_t)nx * ny;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < rawSize)
+    {
+        close(fd);
+        cError("Raw heightmap file '%s' is too small for %ux%u samples!", rawPath.c_str(), nx, ny);
+        return false;
+    }
+    void* rawMap = mmap(nullptr, rawSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(rawMap == MAP_FAILED)
+    {
+        cError("Failed to map raw heightmap file '%s'!", rawPath.c_str());
+        return false;
+    }
+    const float* raw = (const float*)rawMap;
+    
+    FILE* out = fopen(outputPath.c_str(), "wb");
+    if(out == nullptr)
+    {
+        munmap(rawMap, rawSize);
+        cError("Failed to create tiled terrain file '%s'!", outputPath.c_str());
+        return false;
+    }
+    
+    //Write header
+    uint32_t header[5] = {1, nx, ny, tileSize, 0};
+    double spacing[2] = {(double)dx, (double)dy};
+    fwrite("SFHT", 1, 4, out);
+    fwrite(header, sizeof(uint32_t), 5, out);
+    fwrite(spacing, sizeof(double), 2, out);
+    
+    //Write tiles, one row of tiles at a time
+    unsigned int ntx = (nx - 2)/tileSize + 1;
+    unsigned int nty = (ny - 2)/tileSize + 1;
+    for(unsigned int ty=0; ty<nty; ++ty)
+    {
+        unsigned int h = btMin(tileSize, ny - 1 - ty * tileSize) + 1;
+        for(unsigned int tx=0; tx<ntx; ++tx)
+        {
+            unsigned int w = btMin(tileSize, nx - 1 - tx * tileSize) + 1;
+            for(unsigned int r=0; r<h; ++r)
+                fwrite(raw + (size_t)(ty * tileSize + r) * nx + tx * tileSize, sizeof(float), w, out);
+        }
+        madvise(rawMap, rawSize, MADV_DONTNEED); //Rows of tiles are not revisited
+    }
+    
+    bool ok = ferror(out) == 0;
+    ok = fclose(out) == 0 && ok;
+    munmap(rawMap, rawSize);
+    if(!ok)
+        cError("Failed to write tiled terrain file '%s'!", outputPath.c_str());
+    return ok;
+}
+
+}
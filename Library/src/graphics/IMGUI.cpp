@@ -113,7 +113,7 @@ void IMGUI::Resize(GLint windowWidth, GLint windowHeight)
     OpenGLPrinter::SetWindowSize(windowW, windowH);
     
     //Destroy translucent background textures and framebuffers
-    if(translucentTexture[0] != 0) glDeleteTextures(2, translucentTexture);
+    if(translucentTexture[0] != 0) OpenGLContent::DeleteTextures(2, translucentTexture);
     if(translucentFBO != 0) glDeleteFramebuffers(1, &translucentFBO);
     
     //Create translucent background resources
@@ -150,9 +150,9 @@ IMGUI::~IMGUI()
     if(plainPrinter != NULL)
         delete plainPrinter;
     if(logoTexture > 0)
-        glDeleteTextures(1, &logoTexture);
+        OpenGLContent::DeleteTextures(1, &logoTexture);
     if(guiTexture > 0) 
-        glDeleteTextures(1, &guiTexture);
+        OpenGLContent::DeleteTextures(1, &guiTexture);
     if(downsampleShader != NULL)
         delete downsampleShader;
     if(gaussianShader != NULL)
@@ -162,7 +162,7 @@ IMGUI::~IMGUI()
     if(guiShader[1] != NULL)
         delete guiShader[1];
     if(translucentTexture[0] > 0)
-        glDeleteTextures(2, translucentTexture);
+        OpenGLContent::DeleteTextures(2, translucentTexture);
     if(guiVAO > 0)
         glDeleteVertexArrays(1, &guiVAO);
     if(translucentFBO > 0)
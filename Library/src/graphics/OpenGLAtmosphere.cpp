@@ -182,12 +182,12 @@ OpenGLAtmosphere::OpenGLAtmosphere(const std::string& modelFilename, RenderQuali
 OpenGLAtmosphere::~OpenGLAtmosphere()
 {
     for(unsigned short i=0; i< AtmosphereTextures::TEXTURE_COUNT; ++i)
-        if(textures[i] != 0) glDeleteTextures(1, &textures[i]);
+        if(textures[i] != 0) OpenGLContent::DeleteTextures(1, &textures[i]);
 
     if(skySunShader != NULL) delete skySunShader;
     //if(atmosphereAPI > 0) glDeleteShader(atmosphereAPI);
 
-    if(sunShadowmapArray != 0) glDeleteTextures(1, &sunShadowmapArray);
+    if(sunShadowmapArray != 0) OpenGLContent::DeleteTextures(1, &sunShadowmapArray);
 
     delete [] sunShadowFrustum;
     delete [] sunShadowCPM;
@@ -217,14 +217,14 @@ OpenGLCamera::OpenGLCamera(GLint x, GLint y, GLint width, GLint height, glm::vec
 
 OpenGLCamera::~OpenGLCamera()
 {
-    glDeleteTextures(2, renderColorTex);
-    glDeleteTextures(1, &renderViewNormalTex);
-    glDeleteTextures(1, &renderDepthStencilTex);
-    glDeleteTextures(1, &exposureTex);
-    glDeleteTextures(2, linearDepthTex);
-    glDeleteTextures(2, postprocessTex);
-    glDeleteTextures(1, &postprocessStencilTex);
-    glDeleteTextures(2, quaterPostprocessTex);
+    OpenGLContent::DeleteTextures(2, renderColorTex);
+    OpenGLContent::DeleteTextures(1, &renderViewNormalTex);
+    OpenGLContent::DeleteTextures(1, &renderDepthStencilTex);
+    OpenGLContent::DeleteTextures(1, &exposureTex);
+    OpenGLContent::DeleteTextures(2, linearDepthTex);
+    OpenGLContent::DeleteTextures(2, postprocessTex);
+    OpenGLContent::DeleteTextures(1, &postprocessStencilTex);
+    OpenGLContent::DeleteTextures(2, quaterPostprocessTex);
 
     glDeleteFramebuffers(1, &renderFBO);
     glDeleteFramebuffers(1, &postprocessFBO);
@@ -235,10 +235,10 @@ OpenGLCamera::~OpenGLCamera()
 
     if(aoFactor > 0)
     {
-        glDeleteTextures(1, &aoResultTex);
-        glDeleteTextures(1, &aoBlurTex);
-        glDeleteTextures(1, &aoDepthArrayTex);
-        glDeleteTextures(1, &aoResultArrayTex);
+        OpenGLContent::DeleteTextures(1, &aoResultTex);
+        OpenGLContent::DeleteTextures(1, &aoBlurTex);
+        OpenGLContent::DeleteTextures(1, &aoDepthArrayTex);
+        OpenGLContent::DeleteTextures(1, &aoResultArrayTex);
     
         glDeleteFramebuffers(1, &aoFinalFBO);
         glDeleteFramebuffers(1, &aoDeinterleaveFBO);
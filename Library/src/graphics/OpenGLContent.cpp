@@ -26,6 +26,10 @@
 #include "graphics/OpenGLContent.h"
 
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <cstring>
 #include <algorithm>
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
@@ -39,6 +43,7 @@
 #include "entities/forcefields/Atmosphere.h"
 #include "utils/SystemUtil.hpp"
 #include "utils/GeometryFileUtil.h"
+#include "utils/MeshCache.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -52,9 +57,14 @@
 namespace sf
 {
 
+std::mutex OpenGLContent::textureMutex;
+std::map<GLuint, size_t> OpenGLContent::textureMemory;
+size_t OpenGLContent::textureMemoryTotal = 0;
+
 OpenGLContent::OpenGLContent()
 {
     //Initialize members
+    bufferMemory = 0;
     baseVertexArray = 0;
     cubeBuf = 0;
     lightsUBO = 0;
@@ -499,9 +509,9 @@ void OpenGLContent::DestroyContent()
     for(size_t i=0; i<looks.size(); ++i)
     {
         if(looks[i].albedoTexture != 0)
-            glDeleteTextures(1, &looks[i].albedoTexture);
+            DeleteTextures(1, &looks[i].albedoTexture);
         if(looks[i].normalTexture != 0)
-            glDeleteTextures(1, &looks[i].normalTexture);
+            DeleteTextures(1, &looks[i].normalTexture);
     }
     looks.clear();
     lookNameManager.ClearNames();
@@ -513,6 +523,7 @@ void OpenGLContent::DestroyContent()
         glDeleteVertexArrays(1, &objects[i].vao);
     }	
     objects.clear();
+    bufferMemory = 0;
 
     for(size_t i=0; i<views.size(); ++i)
 		delete views[i];
@@ -1013,7 +1024,7 @@ void OpenGLContent::UseStandardLook(const glm::mat4& M)
     }
 }
 
-unsigned int OpenGLContent::BuildObject(Mesh* mesh)
+unsigned int OpenGLContent::BuildObject(const Mesh* mesh)
 {
     Object obj;
     
@@ -1048,6 +1059,7 @@ unsigned int OpenGLContent::BuildObject(Mesh* mesh)
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Face) * mesh->faces.size(), &mesh->faces[0].vertexID[0], GL_STATIC_DRAW);
     OpenGLState::BindVertexArray(0);
     
+    bufferMemory += mesh->getVertexSize() * mesh->getNumOfVertices() + sizeof(Face) * mesh->faces.size();
     objects.push_back(obj);
     return (unsigned int)objects.size()-1;
 }
@@ -1204,6 +1216,7 @@ GLuint OpenGLContent::LoadTexture(const std::string& filename, bool srgb, bool a
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glGenerateMipmap(GL_TEXTURE_2D);
     OpenGLState::UnbindTexture(TEX_BASE);
+    RegisterTexture(texture, (size_t)width * (size_t)height * (alpha ? 4 : 3) * 4 / 3);
     
     stbi_image_free(dataBuffer);
     
@@ -1300,9 +1313,86 @@ GLuint OpenGLContent::GenerateTexture(GLenum target, glm::uvec3 dimensions, GLen
     }
 
     OpenGLState::UnbindTexture(TEX_BASE);
+    
+    size_t bytes = getTexelSize(internalFormat) * dimensions.x;
+    if(target != GL_TEXTURE_1D)
+        bytes *= dimensions.y;
+    if(target == GL_TEXTURE_2D_ARRAY || target == GL_TEXTURE_3D)
+        bytes *= dimensions.z;
+    if(fm == FilteringMode::BILINEAR_MIPMAP || fm == FilteringMode::TRILINEAR)
+        bytes = bytes * 4 / 3;
+    RegisterTexture(texture, bytes);
     return texture;
 }
 
+void OpenGLContent::DeleteTextures(GLsizei n, const GLuint* textures)
+{
+    std::lock_guard<std::mutex> lock(textureMutex);
+    for(GLsizei i = 0; i < n; ++i)
+    {
+        auto it = textureMemory.find(textures[i]);
+        if(it != textureMemory.end())
+        {
+            textureMemoryTotal -= it->second;
+            textureMemory.erase(it);
+        }
+    }
+    glDeleteTextures(n, textures);
+}
+
+void OpenGLContent::RegisterTexture(GLuint texture, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(textureMutex);
+    size_t& entry = textureMemory[texture];
+    textureMemoryTotal += bytes - entry;
+    entry = bytes;
+}
+
+size_t OpenGLContent::getTextureMemoryUsage()
+{
+    std::lock_guard<std::mutex> lock(textureMutex);
+    return textureMemoryTotal;
+}
+
+size_t OpenGLContent::getBufferMemoryUsage() const
+{
+    return bufferMemory;
+}
+
+size_t OpenGLContent::getTexelSize(GLenum internalFormat)
+{
+    switch(internalFormat)
+    {
+        case GL_R8:
+            return 1;
+        case GL_RG8:
+        case GL_R16F:
+            return 2;
+        case GL_RGB8:
+        case GL_SRGB8:
+            return 3;
+        case GL_RGBA8:
+        case GL_RGBA8_SNORM:
+        case GL_SRGB8_ALPHA8:
+        case GL_RG16F:
+        case GL_R32F:
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH_COMPONENT32F:
+            return 4;
+        case GL_RGB16F:
+            return 6;
+        case GL_RGBA16F:
+        case GL_RG32F:
+            return 8;
+        case GL_RGB32F:
+            return 12;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
 GLuint OpenGLContent::GenerateFramebuffer(const std::vector<FBOTexture>& textures)
 {
     GLuint fbo;
@@ -2277,18 +2367,9 @@ Mesh* OpenGLContent::BuildTerrain(GLfloat* heightfield, int sizeX, int sizeY, GL
     return mesh;
 }
 
-Mesh* OpenGLContent::LoadMesh(const std::string& filename, GLfloat scale, bool smooth)
+std::shared_ptr<const Mesh> OpenGLContent::LoadMesh(const std::string& filename, GLfloat scale, bool smooth)
 {
-    Mesh* mesh = LoadGeometryFromFile(filename, scale);
-    CheckAndRepairFaceVertexOrder(mesh);
-
-    if(mesh == nullptr)
-        abort();
-    if(smooth)
-        SmoothNormals(mesh);
-    if(mesh->isTexturable())
-        ComputeTangents((TexturableMesh*)mesh);
-    return mesh;
+    return MeshCache::GetMesh(filename, scale, smooth); //Use MeshCache::CopyMesh to obtain a modifiable copy
 }
 
 void OpenGLContent::TransformMesh(Mesh* mesh, const Transform& T)
@@ -2451,6 +2532,71 @@ GLuint vertex4EdgeIco(std::map<std::pair<GLuint, GLuint>, GLuint>& lookup, Mesh*
     return inserted.first->second;
 }
 
+//Bitwise key of a vertex position, used to find vertices duplicated at seams
+struct PositionKey
+{
+    uint32_t bits[3];
+    
+    PositionKey(const glm::vec3& p)
+    {
+        glm::vec3 q = p + glm::vec3(0.f); //Avoid negative zeros
+        memcpy(bits, &q.x, sizeof(bits));
+    }
+    
+    bool operator==(const PositionKey& other) const
+    {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionKeyHash
+{
+    size_t operator()(const PositionKey& key) const
+    {
+        size_t h = std::hash<uint32_t>()(key.bits[0]);
+        for(unsigned int i=1; i<3; ++i)
+            h ^= std::hash<uint32_t>()(key.bits[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+GLuint appendVertex(Mesh* mesh, const GLuint* ids, unsigned int count)
+{
+    //Append a vertex interpolating the attributes of the specified vertices
+    GLfloat w = 1.f/(GLfloat)count;
+    if(mesh->isTexturable())
+    {
+        TexturableMesh* m = static_cast<TexturableMesh*>(mesh);
+        TexturableVertex vt;
+        glm::vec3 normal(0.f);
+        glm::vec3 tangent(0.f);
+        for(unsigned int i=0; i<count; ++i)
+        {
+            vt.pos += m->vertices[ids[i]].pos * w;
+            vt.uv += m->vertices[ids[i]].uv * w;
+            normal += m->vertices[ids[i]].normal;
+            tangent += m->vertices[ids[i]].tangent;
+        }
+        vt.normal = glm::normalize(normal);
+        vt.tangent = glm::normalize(tangent);
+        m->vertices.push_back(vt);
+    }
+    else
+    {
+        PlainMesh* m = static_cast<PlainMesh*>(mesh);
+        Vertex vt;
+        glm::vec3 normal(0.f);
+        for(unsigned int i=0; i<count; ++i)
+        {
+            vt.pos += m->vertices[ids[i]].pos * w;
+            normal += m->vertices[ids[i]].normal;
+        }
+        vt.normal = glm::normalize(normal);
+        m->vertices.push_back(vt);
+    }
+    return (GLuint)mesh->getNumOfVertices()-1;
+}
+
 GLuint vertex4Edge(std::map<std::pair<GLuint, GLuint>, GLuint>& lookup, Mesh* mesh, GLuint firstID, GLuint secondID)
 {
     std::map<std::pair<GLuint, GLuint>, GLuint>::key_type key(firstID, secondID);
@@ -2460,38 +2606,8 @@ GLuint vertex4Edge(std::map<std::pair<GLuint, GLuint>, GLuint>& lookup, Mesh* me
     auto inserted=lookup.insert({key, mesh->getNumOfVertices()});
     if(inserted.second)
     {
-        if(mesh->isTexturable())
-        {
-            TexturableMesh* m = static_cast<TexturableMesh*>(mesh);
-            glm::vec3 edge0 = m->vertices[firstID].pos;
-            glm::vec3 edge1 = m->vertices[secondID].pos;
-            glm::vec3 edge0n = m->vertices[firstID].normal;
-            glm::vec3 edge1n = m->vertices[secondID].normal;
-            glm::vec3 edge0t = m->vertices[firstID].tangent;
-            glm::vec3 edge1t = m->vertices[secondID].tangent;
-            glm::vec2 edge0uv = m->vertices[firstID].uv;
-            glm::vec2 edge1uv = m->vertices[secondID].uv;
-            
-            TexturableVertex vt;
-            vt.pos = (edge0 + edge1)/2.f;
-            vt.normal = glm::normalize(edge0n + edge1n);
-            vt.tangent = glm::normalize(edge0t + edge1t);
-            vt.uv = (edge0uv + edge1uv)/2.f;
-            m->vertices.push_back(vt);
-        }
-        else
-        {
-            PlainMesh* m = static_cast<PlainMesh*>(mesh);
-            glm::vec3 edge0 = m->vertices[firstID].pos;
-            glm::vec3 edge1 = m->vertices[secondID].pos;
-            glm::vec3 edge0n = m->vertices[firstID].normal;
-            glm::vec3 edge1n = m->vertices[secondID].normal;
-            
-            Vertex vt;
-            vt.pos = (edge0 + edge1)/2.f;
-            vt.normal = glm::normalize(edge0n + edge1n);
-            m->vertices.push_back(vt);
-        }
+        GLuint ids[2] = {firstID, secondID};
+        appendVertex(mesh, ids, 2);
     }
     
     return inserted.first->second;
@@ -2554,67 +2670,187 @@ void OpenGLContent::Subdivide(Mesh* mesh, bool icoMode)
 void OpenGLContent::Refine(Mesh* mesh, GLfloat sizeThreshold)
 {
     const GLfloat minArea = 0.01f*0.01f;
-    GLfloat avgFaceArea = std::max(ComputeAverageFaceArea(mesh), minArea);
-    size_t nSubdivided = 0;
-#ifdef DEBUG
+    size_t nVertBefore = mesh->getNumOfVertices();
     size_t nFaceBefore = mesh->faces.size();
-#endif
+    if(nFaceBefore == 0)
+        return;
     
+    //1. Find the number of subdivisions of each face.
+    //Subdivision preserves the total area, so the passes comparing faces with the average face area
+    //can be carried out on the original faces, whose children always have identical areas.
+    std::vector<double> area(nFaceBefore);
+    std::vector<unsigned char> level(nFaceBefore, 0);
+    double totalArea = 0.0;
+    #pragma omp parallel for reduction(+:totalArea)
+    for(size_t i=0; i<nFaceBefore; ++i)
+    {
+        area[i] = mesh->ComputeFaceArea(i);
+        totalArea += area[i];
+    }
+    
+    double nFaces = (double)nFaceBefore;
     while(1)
     {
+        double limit = sizeThreshold * std::max(totalArea/nFaces, (double)minArea);
+        double nAdded = 0.0;
+        #pragma omp parallel for reduction(+:nAdded)
+        for(size_t i=0; i<nFaceBefore; ++i)
+        {
+            if(area[i] > limit)
+            {
+                nAdded += 3.0 * std::pow(4.0, level[i]);
+                area[i] /= 4.0;
+                ++level[i];
+            }
+        }
+        if(nAdded == 0.0)
+            break;
+        nFaces += nAdded;
+    }
+    
+    //2. Subdivide faces, sharing midpoints between neighbours
+    auto edgeKey = [](GLuint a, GLuint b) { return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a; };
+    std::unordered_map<uint64_t, GLuint> midpoints; //Midpoints of edges defined by vertex ids
+    std::unordered_set<uint64_t> splitEdges; //Split edges defined by position ids (vertices can be duplicated at seams)
+    std::vector<GLuint> posId(mesh->getNumOfVertices());
+    std::unordered_map<PositionKey, GLuint, PositionKeyHash> positions;
+    
+    auto positionId = [&](GLuint v)
+    {
+        auto it = positions.insert({PositionKey(mesh->getVertexPos(v)), (GLuint)positions.size()});
+        return it.first->second;
+    };
+    for(GLuint i=0; i<(GLuint)posId.size(); ++i)
+        posId[i] = positionId(i);
+    
+    auto midpoint = [&](GLuint a, GLuint b)
+    {
+        auto it = midpoints.insert({edgeKey(a, b), (GLuint)mesh->getNumOfVertices()});
+        if(it.second)
+        {
+            GLuint ids[2] = {a, b};
+            appendVertex(mesh, ids, 2);
+            posId.push_back(positionId(it.first->second));
+        }
+        return it.first->second;
+    };
+    
+    std::vector<Face> faces = mesh->faces;
+    bool subdivide = true;
+    while(subdivide)
+    {
+        subdivide = false;
         std::vector<Face> newFaces;
+        std::vector<unsigned char> newLevel;
+        newFaces.reserve(faces.size() * 2);
+        newLevel.reserve(faces.size() * 2);
         
-        for(size_t i=0; i<mesh->faces.size(); ++i)
+        for(size_t i=0; i<faces.size(); ++i)
         {
-            if(mesh->ComputeFaceArea(i) > sizeThreshold * avgFaceArea)
+            if(level[i] == 0)
             {
-                GLuint mid[3];
-                std::map<std::pair<GLuint, GLuint>, GLuint> lookup;
-                
-                for(unsigned int edge = 0; edge<3; ++edge)
-                    mid[edge] = vertex4Edge(lookup, mesh, mesh->faces[i].vertexID[edge], mesh->faces[i].vertexID[(edge+1)%3]);
-                
-                Face f;
-                f.vertexID[0] = mesh->faces[i].vertexID[0];
-                f.vertexID[1] = mid[0];
-                f.vertexID[2] = mid[2];
-                newFaces.push_back(f);
-                
-                f.vertexID[0] = mesh->faces[i].vertexID[1];
-                f.vertexID[1] = mid[1];
-                f.vertexID[2] = mid[0];
-                newFaces.push_back(f);
-                
-                f.vertexID[0] = mesh->faces[i].vertexID[2];
-                f.vertexID[1] = mid[2];
-                f.vertexID[2] = mid[1];
-                newFaces.push_back(f);
-                
-                f.vertexID[0] = mid[0];
-                f.vertexID[1] = mid[1];
-                f.vertexID[2] = mid[2];
-                newFaces.push_back(f);
-                
-                ++nSubdivided;
+                newFaces.push_back(faces[i]);
+                newLevel.push_back(0);
+                continue;
             }
-            else
-                newFaces.push_back(mesh->faces[i]);
+            
+            const GLuint* v = faces[i].vertexID;
+            GLuint mid[3];
+            for(unsigned int edge = 0; edge<3; ++edge)
+            {
+                mid[edge] = midpoint(v[edge], v[(edge+1)%3]);
+                splitEdges.insert(edgeKey(posId[v[edge]], posId[v[(edge+1)%3]]));
+            }
+            
+            Face f[4];
+            f[0].vertexID[0] = v[0]; f[0].vertexID[1] = mid[0]; f[0].vertexID[2] = mid[2];
+            f[1].vertexID[0] = v[1]; f[1].vertexID[1] = mid[1]; f[1].vertexID[2] = mid[0];
+            f[2].vertexID[0] = v[2]; f[2].vertexID[1] = mid[2]; f[2].vertexID[2] = mid[1];
+            f[3].vertexID[0] = mid[0]; f[3].vertexID[1] = mid[1]; f[3].vertexID[2] = mid[2];
+            for(unsigned int h=0; h<4; ++h)
+            {
+                newFaces.push_back(f[h]);
+                newLevel.push_back(level[i]-1);
+            }
+            subdivide |= level[i] > 1;
+        }
+        faces.swap(newFaces);
+        level.swap(newLevel);
+    }
+    
+    //3. Remove T-junctions, triangulating faces with split neighbours
+    std::function<void(GLuint, GLuint, std::vector<GLuint>&)> hanging = [&](GLuint a, GLuint b, std::vector<GLuint>& chain)
+    {
+        if(splitEdges.find(edgeKey(posId[a], posId[b])) == splitEdges.end())
+            return;
+        GLuint m = midpoint(a, b);
+        hanging(a, m, chain);
+        chain.push_back(m);
+        hanging(m, b, chain);
+    };
+    
+    mesh->faces.clear();
+    mesh->faces.reserve(faces.size());
+    std::vector<GLuint> polygon;
+    std::vector<GLuint> chain[3];
+    for(size_t i=0; i<faces.size(); ++i)
+    {
+        const GLuint* v = faces[i].vertexID;
+        size_t nHanging = 0;
+        for(unsigned int edge = 0; edge<3; ++edge)
+        {
+            chain[edge].clear();
+            hanging(v[edge], v[(edge+1)%3], chain[edge]);
+            nHanging += chain[edge].size();
+        }
+        if(nHanging == 0)
+        {
+            mesh->faces.push_back(faces[i]);
+            continue;
         }
         
-        if(nSubdivided > 0)
+        //Fan from the corner opposite to the only split edge, or from the centroid
+        int split = -1;
+        for(int edge = 0; edge<3; ++edge)
+            if(!chain[edge].empty())
+                split = split == -1 ? edge : 3;
+        
+        Face f;
+        if(split < 3)
         {
-            mesh->faces.clear();
-            mesh->faces = newFaces;
-            avgFaceArea = std::max(ComputeAverageFaceArea(mesh), minArea);
-            nSubdivided = 0;
+            polygon.clear();
+            polygon.push_back(v[split]);
+            polygon.insert(polygon.end(), chain[split].begin(), chain[split].end());
+            polygon.push_back(v[(split+1)%3]);
+            f.vertexID[0] = v[(split+2)%3];
+            for(size_t h=0; h+1<polygon.size(); ++h)
+            {
+                f.vertexID[1] = polygon[h];
+                f.vertexID[2] = polygon[h+1];
+                mesh->faces.push_back(f);
+            }
         }
         else
-            break;
+        {
+            polygon.clear();
+            for(unsigned int edge = 0; edge<3; ++edge)
+            {
+                polygon.push_back(v[edge]);
+                polygon.insert(polygon.end(), chain[edge].begin(), chain[edge].end());
+            }
+            f.vertexID[0] = appendVertex(mesh, v, 3);
+            posId.push_back(positionId(f.vertexID[0]));
+            for(size_t h=0; h<polygon.size(); ++h)
+            {
+                f.vertexID[1] = polygon[h];
+                f.vertexID[2] = polygon[(h+1)%polygon.size()];
+                mesh->faces.push_back(f);
+            }
+        }
     }
     
-#ifdef DEBUG
-    cInfo("Mesh refined (%ld/%ld).", nFaceBefore, mesh->faces.size());
-#endif
+    cInfo("Mesh refined from %ld vertices and %ld faces to %ld vertices and %ld faces.", 
+          nVertBefore, nFaceBefore, mesh->getNumOfVertices(), mesh->faces.size());
 }
     
 void OpenGLContent::AABB(Mesh* mesh, glm::vec3& min, glm::vec3& max)
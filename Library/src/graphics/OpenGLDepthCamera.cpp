@@ -118,9 +118,9 @@ OpenGLDepthCamera::OpenGLDepthCamera(glm::vec3 eyePosition, glm::vec3 direction,
 
 OpenGLDepthCamera::~OpenGLDepthCamera()
 {
-    glDeleteTextures(1, &renderDepthTex);
+    OpenGLContent::DeleteTextures(1, &renderDepthTex);
     glDeleteFramebuffers(1, &renderFBO);
-    glDeleteTextures(1, &linearDepthTex);
+    OpenGLContent::DeleteTextures(1, &linearDepthTex);
     glDeleteFramebuffers(1, &linearDepthFBO);
 
     if(camera != nullptr)
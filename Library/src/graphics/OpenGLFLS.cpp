@@ -195,7 +195,7 @@ OpenGLFLS::~OpenGLFLS()
 {
     delete sonarOutputShader;
     delete sonarPostprocessShader;
-    glDeleteTextures(2, outputTex);
+    OpenGLContent::DeleteTextures(2, outputTex);
 }
 
 void OpenGLFLS::UpdateTransform()
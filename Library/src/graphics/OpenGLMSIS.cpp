@@ -169,7 +169,7 @@ OpenGLMSIS::~OpenGLMSIS()
 {
     delete sonarOutputShader;
     delete sonarUpdateShader;
-    glDeleteTextures(2, outputTex);
+    OpenGLContent::DeleteTextures(2, outputTex);
 }
 
 void OpenGLMSIS::UpdateTransform()
@@ -335,7 +335,7 @@ OpenGLOcean::~OpenGLOcean()
         delete shader.second;
     
     glDeleteFramebuffers(3, oceanFBOs);
-    glDeleteTextures(6, oceanTextures);
+    OpenGLContent::DeleteTextures(6, oceanTextures);
     glDeleteBuffers(1, &oceanCurrentsUBO);
     
     if(params.spectrum12 != NULL) delete [] params.spectrum12;
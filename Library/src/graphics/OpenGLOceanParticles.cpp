@@ -220,8 +220,8 @@ void OpenGLOceanParticles::Destroy()
 {
     if(updateShader != NULL) delete updateShader;
     if(renderShader != NULL) delete renderShader;
-    if(flakeTexture != 0) glDeleteTextures(1, &flakeTexture);
-    if(noiseTexture != 0) glDeleteTextures(1, &noiseTexture);
+    if(flakeTexture != 0) OpenGLContent::DeleteTextures(1, &flakeTexture);
+    if(noiseTexture != 0) OpenGLContent::DeleteTextures(1, &noiseTexture);
 }
     
 }
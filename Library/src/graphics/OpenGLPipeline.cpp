@@ -40,6 +40,7 @@
 #include "graphics/OpenGLLight.h"
 #include "graphics/OpenGLOceanParticles.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/TraceRecorder.h"
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
 #include "core/GraphicalSimulationApp.h"
@@ -91,7 +92,7 @@ OpenGLPipeline::~OpenGLPipeline()
     OpenGLLight::Destroy();
     delete content;
     
-    glDeleteTextures(1, &screenTex);
+    OpenGLContent::DeleteTextures(1, &screenTex);
     glDeleteFramebuffers(1, &screenFBO);
     SDL_DestroyMutex(drawingQueueMutex);
 }
@@ -156,9 +157,12 @@ void OpenGLPipeline::PerformDrawingQueueCopy(SimulationManager* sim)
     SDL_LockMutex(drawingQueueMutex);
 
     //Update vision sensor transforms and copy generated data to ensure consistency
-    glMemoryBarrier(GL_PIXEL_BUFFER_BARRIER_BIT);
-    for(unsigned int i=0; i < content->getViewsCount(); ++i)
-        content->getView(i)->UpdateTransform();
+    {
+        TraceScope trace("Sensor readback", "render");
+        glMemoryBarrier(GL_PIXEL_BUFFER_BARRIER_BIT);
+        for(unsigned int i=0; i < content->getViewsCount(); ++i)
+            content->getView(i)->UpdateTransform();
+    }
     //Update light transforms to ensure consistency
     for(unsigned int i=0; i < content->getLightsCount(); ++i)
         content->getLight(i)->UpdateTransform();
@@ -411,6 +415,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
     //Loop through all views -> trackballs, cameras, depth cameras...
     for(unsigned int i=0; i<updateCount; ++i)
     {  
+        TraceScope trace("View", "render");
         OpenGLState::EnableDepthTest();
         OpenGLState::EnableCullFace();
         OpenGLState::DisableBlend();
@@ -62,7 +62,7 @@ OpenGLRealCamera::~OpenGLRealCamera()
     {
         glDeleteFramebuffers(1, &cameraFBO);
         glDeleteBuffers(1, &cameraPBO);
-        glDeleteTextures(2, cameraColorTex);
+        OpenGLContent::DeleteTextures(2, cameraColorTex);
     }
 }
 
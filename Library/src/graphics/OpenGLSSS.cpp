@@ -186,7 +186,7 @@ OpenGLSSS::~OpenGLSSS()
     delete sonarOutputShader[0];
     delete sonarOutputShader[1];
     delete sonarShiftShader;
-    glDeleteTextures(3, outputTex);
+    OpenGLContent::DeleteTextures(3, outputTex);
 }
 
 void OpenGLSSS::UpdateTransform()
@@ -57,10 +57,10 @@ OpenGLSonar::OpenGLSonar(glm::vec3 eyePosition, glm::vec3 direction, glm::vec3 s
 
 OpenGLSonar::~OpenGLSonar()
 {
-    glDeleteTextures(1, &inputRangeIntensityTex);
+    OpenGLContent::DeleteTextures(1, &inputRangeIntensityTex);
     glDeleteRenderbuffers(1, &inputDepthRBO);
     glDeleteFramebuffers(1, &renderFBO);
-    glDeleteTextures(1, &displayTex);
+    OpenGLContent::DeleteTextures(1, &displayTex);
     glDeleteFramebuffers(1, &displayFBO);
     glDeleteVertexArrays(1, &displayVAO);
     glDeleteBuffers(1, &displayVBO);
@@ -34,15 +34,19 @@
 namespace sf
 {
     
-Contact::Contact(std::string uniqueName, Entity* entityA, Entity* entityB, unsigned int inclusiveHistoryLength)
+Contact::Contact(std::string uniqueName, Entity* entityA, Entity* entityB, unsigned int historyLength, unsigned int stepHistoryLength)
 {
     name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
     A = entityA;
     B = entityB;
-    historyLen = inclusiveHistoryLength;
+    steps.resize(stepHistoryLength > 0 ? stepHistoryLength : DEFAULT_CONTACT_HISTORY);
+    stepCount = 0;
+    recordPoints = true;
+    pointsLen = historyLength;
+    lastPoints = 0;
     displayMask = CONTACT_DISPLAY_NONE;
     newDataAvailable = false;
-    pointsLastBeg = points.begin();
+    ClearHistory();
 }
 
 Contact::~Contact()
@@ -84,15 +88,49 @@ bool Contact::isNewDataAvailable() const
     return newDataAvailable;
 }
 
+void Contact::setPointRecording(bool enabled, unsigned int historyLength)
+{
+    recordPoints = enabled;
+    pointsLen = historyLength;
+    if(!recordPoints)
+    {
+        points.clear();
+        lastPoints = 0;
+    }
+}
+
+bool Contact::isRecordingPoints() const
+{
+    return recordPoints;
+}
+
 void Contact::AddContactPoint(const btPersistentManifold* manifold, bool swapped, Scalar dt)
 {
-    size_t added = 0;
+    Scalar sign = swapped ? Scalar(1.) : Scalar(-1.);
     for(int i=0; i<manifold->getNumContacts(); ++i)
     {
         const btManifoldPoint& mp = manifold->getContactPoint(i);
+        ContactInfo* cInfo = (ContactInfo*)mp.m_userPersistentData;
         Vector3 locationA = swapped ? mp.getPositionWorldOnB() : mp.getPositionWorldOnA();
-        Vector3 normalForceA = (swapped ? Scalar(1.) : Scalar(-1.)) * mp.m_normalWorldOnB * mp.getAppliedImpulse() / dt;
-
+        Vector3 locationB = swapped ? mp.getPositionWorldOnA() : mp.getPositionWorldOnB();
+        Vector3 normalForceA = sign * mp.m_normalWorldOnB * mp.getAppliedImpulse() / dt;
+        Vector3 slippingVelocityA = -sign * cInfo->slip;
+        
+        //Aggregation
+        Scalar weight = normalForceA.length();
+        ++current.numOfPoints;
+        current.centroidA += weight * locationA;
+        current.centroidB += weight * locationB;
+        current.netForceA += normalForceA;
+        current.slippingVelocityA += slippingVelocityA;
+        current.maxPenetration = btMax(current.maxPenetration, -mp.getDistance());
+        sumLocationA += locationA;
+        sumLocationB += locationB;
+        sumWeight += weight;
+        
+        if(!recordPoints)
+            continue;
+        
         //Filtering
         if(points.size() > 0
            && (locationA - points.back().locationA).length2() < (Scalar(0.001)*Scalar(0.001)) //Closer than 1 mm from the last point
@@ -101,31 +139,116 @@ void Contact::AddContactPoint(const btPersistentManifold* manifold, bool swapped
 
         ContactPoint p;
         p.locationA = locationA;
-        p.locationB = swapped ? mp.getPositionWorldOnA() : mp.getPositionWorldOnB();
-        ContactInfo* cInfo = (ContactInfo*)mp.m_userPersistentData;
-        p.slippingVelocityA = (swapped ? Scalar(-1.) : Scalar(1.)) * cInfo->slip;
+        p.locationB = locationB;
+        p.slippingVelocityA = slippingVelocityA;
         p.normalForceA = normalForceA;
-        AddContactPoint(p);
-        ++added;
+        RecordPoint(p);
+        ++currentPoints;
     }
-    pointsLastBeg = points.end()-added; // Save iterator to the beginning of new points
 }
 
 void Contact::AddContactPoint(ContactPoint p)
 {
-    //historyLen = 0 means "full history"
-    if(historyLen > 0 && points.size() == historyLen)
-        points.pop_front();
-
+    if(!recordPoints)
+        return;
+    
     p.timeStamp = SimulationApp::getApp()->getSimulationManager()->getSimulationTime();
+    RecordPoint(p);
+    newDataAvailable = true;
+}
+
+void Contact::RecordPoint(const ContactPoint& p)
+{
+    //pointsLen = 0 means "full history"
+    if(pointsLen > 0 && points.size() >= pointsLen)
+        points.pop_front();
     points.push_back(p);
+}
+
+void Contact::StepCompleted(Scalar time)
+{
+    if(current.numOfPoints == 0)
+        return;
     
+    //Stamp the points recorded in this step
+    currentPoints = std::min(currentPoints, points.size());
+    for(size_t i=points.size()-currentPoints; i<points.size(); ++i)
+        points[i].timeStamp = time;
+    lastPoints = currentPoints;
+    
+    //Finalize aggregated data
+    Scalar n = Scalar(current.numOfPoints);
+    if(sumWeight > SIMD_EPSILON)
+    {
+        current.centroidA /= sumWeight;
+        current.centroidB /= sumWeight;
+    }
+    else
+    {
+        current.centroidA = sumLocationA / n;
+        current.centroidB = sumLocationB / n;
+    }
+    current.slippingVelocityA /= n;
+    current.timeStamp = time;
+    steps[stepCount % steps.size()] = current;
+    ++stepCount;
     newDataAvailable = true;
+    ResetStep();
+}
+
+void Contact::ResetStep()
+{
+    current.timeStamp = Scalar(0);
+    current.numOfPoints = 0;
+    current.centroidA.setZero();
+    current.centroidB.setZero();
+    current.netForceA.setZero();
+    current.slippingVelocityA.setZero();
+    current.maxPenetration = Scalar(0);
+    sumLocationA.setZero();
+    sumLocationB.setZero();
+    sumWeight = Scalar(0);
+    currentPoints = 0;
 }
 
 void Contact::ClearHistory()
 {
+    stepCount = 0;
     points.clear();
+    lastPoints = 0;
+    ResetStep();
+    newDataAvailable = false;
+}
+
+size_t Contact::getNumOfSteps() const
+{
+    return (size_t)std::min<uint64_t>(stepCount, steps.size());
+}
+
+const ContactStepData& Contact::getStep(size_t index) const
+{
+    return steps[(stepCount - getNumOfSteps() + index) % steps.size()];
+}
+
+ContactStepData Contact::getLastStep() const
+{
+    if(stepCount > 0)
+        return steps[(stepCount-1) % steps.size()];
+    
+    ContactStepData empty;
+    empty.timeStamp = Scalar(0);
+    empty.numOfPoints = 0;
+    empty.centroidA = empty.centroidB = empty.netForceA = empty.slippingVelocityA = V0();
+    empty.maxPenetration = Scalar(0);
+    return empty;
+}
+
+std::vector<ContactStepData> Contact::getStepHistory() const
+{
+    std::vector<ContactStepData> history(getNumOfSteps());
+    for(size_t i=0; i<history.size(); ++i)
+        history[i] = getStep(i);
+    return history;
 }
 
 const std::deque<ContactPoint>& Contact::getHistory()
@@ -133,9 +256,15 @@ const std::deque<ContactPoint>& Contact::getHistory()
     return points;
 }
 
+size_t Contact::getHistoryMemoryUsage() const
+{
+    return steps.capacity() * sizeof(ContactStepData) + points.size() * sizeof(ContactPoint);
+}
+
 void Contact::SaveContactDataToOctaveFile(const std::string& path, bool includeTime)
 {
-    if(points.size() == 0)
+    size_t nRows = points.size() > 0 ? points.size() : getNumOfSteps();
+    if(nRows == 0)
         return;
     
     //build data structure
@@ -145,25 +274,43 @@ void Contact::SaveContactDataToOctaveFile(const std::string& path, bool includeT
     it->name = A->getName() + "_" + B->getName();
     it->type = DATA_MATRIX;
     
-    btMatrixXu* matrix = new btMatrixXu((unsigned int)points.size(), includeTime ? 10 : 9);
+    btMatrixXu* matrix = new btMatrixXu((unsigned int)nRows, includeTime ? 10 : 9);
     it->value = matrix;
     
     int offset = includeTime ? 1 : 0;
     
-    for(unsigned int i = 0; i < points.size(); ++i)
+    for(unsigned int i = 0; i < nRows; ++i)
     {
+        Scalar t;
+        Vector3 loc, slip, force;
+        if(points.size() > 0)
+        {
+            t = points[i].timeStamp;
+            loc = points[i].locationA;
+            slip = points[i].slippingVelocityA;
+            force = points[i].normalForceA;
+        }
+        else
+        {
+            const ContactStepData& step = getStep(i);
+            t = step.timeStamp;
+            loc = step.centroidA;
+            slip = step.slippingVelocityA;
+            force = step.netForceA;
+        }
+        
         if(includeTime)
-            matrix->setElem(i, 0, points[i].timeStamp);
+            matrix->setElem(i, 0, t);
         
-        matrix->setElem(i, offset, points[i].locationA.x());
-        matrix->setElem(i, offset + 1, points[i].locationA.y());
-        matrix->setElem(i, offset + 2, points[i].locationA.z());
-        matrix->setElem(i, offset + 3, points[i].slippingVelocityA.x());
-        matrix->setElem(i, offset + 4, points[i].slippingVelocityA.y());
-        matrix->setElem(i, offset + 5, points[i].slippingVelocityA.z());
-        matrix->setElem(i, offset + 6, points[i].normalForceA.x());
-        matrix->setElem(i, offset + 7, points[i].normalForceA.y());
-        matrix->setElem(i, offset + 8, points[i].normalForceA.z());
+        matrix->setElem(i, offset, loc.x());
+        matrix->setElem(i, offset + 1, loc.y());
+        matrix->setElem(i, offset + 2, loc.z());
+        matrix->setElem(i, offset + 3, slip.x());
+        matrix->setElem(i, offset + 4, slip.y());
+        matrix->setElem(i, offset + 5, slip.z());
+        matrix->setElem(i, offset + 6, force.x());
+        matrix->setElem(i, offset + 7, force.y());
+        matrix->setElem(i, offset + 8, force.z());
     }
     
     data.addItem(it);
@@ -176,56 +323,59 @@ std::vector<Renderable> Contact::Render()
 {
     std::vector<Renderable> items(0);
     
-    if(points.size() == 0)
+    if(stepCount == 0)
         return items;
     
-    //Drawing points
-    /*if(displayMask & CONTACT_DISPLAY_LAST_A)
-        vertices.push_back(glm::vec3((GLfloat)points.back().locationA.getX(), (GLfloat)points.back().locationA.getY(), (GLfloat)points.back().locationA.getZ()));
-    
-    if(displayMask & CONTACT_DISPLAY_LAST_B)
-        vertices.push_back(glm::vec3((GLfloat)points.back().locationB.getX(), (GLfloat)points.back().locationB.getY(), (GLfloat)points.back().locationB.getZ()));
-    
-    OpenGLContent::getInstance()->DrawPrimitives(PrimitiveType::POINTS, vertices, CONTACT_COLOR);*/
+    ContactStepData last = getLastStep();
     
     //Drawing lines
     std::vector<glm::vec3> vertices;
     
     if(displayMask & CONTACT_DISPLAY_LAST_SLIP_VELOCITY_A)
     {
-        Vector3 p1 = points.back().locationA;
-        Vector3 p2 = points.back().locationA + points.back().slippingVelocityA;
-        vertices.push_back(glm::vec3((GLfloat)p1.getX(), (GLfloat)p1.getY(), (GLfloat)p1.getZ()));
-        vertices.push_back(glm::vec3((GLfloat)p2.getX(), (GLfloat)p2.getY(), (GLfloat)p2.getZ()));
+        vertices.push_back(glVectorFromVector(last.centroidA));
+        vertices.push_back(glVectorFromVector(last.centroidA + last.slippingVelocityA));
     }
     
     if(displayMask & CONTACT_DISPLAY_LAST_SLIP_VELOCITY_B)
     {
-        Vector3 p1 = points.back().locationB;
-        Vector3 p2 = points.back().locationB - points.back().slippingVelocityA;
-        vertices.push_back(glm::vec3((GLfloat)p1.getX(), (GLfloat)p1.getY(), (GLfloat)p1.getZ()));
-        vertices.push_back(glm::vec3((GLfloat)p2.getX(), (GLfloat)p2.getY(), (GLfloat)p2.getZ()));
+        vertices.push_back(glVectorFromVector(last.centroidB));
+        vertices.push_back(glVectorFromVector(last.centroidB - last.slippingVelocityA));
     }
     
-    if(displayMask & CONTACT_DISPLAY_NORMAL_FORCE_A)
+    if(displayMask & (CONTACT_DISPLAY_NORMAL_FORCE_A | CONTACT_DISPLAY_NORMAL_FORCE_B))
     {
-        for(auto it=pointsLastBeg; it != points.end(); ++it)
+        bool forceA = displayMask & CONTACT_DISPLAY_NORMAL_FORCE_A;
+        bool forceB = displayMask & CONTACT_DISPLAY_NORMAL_FORCE_B;
+        
+        if(recordPoints) //Forces of the points recorded in the last step
         {
-            Vector3 p1 = (*it).locationA;
-            Vector3 p2 = (*it).locationA + (*it).normalForceA;
-            vertices.push_back(glm::vec3((GLfloat)p1.getX(), (GLfloat)p1.getY(), (GLfloat)p1.getZ()));
-            vertices.push_back(glm::vec3((GLfloat)p2.getX(), (GLfloat)p2.getY(), (GLfloat)p2.getZ()));
+            for(size_t i = points.size() - std::min(lastPoints, points.size()); i < points.size(); ++i)
+            {
+                if(forceA)
+                {
+                    vertices.push_back(glVectorFromVector(points[i].locationA));
+                    vertices.push_back(glVectorFromVector(points[i].locationA + points[i].normalForceA));
+                }
+                if(forceB)
+                {
+                    vertices.push_back(glVectorFromVector(points[i].locationB));
+                    vertices.push_back(glVectorFromVector(points[i].locationB - points[i].normalForceA));
+                }
+            }
         }
-    }
-    
-    if(displayMask & CONTACT_DISPLAY_NORMAL_FORCE_B)
-    {
-        for(auto it=pointsLastBeg; it != points.end(); ++it)
+        else //Net force applied at the centroid
         {
-            Vector3 p1 = (*it).locationB;
-            Vector3 p2 = (*it).locationB - (*it).normalForceA;
-            vertices.push_back(glm::vec3((GLfloat)p1.getX(), (GLfloat)p1.getY(), (GLfloat)p1.getZ()));
-            vertices.push_back(glm::vec3((GLfloat)p2.getX(), (GLfloat)p2.getY(), (GLfloat)p2.getZ()));
+            if(forceA)
+            {
+                vertices.push_back(glVectorFromVector(last.centroidA));
+                vertices.push_back(glVectorFromVector(last.centroidA + last.netForceA));
+            }
+            if(forceB)
+            {
+                vertices.push_back(glVectorFromVector(last.centroidB));
+                vertices.push_back(glVectorFromVector(last.centroidB - last.netForceA));
+            }
         }
     }
     
@@ -238,32 +388,25 @@ std::vector<Renderable> Contact::Render()
         items.push_back(item);
     }
         
-    //Drawing line strips
-    if(displayMask & CONTACT_DISPLAY_PATH_A)
+    //Drawing paths (contact points if recorded, otherwise centroids)
+    for(unsigned int b = 0; b < 2; ++b)
     {
-        Renderable item;
-        item.model = glm::mat4(1.f);
-        item.type = RenderableType::SENSOR_POINTS;
-        
-        for(size_t i = 0; i < points.size(); ++i)
-        {	
-            Vector3 p = points[i].locationA;
-            item.points.push_back(glm::vec3((GLfloat)p.getX(), (GLfloat)p.getY(), (GLfloat)p.getZ()));
-        }
+        if(!(displayMask & (b == 0 ? CONTACT_DISPLAY_PATH_A : CONTACT_DISPLAY_PATH_B)))
+            continue;
         
-        items.push_back(item);
-    }
-    
-    if(displayMask & CONTACT_DISPLAY_PATH_B)
-    {
         Renderable item;
         item.model = glm::mat4(1.f);
         item.type = RenderableType::SENSOR_POINTS;
         
-        for(size_t i = 0; i < points.size(); ++i)
-        {	
-            Vector3 p = points[i].locationB;
-            item.points.push_back(glm::vec3((GLfloat)p.getX(), (GLfloat)p.getY(), (GLfloat)p.getZ()));
+        if(points.size() > 0)
+        {
+            for(size_t i = 0; i < points.size(); ++i)
+                item.points.push_back(glVectorFromVector(b == 0 ? points[i].locationA : points[i].locationB));
+        }
+        else
+        {
+            for(size_t i = 0; i < getNumOfSteps(); ++i)
+                item.points.push_back(glVectorFromVector(b == 0 ? getStep(i).centroidA : getStep(i).centroidB));
         }
         
         items.push_back(item);
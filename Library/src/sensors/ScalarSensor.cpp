@@ -72,6 +72,14 @@ const std::vector<Sample>* ScalarSensor::getHistory()
     return historyCopy;
 }
 
+size_t ScalarSensor::getHistoryMemoryUsage()
+{
+    SDL_LockMutex(updateMutex);
+    size_t bytes = history.size() * (sizeof(Sample*) + sizeof(Sample) + getNumOfChannels() * sizeof(Scalar));
+    SDL_UnlockMutex(updateMutex);
+    return bytes;
+}
+
 unsigned short ScalarSensor::getNumOfChannels() const
 {
     return channels.size();
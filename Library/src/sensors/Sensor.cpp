@@ -30,6 +30,7 @@
 #include "core/Console.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "utils/MeshCache.h"
 
 namespace sf
 {
@@ -107,13 +108,12 @@ void Sensor::setVisual(const std::string& meshFilename, Scalar scale, const std:
     if(!SimulationApp::getApp()->hasGraphics())
         return;
 
-    Mesh* mesh = OpenGLContent::LoadMesh(meshFilename, scale, false);
+    std::shared_ptr<const Mesh> mesh = MeshCache::GetMesh(meshFilename, scale, false);
     if(mesh == nullptr)
         return;
 
-    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(mesh);
+    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(mesh.get());
     lookId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->getLookId(look);
-    delete mesh;
 }
 
 void Sensor::Reset()
@@ -122,6 +122,10 @@ void Sensor::Reset()
     InternalUpdate(1.); //time delta should not affect initial measurement!!!
 }
 
+void Sensor::ResolveDependencies()
+{
+}
+
 void Sensor::Update(Scalar dt)
 {
     if(!enabled)
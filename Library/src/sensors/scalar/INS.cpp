@@ -58,6 +58,9 @@ INS::INS(std::string uniqueName, Scalar frequency, int historyLength) : LinkSens
     gpsName = "";
     dvlName = "";
     pressName = "";
+    gps = nullptr;
+    dvl = nullptr;
+    press = nullptr;
     imuNoise = false;
     out = I4();
 }
@@ -72,10 +75,22 @@ void INS::Reset()
     SimulationApp::getApp()->getSimulationManager()->getNED()->Ned2Geodetic(0.0, 0.0, 0.0, latitude, longitude, height);
 }
 
+void INS::ResolveDependencies()
+{
+    SimulationManager* sm = SimulationApp::getApp()->getSimulationManager();
+    gps = gpsName != "" ? dynamic_cast<GPS*>(sm->getSensor(gpsName)) : nullptr;
+    dvl = dvlName != "" ? dynamic_cast<DVL*>(sm->getSensor(dvlName)) : nullptr;
+    press = pressName != "" ? dynamic_cast<Pressure*>(sm->getSensor(pressName)) : nullptr;
+}
+
 void INS::InternalUpdate(Scalar dt)
 {
     Scalar now = SimulationApp::getApp()->getSimulationManager()->getSimulationTime();
     
+    //Look for the external sensors that were not found yet (e.g. sensors of robots added during the simulation)
+    if((gps == nullptr && gpsName != "") || (dvl == nullptr && dvlName != "") || (press == nullptr && pressName != ""))
+        ResolveDependencies();
+    
     //--- internal sensors
     //get sensor frame in world
     Transform imuTrans = getSensorFrame();
@@ -106,8 +121,7 @@ void INS::InternalUpdate(Scalar dt)
     velocity += acc * dt; //In body frame (accumulated velocity)
     
     //--- external sensors
-    DVL* dvl;
-    if(dvlName != "" && (dvl = (DVL*)SimulationApp::getApp()->getSimulationManager()->getSensor(dvlName)) != nullptr) //Correct velocities
+    if(dvl != nullptr) //Correct velocities
     {
         Sample s = dvl->getLastSample();
         Scalar ts = s.getTimestamp();
@@ -126,8 +140,7 @@ void INS::InternalUpdate(Scalar dt)
     Vector3 dp = velocity * dt; //In body frame
     ned += imuTrans.getBasis() * dp; //In NED frame
     
-    GPS* gps;
-    if(gpsName != "" && (gps = (GPS*)SimulationApp::getApp()->getSimulationManager()->getSensor(gpsName)) != nullptr) //Correct global position
+    if(gps != nullptr) //Correct global position
     {
         Sample s = gps->getLastSample();
         Scalar ts = s.getTimestamp();
@@ -139,8 +152,7 @@ void INS::InternalUpdate(Scalar dt)
         }
     }
 
-    Pressure* press;
-    if(pressName != "" && (press = (Pressure*)SimulationApp::getApp()->getSimulationManager()->getSensor(pressName)) != nullptr) //Correct depth
+    if(press != nullptr) //Correct depth
     {
         Sample s = press->getLastSample();
         Scalar ts = s.getTimestamp();
@@ -182,16 +194,19 @@ void INS::InternalUpdate(Scalar dt)
 void INS::ConnectGPS(const std::string& name)
 {
     gpsName = name;
+    ResolveDependencies();
 }
 
 void INS::ConnectDVL(const std::string& name)
 {
     dvlName = name;
+    ResolveDependencies();
 }
 
 void INS::ConnectPressure(const std::string& name)
 {
     pressName = name;
+    ResolveDependencies();
 }
 
 void INS::setOutputFrame(const Transform& T)
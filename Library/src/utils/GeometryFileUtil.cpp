@@ -26,8 +26,20 @@
 #include "utils/GeometryFileUtil.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
 #include "core/SimulationApp.h"
 #include "utils/SystemUtil.hpp"
+#include "LinearMath/btConvexHullComputer.h"
+
+#define DECOMPOSITION_CANDIDATE_PLANES 16 //Number of candidate splitting planes per axis
 
 namespace sf
 {
@@ -47,252 +59,593 @@ Mesh* LoadGeometryFromFile(const std::string& path, GLfloat scale)
     return mesh;
 }
 
-Mesh* LoadOBJ(const std::string& path, GLfloat scale)
+//File parsing helpers
+static const char* MapGeometryFile(const std::string& path, size_t& size)
 {
-    //Read OBJ data
-    FILE* file = fopen(path.c_str(), "rb");
-    
-    if(file == NULL)
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0)
     {
+        if(fd >= 0) close(fd);
         cCritical("Failed to open geometry file: %s", path.c_str());
         return nullptr;
     }
     
-    cInfo("Loading geometry from: %s", path.c_str());
+    size = (size_t)st.st_size;
+    void* map = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        cCritical("Failed to map geometry file: %s", path.c_str());
+        return nullptr;
+    }
+    if(map != nullptr)
+        madvise(map, size, MADV_SEQUENTIAL);
+    return (const char*)map;
+}
+
+static void UnmapGeometryFile(const char* data, size_t size)
+{
+    if(data != nullptr)
+        munmap((void*)data, size);
+}
+
+static inline const char* SkipSpaces(const char* c, const char* end)
+{
+    while(c < end && (*c == ' ' || *c == '\t'))
+        ++c;
+    return c;
+}
+
+static inline const char* SkipLine(const char* c, const char* end)
+{
+    const char* nl = (const char*)memchr(c, '\n', end - c);
+    return nl == nullptr ? end : nl + 1;
+}
+
+static const char* ParseFloat(const char* c, const char* end, GLfloat& value)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    c = SkipSpaces(c, end);
+    bool negative = false;
+    if(c < end && (*c == '-' || *c == '+'))
+        negative = *c++ == '-';
+    
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    for(; c < end && *c >= '0' && *c <= '9'; ++c)
+    {
+        if(digits < 19) { mantissa = mantissa * 10 + (uint64_t)(*c - '0'); ++digits; }
+        else ++exponent; //Digits beyond double precision
+    }
+    if(c < end && *c == '.')
+    {
+        for(++c; c < end && *c >= '0' && *c <= '9'; ++c)
+        {
+            if(digits < 19) { mantissa = mantissa * 10 + (uint64_t)(*c - '0'); ++digits; --exponent; }
+        }
+    }
+    if(c < end && (*c == 'e' || *c == 'E'))
+    {
+        ++c;
+        bool negExp = false;
+        if(c < end && (*c == '-' || *c == '+'))
+            negExp = *c++ == '-';
+        int e = 0;
+        for(; c < end && *c >= '0' && *c <= '9'; ++c)
+            if(e < 1000) e = e * 10 + (*c - '0');
+        exponent += negExp ? -e : e;
+    }
     
-    char line[1024];
+    double v = (double)mantissa;
+    if(exponent < 0)
+        v = exponent >= -22 ? v / pow10[-exponent] : v * std::pow(10.0, exponent);
+    else if(exponent > 0)
+        v = exponent <= 22 ? v * pow10[exponent] : v * std::pow(10.0, exponent);
+    value = (GLfloat)(negative ? -v : v);
+    return c;
+}
+
+//OBJ parsing helpers
+struct OBJCorner
+{
+    int32_t v, vt, vn; //0-based indices (-1 if missing)
+    uint8_t relative; //Bits marking indices relative to the beginning of the chunk (resolved after merging chunks)
+};
+
+struct OBJChunk
+{
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
     std::vector<glm::vec2> uvs;
-    Mesh* mesh_ = nullptr;
-    int64_t start = GetTimeInMicroseconds();
+    std::vector<OBJCorner> corners; //Triangle corners (3 per face)
+};
+
+struct OBJCornerHash
+{
+    size_t operator()(const OBJCorner& c) const
+    {
+        uint64_t h = (uint64_t)(uint32_t)c.v * 0x9E3779B97F4A7C15ull;
+        h ^= ((uint64_t)(uint32_t)c.vn + 0x7F4A7C15ull) * 0xC2B2AE3D27D4EB4Full;
+        h ^= ((uint64_t)(uint32_t)c.vt + 0x165667B1ull) * 0x165667B19E3779F9ull;
+        return (size_t)(h ^ (h >> 29));
+    }
+};
+
+struct OBJCornerEqual
+{
+    bool operator()(const OBJCorner& a, const OBJCorner& b) const
+    {
+        return a.v == b.v && a.vt == b.vt && a.vn == b.vn;
+    }
+};
+
+static inline const char* OBJParseIndex(const char* c, const char* end, size_t localCount, int32_t& index, uint8_t& relative, uint8_t bit)
+{
+    bool negative = false;
+    if(c < end && (*c == '-' || *c == '+'))
+        negative = *c++ == '-';
+    int64_t i = 0;
+    bool any = false;
+    for(; c < end && *c >= '0' && *c <= '9'; ++c, any = true)
+        i = i * 10 + (*c - '0');
+    if(!any || i == 0)
+        index = -1; //Missing index
+    else if(negative) //Relative to the last element read
+    {
+        index = (int32_t)((int64_t)localCount - i);
+        relative |= bit;
+    }
+    else
+        index = (int32_t)(i - 1);
+    return c;
+}
+
+static void ParseOBJChunk(const char* c, const char* end, GLfloat scale, OBJChunk& chunk)
+{
+    std::vector<OBJCorner> polygon;
     
-    //Read vertices
-    while(fgets(line, 1024, file))
+    while(c < end)
     {
-        if(line[0] == 'v')
+        c = SkipSpaces(c, end);
+        if(c + 1 >= end)
+            break;
+        
+        if(c[0] == 'v' && (c[1] == ' ' || c[1] == '\t'))
         {
-            if(line[1] == ' ')
-            {
-                glm::vec3 v;
-                sscanf(line, "v %f %f %f\n", &v.x, &v.y, &v.z);
-                v *= scale; //Scaling
-                positions.push_back(v);
-            }
-            else if(line[1] == 'n')
+            glm::vec3 v;
+            c = ParseFloat(c + 2, end, v.x);
+            c = ParseFloat(c, end, v.y);
+            c = ParseFloat(c, end, v.z);
+            chunk.positions.push_back(v * scale); //Scaling
+        }
+        else if(c[0] == 'v' && c[1] == 'n')
+        {
+            glm::vec3 n;
+            c = ParseFloat(c + 2, end, n.x);
+            c = ParseFloat(c, end, n.y);
+            c = ParseFloat(c, end, n.z);
+            chunk.normals.push_back(n);
+        }
+        else if(c[0] == 'v' && c[1] == 't')
+        {
+            glm::vec2 uv;
+            c = ParseFloat(c + 2, end, uv.x);
+            c = ParseFloat(c, end, uv.y);
+            chunk.uvs.push_back(uv);
+        }
+        else if(c[0] == 'f' && (c[1] == ' ' || c[1] == '\t'))
+        {
+            //Read polygon corners in the form v, v/vt, v//vn or v/vt/vn
+            polygon.clear();
+            c += 2;
+            while(true)
             {
-                glm::vec3 n;
-                sscanf(line, "vn %f %f %f\n", &n.x, &n.y, &n.z);
-                normals.push_back(n);
+                c = SkipSpaces(c, end);
+                if(c >= end || !((*c >= '0' && *c <= '9') || *c == '-' || *c == '+'))
+                    break;
+                OBJCorner corner;
+                corner.vt = corner.vn = -1;
+                corner.relative = 0;
+                c = OBJParseIndex(c, end, chunk.positions.size(), corner.v, corner.relative, 1);
+                if(c < end && *c == '/')
+                {
+                    ++c;
+                    if(c < end && *c != '/')
+                        c = OBJParseIndex(c, end, chunk.uvs.size(), corner.vt, corner.relative, 2);
+                    if(c < end && *c == '/')
+                        c = OBJParseIndex(c + 1, end, chunk.normals.size(), corner.vn, corner.relative, 4);
+                }
+                polygon.push_back(corner);
             }
-            else if(line[1] == 't')
+            
+            //Triangulate as a fan
+            for(size_t i=2; i<polygon.size(); ++i)
             {
-                glm::vec2 uv;
-                sscanf(line, "vt %f %f\n", &uv.x, &uv.y);
-                uvs.push_back(uv);
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i-1]);
+                chunk.corners.push_back(polygon[i]);
             }
         }
+        c = SkipLine(c, end);
     }
-    fseek(file, 0, SEEK_SET); //Go back to beginning of file
-    
-    size_t genVStart = positions.size();
-    bool hasNormals = normals.size() > 0;
-    bool hasUVs = uvs.size() > 0;
+}
 
-#ifdef DEBUG
-    printf("Vertices: %ld Normals: %ld\n", genVStart, normals.size());
-#endif
+static inline int32_t ResolveOBJIndex(int32_t index, bool relative, int32_t offset)
+{
+    return relative ? offset + index : index;
+}
+
+template <typename VertexType>
+static void BuildOBJVertices(std::vector<VertexType>& vertices, std::vector<Face>& faces, const std::vector<OBJCorner>& corners,
+                             const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+                             const std::function<void(VertexType&, const OBJCorner&)>& setAttributes)
+{
+    //Vertices keep the ids of the positions they were generated from, other combinations of attributes are appended
+    vertices.resize(positions.size());
+    for(size_t i=0; i<positions.size(); ++i)
+        vertices[i].pos = positions[i];
+    std::vector<OBJCorner> slot(positions.size(), OBJCorner{-1, -1, -1, 0});
+    std::unordered_map<OBJCorner, GLuint, OBJCornerHash, OBJCornerEqual> generated;
     
-    if(hasUVs)
+    faces.resize(corners.size()/3);
+    for(size_t i=0; i<corners.size(); ++i)
     {
-        TexturableMesh* mesh = new TexturableMesh;
-
-        //Initialize positions
-        for(size_t i=0; i<positions.size(); ++i)
+        const OBJCorner& c = corners[i];
+        GLuint id;
+        
+        if(slot[c.v].v < 0) //Is it a fresh vertex?
         {
-            TexturableVertex v;
-            v.pos = positions[i];
-            mesh->vertices.push_back(v);
+            slot[c.v] = c;
+            setAttributes(vertices[c.v], c);
+            id = (GLuint)c.v;
         }
-
-        //Read faces
-        while(fgets(line, 1024, file))
+        else if(slot[c.v].vn == c.vn && slot[c.v].vt == c.vt) //Does it have the same attributes?
         {
-            if(line[0] != 'f')
-                continue;
-        
-            Face face;
-            unsigned int vID[3];
-            unsigned int uvID[3];
-            unsigned int nID[3];
-            sscanf(line, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", &vID[0], &uvID[0], &nID[0], &vID[1], &uvID[1], &nID[1], &vID[2], &uvID[2], &nID[2]);
-        
-            for(short unsigned int i=0; i<3; ++i)
+            id = (GLuint)c.v;
+        }
+        else //Otherwise search the generated pool
+        {
+            auto it = generated.find(c);
+            if(it != generated.end())
+                id = it->second;
+            else
             {
-                TexturableVertex v = mesh->vertices[vID[i]-1]; //Vertex from previously read pool
-            
-                if(glm::length2(v.normal) == 0.f) //Is it a fresh vertex?
-                {
-                    mesh->vertices[vID[i]-1].normal = normals[nID[i]-1];
-                    mesh->vertices[vID[i]-1].uv = uvs[uvID[i]-1];
-                    face.vertexID[i] = vID[i]-1;
-                }
-                else if((v.normal == normals[nID[i]-1]) && (v.uv == uvs[uvID[i]-1])) //Does it have the same normal and UV?
+                VertexType v;
+                v.pos = positions[c.v];
+                setAttributes(v, c);
+                if(v == vertices[c.v]) //Different indices but same values
+                    id = (GLuint)c.v;
+                else
                 {
-                    face.vertexID[i] = vID[i]-1;
-                }
-                else //Otherwise search the generated pool
-                {
-                    v.normal = normals[nID[i]-1];
-                    v.uv = uvs[uvID[i]-1];
-                
-                    std::vector<TexturableVertex>::iterator it;
-                    if((it = std::find(mesh->vertices.begin()+genVStart, mesh->vertices.end(), v)) != mesh->vertices.end()) //If vertex exists
-                    {
-                        face.vertexID[i] = (GLuint)(it - mesh->vertices.begin());
-                    }
-                    else
-                    {
-                        mesh->vertices.push_back(v);
-                        face.vertexID[i] = (GLuint)mesh->vertices.size()-1;
-                    }
+                    vertices.push_back(v);
+                    id = (GLuint)vertices.size()-1;
                 }
+                generated.emplace(c, id);
             }
+        }
+        faces[i/3].vertexID[i%3] = id;
+    }
+}
 
-            mesh->faces.push_back(face);
+Mesh* LoadOBJ(const std::string& path, GLfloat scale)
+{
+    //Map OBJ data
+    size_t size = 0;
+    const char* data = MapGeometryFile(path, size);
+    cInfo("Loading geometry from: %s", path.c_str());
+    int64_t start = GetTimeInMicroseconds();
+    
+    //Parse chunks in parallel, splitting at line boundaries
+    size_t nChunks = std::max((size_t)1, std::min(size/(size_t)(1 << 20), (size_t)omp_get_max_threads()));
+    std::vector<size_t> bounds(nChunks + 1, size);
+    bounds[0] = 0;
+    for(size_t i=1; i<nChunks; ++i)
+    {
+        const char* c = data + std::max(bounds[i-1], size * i / nChunks);
+        bounds[i] = SkipLine(c, data + size) - data;
+    }
+    
+    std::vector<OBJChunk> chunks(nChunks);
+    #pragma omp parallel for schedule(static) if(nChunks > 1)
+    for(size_t i=0; i<nChunks; ++i)
+        ParseOBJChunk(data + bounds[i], data + bounds[i+1], scale, chunks[i]);
+    UnmapGeometryFile(data, size);
+    
+    //Merge chunks
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<OBJCorner> corners;
+    size_t nCorners = 0;
+    for(size_t i=0; i<nChunks; ++i)
+        nCorners += chunks[i].corners.size();
+    corners.reserve(nCorners);
+    
+    for(size_t i=0; i<nChunks; ++i)
+    {
+        int32_t vOffset = (int32_t)positions.size();
+        int32_t vtOffset = (int32_t)uvs.size();
+        int32_t vnOffset = (int32_t)normals.size();
+        positions.insert(positions.end(), chunks[i].positions.begin(), chunks[i].positions.end());
+        normals.insert(normals.end(), chunks[i].normals.begin(), chunks[i].normals.end());
+        uvs.insert(uvs.end(), chunks[i].uvs.begin(), chunks[i].uvs.end());
+        for(size_t h=0; h<chunks[i].corners.size(); ++h)
+        {
+            OBJCorner c = chunks[i].corners[h];
+            c.v = ResolveOBJIndex(c.v, c.relative & 1, vOffset);
+            c.vt = ResolveOBJIndex(c.vt, c.relative & 2, vtOffset);
+            c.vn = ResolveOBJIndex(c.vn, c.relative & 4, vnOffset);
+            c.relative = 0;
+            corners.push_back(c);
+        }
+        chunks[i] = OBJChunk(); //Release memory early
+    }
+    
+    //Validate indices
+    for(size_t i=0; i<corners.size(); ++i)
+    {
+        OBJCorner& c = corners[i];
+        if(c.v < 0 || c.v >= (int32_t)positions.size())
+        {
+            cCritical("Geometry file '%s' contains invalid vertex indices!", path.c_str());
+            return nullptr;
         }
+        if(c.vn < 0 || c.vn >= (int32_t)normals.size()) c.vn = -1;
+        if(c.vt < 0 || c.vt >= (int32_t)uvs.size()) c.vt = -1;
+    }
+    
+#ifdef DEBUG
+    printf("Vertices: %ld Normals: %ld\n", positions.size(), normals.size());
+#endif
+    
+    //Build mesh, deduplicating combinations of position, normal and uv
+    Mesh* mesh_ = nullptr;
+    bool hasNormals = normals.size() > 0;
+    if(uvs.size() > 0)
+    {
+        TexturableMesh* mesh = new TexturableMesh;
+        BuildOBJVertices<TexturableVertex>(mesh->vertices, mesh->faces, corners, positions, normals,
+            [&normals, &uvs](TexturableVertex& v, const OBJCorner& c)
+            {
+                v.normal = c.vn >= 0 ? normals[c.vn] : glm::vec3(0.f);
+                v.uv = c.vt >= 0 ? uvs[c.vt] : glm::vec2(0.f);
+            });
         mesh_ = mesh;
     }
-    else    
+    else
     {
         PlainMesh* mesh = new PlainMesh;
-
-        //Initialize positions
-        for(size_t i=0; i<positions.size(); ++i)
+        if(hasNormals)
         {
-            Vertex v;
-            v.pos = positions[i];
-            mesh->vertices.push_back(v);
+            BuildOBJVertices<Vertex>(mesh->vertices, mesh->faces, corners, positions, normals,
+                [&normals](Vertex& v, const OBJCorner& c)
+                {
+                    v.normal = c.vn >= 0 ? normals[c.vn] : glm::vec3(0.f);
+                });
         }
-
-        //Read faces
-        while(fgets(line, 1024, file))
+        else
         {
-            if(line[0] != 'f')
-                continue;
-        
-            Face face;
-
-            if(hasNormals)
-            {
-                unsigned int vID[3];
-                unsigned int nID[3];
-                sscanf(line, "f %u//%u %u//%u %u//%u\n", &vID[0], &nID[0], &vID[1], &nID[1], &vID[2], &nID[2]);
-                
-                for(short unsigned int i=0; i<3; ++i)
-                {
-                    Vertex v = mesh->vertices[vID[i]-1]; //Vertex from previously read pool
-                    
-                    if(glm::length2(v.normal) == 0.f) //Is it a fresh vertex?
-                    {
-                        mesh->vertices[vID[i]-1].normal = normals[nID[i]-1];
-                        face.vertexID[i] = vID[i]-1;
-                    }
-                    else if(v.normal == normals[nID[i]-1]) //Does it have the same normal?
-                    {
-                        face.vertexID[i] = vID[i]-1;
-                    }
-                    else //Otherwise search the generated pool
-                    {
-                        v.normal = normals[nID[i]-1];
-                        
-                        std::vector<Vertex>::iterator it;
-                        if((it = std::find(mesh->vertices.begin()+genVStart, mesh->vertices.end(), v)) != mesh->vertices.end()) //If vertex exists
-                        {
-                            face.vertexID[i] = (GLuint)(it - mesh->vertices.begin());
-                        }
-                        else
-                        {
-                            mesh->vertices.push_back(v);
-                            face.vertexID[i] = (GLuint)mesh->vertices.size()-1;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                unsigned int vID[3];
-                sscanf(line, "f %u %u %u\n", &vID[0], &vID[1], &vID[2]);
-                
-                face.vertexID[0] = vID[0]-1;
-                face.vertexID[1] = vID[1]-1;
-                face.vertexID[2] = vID[2]-1;
-            }
-        
-            mesh->faces.push_back(face);
+            mesh->vertices.resize(positions.size());
+            for(size_t i=0; i<positions.size(); ++i)
+                mesh->vertices[i].pos = positions[i];
+            mesh->faces.resize(corners.size()/3);
+            for(size_t i=0; i<corners.size(); ++i)
+                mesh->faces[i/3].vertexID[i%3] = (GLuint)corners[i].v;
         }
         mesh_ = mesh;
     }
-    fclose(file);
     
     int64_t end = GetTimeInMicroseconds();
     
 #ifdef DEBUG
-    printf("Loaded: %ld Generated: %ld\n", genVStart, mesh_->getNumOfVertices()-genVStart);
+    printf("Loaded: %ld Generated: %ld\n", positions.size(), mesh_->getNumOfVertices()-positions.size());
     printf("Total time: %ld\n", (long int)(end-start));
 #endif
     cInfo("Loaded mesh with %ld faces in %ld ms.", mesh_->faces.size(), (end-start)/1000);
     return mesh_;
 }
 
-Mesh* LoadSTL(const std::string& path, GLfloat scale)
+//STL parsing helpers
+struct STLFacet
 {
-    //Read STL data
-    FILE* file = fopen(path.c_str(), "rb");   
-    
-    if(file == NULL)
+    glm::vec3 normal;
+    glm::vec3 v[3];
+};
+
+struct STLCell
+{
+    int64_t x, y, z;
+};
+
+struct STLCellHash
+{
+    size_t operator()(const STLCell& c) const
     {
-        cCritical("Failed to open geometry file: %s", path.c_str());
-        return nullptr;
+        uint64_t h = (uint64_t)c.x * 0x9E3779B97F4A7C15ull;
+        h ^= (uint64_t)c.y * 0xC2B2AE3D27D4EB4Full;
+        h ^= (uint64_t)c.z * 0x165667B19E3779F9ull;
+        return (size_t)(h ^ (h >> 29));
     }
+};
+
+struct STLCellEqual
+{
+    bool operator()(const STLCell& a, const STLCell& b) const
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+};
+
+static void ParseBinarySTL(const char* data, size_t nFacets, GLfloat scale, std::vector<STLFacet>& facets)
+{
+    facets.resize(nFacets);
+    const char* c = data + 84;
+    for(size_t i=0; i<nFacets; ++i, c += 50) //12 floats + 16-bit attribute
+    {
+        float f[12];
+        memcpy(f, c, sizeof(f));
+        facets[i].normal = glm::vec3(f[0], f[1], f[2]);
+        for(unsigned short h=0; h<3; ++h)
+            facets[i].v[h] = glm::vec3(f[3+h*3], f[4+h*3], f[5+h*3]) * scale;
+    }
+}
+
+static void ParseASCIISTL(const char* c, const char* end, GLfloat scale, std::vector<STLFacet>& facets)
+{
+    STLFacet facet;
+    unsigned short nv = 0;
     
+    while(c < end)
+    {
+        c = SkipSpaces(c, end);
+        size_t left = end - c;
+        if(left >= 12 && strncmp(c, "facet normal", 12) == 0)
+        {
+            c = ParseFloat(c + 12, end, facet.normal.x);
+            c = ParseFloat(c, end, facet.normal.y);
+            c = ParseFloat(c, end, facet.normal.z);
+            nv = 0;
+        }
+        else if(left >= 6 && strncmp(c, "vertex", 6) == 0 && nv < 3)
+        {
+            glm::vec3& v = facet.v[nv++];
+            c = ParseFloat(c + 6, end, v.x);
+            c = ParseFloat(c, end, v.y);
+            c = ParseFloat(c, end, v.z);
+            v *= scale;
+        }
+        else if(left >= 8 && strncmp(c, "endfacet", 8) == 0 && nv == 3)
+        {
+            facets.push_back(facet);
+            nv = 0;
+        }
+        c = SkipLine(c, end);
+    }
+}
+
+Mesh* LoadSTL(const std::string& path, GLfloat scale, GLfloat weldTolerance)
+{
+    //Map STL data
+    size_t size = 0;
+    const char* data = MapGeometryFile(path, size);
     cInfo("Loading geometry from: %s", path.c_str());
+    int64_t start = GetTimeInMicroseconds();
     
-    char line[128];
-    char keyword[10];
-    PlainMesh* mesh = new PlainMesh;
-    Vertex v;
+    //Binary files are recognised by size, as some exporters start their header with "solid" too
+    std::vector<STLFacet> facets;
+    uint32_t nFacets = 0;
+    if(size >= 84)
+        memcpy(&nFacets, data + 80, sizeof(nFacets));
+    bool binary = size >= 84 && size == 84 + (size_t)nFacets * 50;
+    if(binary)
+        ParseBinarySTL(data, nFacets, scale, facets);
+    else
+        ParseASCIISTL(data, data + size, scale, facets);
+    UnmapGeometryFile(data, size);
     
-    while(fgets(line, 128, file))
+    //Weld positions closer than the tolerance
+    GLfloat tol = std::max(weldTolerance, 1e-9f);
+    std::vector<glm::vec3> positions;
+    std::vector<GLuint> nextInCell; //Chains of positions sharing a grid cell
+    std::unordered_map<STLCell, GLuint, STLCellHash, STLCellEqual> cells;
+    std::vector<GLuint> corners(facets.size() * 3);
+    positions.reserve(facets.size()/2 + 3);
+    cells.reserve(facets.size());
+    
+    for(size_t i=0; i<corners.size(); ++i)
     {
-        sscanf(line, "%s", keyword);
+        const glm::vec3& p = facets[i/3].v[i%3];
+        STLCell cell{(int64_t)std::floor(p.x/tol), (int64_t)std::floor(p.y/tol), (int64_t)std::floor(p.z/tol)};
+        GLuint id = (GLuint)-1;
         
-        if(strcmp(keyword, "facet")==0)
-        {
-            sscanf(line, " facet normal %f %f %f\n", &v.normal.x, &v.normal.y, &v.normal.z);
-        }
-        else if(strcmp(keyword, "vertex")==0)
+        for(int dx=-1; dx<=1 && id == (GLuint)-1; ++dx)
+            for(int dy=-1; dy<=1 && id == (GLuint)-1; ++dy)
+                for(int dz=-1; dz<=1 && id == (GLuint)-1; ++dz)
+                {
+                    auto it = cells.find(STLCell{cell.x+dx, cell.y+dy, cell.z+dz});
+                    if(it == cells.end())
+                        continue;
+                    for(GLuint h = it->second; h != (GLuint)-1; h = nextInCell[h])
+                    {
+                        glm::vec3 d = positions[h] - p;
+                        if(glm::dot(d, d) <= tol*tol)
+                        {
+                            id = h;
+                            break;
+                        }
+                    }
+                }
+        
+        if(id == (GLuint)-1)
         {
-            sscanf(line, " vertex %f %f %f\n", &v.pos.x, &v.pos.y, &v.pos.z);
-            v.pos *= scale;
-            mesh->vertices.push_back(v);
+            id = (GLuint)positions.size();
+            positions.push_back(p);
+            auto it = cells.find(cell);
+            nextInCell.push_back(it == cells.end() ? (GLuint)-1 : it->second);
+            cells[cell] = id;
         }
-        else if(strcmp(keyword, "endfacet")==0)
+        corners[i] = id;
+    }
+    
+    //Build vertices, sharing them between adjacent facets unless separated by a crease
+    const GLfloat cosCrease = cosf(30.f/180.f*(GLfloat)M_PI);
+    std::vector<GLuint> firstAtPosition(positions.size(), (GLuint)-1);
+    std::vector<GLuint> nextAtPosition; //Chains of vertices sharing a position
+    std::vector<glm::vec3> clusterNormal; //Normal of the facet that created the vertex
+    PlainMesh* mesh = new PlainMesh;
+    mesh->faces.reserve(facets.size());
+    
+    for(size_t i=0; i<facets.size(); ++i)
+    {
+        GLuint* c = &corners[i*3];
+        if(c[0] == c[1] || c[1] == c[2] || c[0] == c[2]) //Degenerate after welding
+            continue;
+        
+        glm::vec3 Ng = glm::cross(positions[c[1]] - positions[c[0]], positions[c[2]] - positions[c[0]]);
+        GLfloat area2 = glm::length(Ng);
+        if(area2 <= 0.f)
+            continue;
+        Ng /= area2;
+        glm::vec3 N = facets[i].normal;
+        GLfloat lenN = glm::length(N);
+        N = lenN > 0.f ? N/lenN : Ng; //Many exporters write zero normals
+        
+        Face face;
+        for(unsigned short h=0; h<3; ++h)
         {
-            unsigned int lastVertexID = (GLuint)mesh->vertices.size()-1;
+            GLuint vid = (GLuint)-1;
+            for(GLuint k = firstAtPosition[c[h]]; k != (GLuint)-1; k = nextAtPosition[k])
+                if(glm::dot(clusterNormal[k], N) >= cosCrease)
+                {
+                    vid = k;
+                    break;
+                }
             
-            Face f;
-            f.vertexID[0] = lastVertexID-2;
-            f.vertexID[1] = lastVertexID-1;
-            f.vertexID[2] = lastVertexID;
-            mesh->faces.push_back(f);
+            if(vid == (GLuint)-1)
+            {
+                vid = (GLuint)mesh->vertices.size();
+                Vertex v;
+                v.pos = positions[c[h]];
+                mesh->vertices.push_back(v);
+                clusterNormal.push_back(N);
+                nextAtPosition.push_back(firstAtPosition[c[h]]);
+                firstAtPosition[c[h]] = vid;
+            }
+            mesh->vertices[vid].normal += N * area2; //Area weighted
+            face.vertexID[h] = vid;
         }
+        mesh->faces.push_back(face);
     }
     
-    fclose(file);
-    
-    //Remove duplicates (so that it becomes equivalent to OBJ file representation)
+    for(size_t i=0; i<mesh->vertices.size(); ++i)
+        mesh->vertices[i].normal = glm::normalize(mesh->vertices[i].normal);
     
+    int64_t end = GetTimeInMicroseconds();
+    cInfo("Loaded %s STL mesh with %ld faces and %ld vertices (%ld before welding) in %ld ms.", binary ? "binary" : "ASCII",
+          mesh->faces.size(), mesh->vertices.size(), facets.size()*3, (end-start)/1000);
     return mesh;
 }
 
@@ -533,6 +886,427 @@ MeshProperties ComputePhysicalProperties(const Mesh* mesh, Scalar thickness, Sca
     return mp;
 }
 
+static void ComputeHullPlanes(const btConvexHullComputer& hc, std::vector<Vector3>& normals, std::vector<Scalar>& offsets)
+{
+    normals.clear();
+    offsets.clear();
+    for(int i=0; i<hc.faces.size(); ++i)
+    {
+        //Newell's method (faces are counter-clockwise when seen from the outside)
+        const btConvexHullComputer::Edge* first = &hc.edges[hc.faces[i]];
+        const btConvexHullComputer::Edge* e = first;
+        Vector3 n(0,0,0);
+        Vector3 c(0,0,0);
+        unsigned int count = 0;
+        do
+        {
+            const Vector3& a = hc.vertices[e->getSourceVertex()];
+            const Vector3& b = hc.vertices[e->getTargetVertex()];
+            n += a.cross(b);
+            c += a;
+            ++count;
+            e = e->getNextEdgeOfFace();
+        }
+        while(e != first);
+        
+        Scalar len = n.length();
+        if(len < SIMD_EPSILON)
+            continue;
+        n /= len;
+        normals.push_back(n);
+        offsets.push_back(n.dot(c/Scalar(count)));
+    }
+}
+
+std::vector<Vector3> ComputeConvexHull(const std::vector<Vector3>& points, unsigned int maxVertices)
+{
+    std::vector<Vector3> hull;
+    if(points.empty())
+        return hull;
+    
+    //1. Compute exact hull (removes interior and duplicate points)
+    btConvexHullComputer hc;
+    hc.compute(&points[0].x(), sizeof(Vector3), (int)points.size(), Scalar(0), Scalar(0));
+    hull.reserve(hc.vertices.size());
+    for(int i=0; i<hc.vertices.size(); ++i)
+        hull.push_back(hc.vertices[i]);
+    if(hull.size() <= maxVertices || maxVertices < 4)
+        return hull;
+    
+    //2. Find initial tetrahedron
+    size_t sel[4] = {0, 0, 0, 0};
+    for(size_t i=1; i<hull.size(); ++i)
+        if(hull[i].x() < hull[sel[0]].x())
+            sel[0] = i;
+    Scalar d, dMax = Scalar(0);
+    for(size_t i=0; i<hull.size(); ++i)
+        if((d = hull[i].distance2(hull[sel[0]])) > dMax)
+        {
+            dMax = d;
+            sel[1] = i;
+        }
+    Scalar eps = btSqrt(dMax) * Scalar(1e-9);
+    Vector3 dir = (hull[sel[1]] - hull[sel[0]]).normalized();
+    dMax = Scalar(0);
+    for(size_t i=0; i<hull.size(); ++i)
+        if((d = (hull[i] - hull[sel[0]]).cross(dir).length2()) > dMax)
+        {
+            dMax = d;
+            sel[2] = i;
+        }
+    Vector3 n = (hull[sel[1]] - hull[sel[0]]).cross(hull[sel[2]] - hull[sel[0]]).normalized();
+    dMax = Scalar(0);
+    for(size_t i=0; i<hull.size(); ++i)
+        if((d = btFabs((hull[i] - hull[sel[0]]).dot(n))) > dMax)
+        {
+            dMax = d;
+            sel[3] = i;
+        }
+    if(dMax <= eps) //Flat set of points
+        return hull;
+    
+    //3. Add vertices lying farthest outside of the hull of the selected ones
+    std::vector<Vector3> selected;
+    std::vector<char> used(hull.size(), 0);
+    for(unsigned int i=0; i<4; ++i)
+    {
+        selected.push_back(hull[sel[i]]);
+        used[sel[i]] = 1;
+    }
+    
+    std::vector<Vector3> normals;
+    std::vector<Scalar> offsets;
+    std::vector<Scalar> dist(hull.size());
+    while(selected.size() < maxVertices)
+    {
+        hc.compute(&selected[0].x(), sizeof(Vector3), (int)selected.size(), Scalar(0), Scalar(0));
+        ComputeHullPlanes(hc, normals, offsets);
+        
+        #pragma omp parallel for
+        for(size_t i=0; i<hull.size(); ++i)
+        {
+            Scalar dOut = Scalar(0);
+            if(!used[i])
+                for(size_t h=0; h<normals.size(); ++h)
+                    dOut = btMax(dOut, normals[h].dot(hull[i]) - offsets[h]);
+            dist[i] = dOut;
+        }
+        
+        size_t best = std::max_element(dist.begin(), dist.end()) - dist.begin();
+        if(dist[best] <= eps) //All remaining vertices inside
+            break;
+        selected.push_back(hull[best]);
+        used[best] = 1;
+    }
+    return selected;
+}
+
+static Scalar ComputeHullVolume(const std::vector<Vector3>& points)
+{
+    if(points.size() < 4)
+        return Scalar(0);
+    
+    btConvexHullComputer hc;
+    hc.compute(&points[0].x(), sizeof(Vector3), (int)points.size(), Scalar(0), Scalar(0));
+    if(hc.vertices.size() < 4) //Degenerate (flat) hull
+        return Scalar(0);
+    
+    Scalar volume(0);
+    const Vector3& ref = hc.vertices[0];
+    for(int i=0; i<hc.faces.size(); ++i)
+    {
+        const btConvexHullComputer::Edge* first = &hc.edges[hc.faces[i]];
+        const btConvexHullComputer::Edge* e = first->getNextEdgeOfFace();
+        const Vector3 a = hc.vertices[first->getSourceVertex()] - ref;
+        while(e->getTargetVertex() != first->getSourceVertex())
+        {
+            volume += a.dot((hc.vertices[e->getSourceVertex()] - ref).cross(hc.vertices[e->getTargetVertex()] - ref));
+            e = e->getNextEdgeOfFace();
+        }
+    }
+    return volume/Scalar(6);
+}
+
+static void ClipTriangleToBox(const Vector3 tri[3], const Vector3& boxMin, const Vector3& boxMax, std::vector<Vector3>& points)
+{
+    //Trivial cases
+    Vector3 tMin = tri[0];
+    Vector3 tMax = tri[0];
+    for(unsigned int i=1; i<3; ++i)
+    {
+        tMin.setMin(tri[i]);
+        tMax.setMax(tri[i]);
+    }
+    if(tMax.x() < boxMin.x() || tMax.y() < boxMin.y() || tMax.z() < boxMin.z()
+       || tMin.x() > boxMax.x() || tMin.y() > boxMax.y() || tMin.z() > boxMax.z())
+        return;
+    if(tMin.x() >= boxMin.x() && tMin.y() >= boxMin.y() && tMin.z() >= boxMin.z()
+       && tMax.x() <= boxMax.x() && tMax.y() <= boxMax.y() && tMax.z() <= boxMax.z())
+    {
+        points.insert(points.end(), tri, tri + 3);
+        return;
+    }
+    
+    //Sutherland-Hodgman clipping against the 6 planes of the box
+    Vector3 buffer[2][9];
+    unsigned int count = 3;
+    std::copy(tri, tri + 3, buffer[0]);
+    unsigned int src = 0;
+    for(unsigned int plane=0; plane<6 && count > 0; ++plane)
+    {
+        int axis = plane/2;
+        Scalar sign = (plane % 2) ? Scalar(-1) : Scalar(1);
+        Scalar bound = (plane % 2) ? boxMax[axis] : boxMin[axis];
+        const Vector3* in = buffer[src];
+        Vector3* out = buffer[1-src];
+        unsigned int outCount = 0;
+        for(unsigned int i=0; i<count; ++i)
+        {
+            const Vector3& a = in[i];
+            const Vector3& b = in[(i+1) % count];
+            Scalar da = sign * (a[axis] - bound);
+            Scalar db = sign * (b[axis] - bound);
+            if(da >= Scalar(0))
+                out[outCount++] = a;
+            if((da >= Scalar(0)) != (db >= Scalar(0)))
+                out[outCount++] = a + (b - a) * (da/(da - db));
+        }
+        count = outCount;
+        src = 1-src;
+    }
+    points.insert(points.end(), buffer[src], buffer[src] + count);
+}
+
+//A cell of the convex decomposition (box between planes of the voxel grid)
+struct DecompositionCell
+{
+    int lo[3];
+    int hi[3];
+    std::vector<uint32_t> faces; //Faces overlapping the cell
+    std::vector<Vector3> points; //Vertices of the mesh clipped to the cell
+    Scalar concavity;
+};
+
+//Solid voxelization of a mesh used to estimate the volume of the cells of the convex decomposition
+struct DecompositionGrid
+{
+    int n[3];
+    Vector3 origin;
+    Scalar h;
+    std::vector<Vector3> triangles;
+    std::vector<uint32_t> sum; //Summed volume table of voxels with centres inside of the mesh
+    
+    size_t SumIndex(int i, int j, int k) const { return ((size_t)k * (n[1]+1) + j) * (n[0]+1) + i; }
+    
+    int Plane(Scalar x, int axis) const { return btMin(btMax((int)std::floor((x - origin[axis])/h), 0), n[axis]); }
+    
+    Scalar Volume(const int lo[3], const int hi[3]) const
+    {
+        int64_t c = 0;
+        for(unsigned int corner=0; corner<8; ++corner)
+        {
+            int i = (corner & 1) ? hi[0] : lo[0];
+            int j = (corner & 2) ? hi[1] : lo[1];
+            int k = (corner & 4) ? hi[2] : lo[2];
+            bool odd = ((corner & 1) ^ ((corner >> 1) & 1) ^ ((corner >> 2) & 1)) != 0; //Corner with all upper bounds is odd
+            c += odd ? (int64_t)sum[SumIndex(i, j, k)] : -(int64_t)sum[SumIndex(i, j, k)];
+        }
+        return Scalar(c) * h*h*h;
+    }
+    
+    void Clip(DecompositionCell& cell, const std::vector<uint32_t>& faces) const
+    {
+        Vector3 boxMin, boxMax;
+        for(int a=0; a<3; ++a)
+        {
+            boxMin[a] = cell.lo[a] == 0 ? -BT_LARGE_FLOAT : origin[a] + cell.lo[a] * h;
+            boxMax[a] = cell.hi[a] == n[a] ? BT_LARGE_FLOAT : origin[a] + cell.hi[a] * h;
+        }
+        cell.faces.clear();
+        cell.points.clear();
+        for(size_t f=0; f<faces.size(); ++f)
+        {
+            size_t nPoints = cell.points.size();
+            ClipTriangleToBox(&triangles[faces[f]*3], boxMin, boxMax, cell.points);
+            if(cell.points.size() > nPoints)
+                cell.faces.push_back(faces[f]);
+        }
+    }
+};
+
+std::vector<std::vector<Vector3>> ComputeConvexDecomposition(const Mesh* mesh, unsigned int maxParts, unsigned int maxHullVertices, unsigned int resolution)
+{
+    std::vector<std::vector<Vector3>> parts;
+    if(mesh->faces.size() == 0)
+        return parts;
+    
+    //1. Setup voxel grid
+    DecompositionGrid grid;
+    grid.triangles.resize(mesh->faces.size() * 3);
+    Vector3 vMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+    Vector3 vMax = -vMin;
+    for(size_t i=0; i<grid.triangles.size(); ++i)
+    {
+        glm::vec3 pos = mesh->getVertexPos(mesh->faces[i/3].vertexID[i%3]);
+        grid.triangles[i] = Vector3(pos.x, pos.y, pos.z);
+        vMin.setMin(grid.triangles[i]);
+        vMax.setMax(grid.triangles[i]);
+    }
+    Vector3 extent = vMax - vMin;
+    grid.h = extent[extent.maxAxis()]/Scalar(btMax(resolution, 1u));
+    if(maxParts < 2 || grid.h <= Scalar(0))
+    {
+        parts.push_back(ComputeConvexHull(grid.triangles, maxHullVertices));
+        return parts;
+    }
+    for(int a=0; a<3; ++a)
+        grid.n[a] = btMax((int)std::ceil(extent[a]/grid.h - Scalar(1e-6)), 1);
+    grid.origin = (vMin + vMax)/Scalar(2) - Vector3(grid.n[0], grid.n[1], grid.n[2]) * (grid.h/Scalar(2));
+    
+    //2. Voxelize interior (parity of ray crossings along z, at the voxel centres)
+    std::vector<std::vector<Scalar>> hits((size_t)grid.n[0] * grid.n[1]);
+    const Scalar jitter(1.2345e-4); //Avoid rays passing exactly through edges
+    for(size_t f=0; f<mesh->faces.size(); ++f)
+    {
+        const Vector3* tri = &grid.triangles[f*3];
+        Vector3 e1 = tri[1] - tri[0];
+        Vector3 e2 = tri[2] - tri[0];
+        Scalar d = e1.x() * e2.y() - e1.y() * e2.x();
+        if(btFabs(d) < SIMD_EPSILON)
+            continue;
+        int i0 = btMin(grid.Plane(btMin(btMin(tri[0].x(), tri[1].x()), tri[2].x()), 0), grid.n[0]-1);
+        int i1 = btMin(grid.Plane(btMax(btMax(tri[0].x(), tri[1].x()), tri[2].x()), 0), grid.n[0]-1);
+        int j0 = btMin(grid.Plane(btMin(btMin(tri[0].y(), tri[1].y()), tri[2].y()), 1), grid.n[1]-1);
+        int j1 = btMin(grid.Plane(btMax(btMax(tri[0].y(), tri[1].y()), tri[2].y()), 1), grid.n[1]-1);
+        for(int j=j0; j<=j1; ++j)
+            for(int i=i0; i<=i1; ++i)
+            {
+                Scalar px = grid.origin.x() + (i + Scalar(0.5) + jitter) * grid.h - tri[0].x();
+                Scalar py = grid.origin.y() + (j + Scalar(0.5) + jitter) * grid.h - tri[0].y();
+                Scalar w1 = (px * e2.y() - py * e2.x())/d;
+                Scalar w2 = (e1.x() * py - e1.y() * px)/d;
+                if(w1 >= Scalar(0) && w2 >= Scalar(0) && w1 + w2 <= Scalar(1))
+                    hits[(size_t)j * grid.n[0] + i].push_back(tri[0].z() + w1 * e1.z() + w2 * e2.z());
+            }
+    }
+    
+    std::vector<char> inside((size_t)grid.n[0] * grid.n[1] * grid.n[2], 0);
+    #pragma omp parallel for
+    for(size_t c=0; c<hits.size(); ++c)
+    {
+        std::sort(hits[c].begin(), hits[c].end());
+        for(size_t h=0; h+1<hits[c].size(); h+=2)
+        {
+            int k0 = btMax((int)std::ceil((hits[c][h] - grid.origin.z())/grid.h - Scalar(0.5)), 0);
+            int k1 = btMin((int)std::floor((hits[c][h+1] - grid.origin.z())/grid.h - Scalar(0.5)), grid.n[2]-1);
+            for(int k=k0; k<=k1; ++k)
+                inside[(size_t)k * hits.size() + c] = 1;
+        }
+    }
+    
+    grid.sum.assign((size_t)(grid.n[0]+1) * (grid.n[1]+1) * (grid.n[2]+1), 0);
+    for(int k=0; k<grid.n[2]; ++k)
+        for(int j=0; j<grid.n[1]; ++j)
+            for(int i=0; i<grid.n[0]; ++i)
+                grid.sum[grid.SumIndex(i+1, j+1, k+1)] = inside[((size_t)k * grid.n[1] + j) * grid.n[0] + i]
+                    + grid.sum[grid.SumIndex(i, j+1, k+1)] + grid.sum[grid.SumIndex(i+1, j, k+1)] + grid.sum[grid.SumIndex(i+1, j+1, k)]
+                    - grid.sum[grid.SumIndex(i, j, k+1)] - grid.sum[grid.SumIndex(i, j+1, k)] - grid.sum[grid.SumIndex(i+1, j, k)]
+                    + grid.sum[grid.SumIndex(i, j, k)];
+    
+    //3. Split cells with the highest concavity (the difference between the volume of the hull and the volume of the cell).
+    //The sum of volumes of the halves does not depend on the splitting plane, so the best plane minimises the sum of volumes of their hulls.
+    std::vector<DecompositionCell> cells(1);
+    std::vector<uint32_t> allFaces(mesh->faces.size());
+    for(size_t f=0; f<allFaces.size(); ++f)
+        allFaces[f] = (uint32_t)f;
+    for(int a=0; a<3; ++a)
+    {
+        cells[0].lo[a] = 0;
+        cells[0].hi[a] = grid.n[a];
+    }
+    grid.Clip(cells[0], allFaces);
+    cells[0].concavity = btMax(ComputeHullVolume(cells[0].points) - grid.Volume(cells[0].lo, cells[0].hi), Scalar(0));
+    Scalar tolerance = Scalar(0.01) * grid.Volume(cells[0].lo, cells[0].hi);
+    
+    while(cells.size() < maxParts)
+    {
+        size_t c = 0;
+        for(size_t i=1; i<cells.size(); ++i)
+            if(cells[i].concavity > cells[c].concavity)
+                c = i;
+        if(cells[c].concavity <= tolerance)
+            break;
+        
+        //Candidate planes spread evenly over the extent of the clipped mesh
+        Vector3 pMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+        Vector3 pMax = -pMin;
+        for(size_t i=0; i<cells[c].points.size(); ++i)
+        {
+            pMin.setMin(cells[c].points[i]);
+            pMax.setMax(cells[c].points[i]);
+        }
+        std::vector<std::pair<int, int>> candidates;
+        for(int a=0; a<3; ++a)
+        {
+            int first = btMax(grid.Plane(pMin[a], a), cells[c].lo[a]) + 1;
+            int last = btMin(grid.Plane(pMax[a], a), cells[c].hi[a] - 1);
+            int step = btMax((last - first + 1)/DECOMPOSITION_CANDIDATE_PLANES, 1);
+            for(int cut = first; cut <= last; cut += step)
+                candidates.push_back(std::make_pair(a, cut));
+        }
+        if(candidates.empty()) //Cell can not be split further
+        {
+            cells[c].concavity = Scalar(0);
+            continue;
+        }
+        
+        std::vector<Scalar> cost(candidates.size());
+        #pragma omp parallel for schedule(dynamic)
+        for(size_t i=0; i<candidates.size(); ++i)
+        {
+            DecompositionCell half[2];
+            cost[i] = Scalar(0);
+            for(unsigned int s=0; s<2; ++s)
+            {
+                std::copy(cells[c].lo, cells[c].lo + 3, half[s].lo);
+                std::copy(cells[c].hi, cells[c].hi + 3, half[s].hi);
+                if(s == 0)
+                    half[s].hi[candidates[i].first] = candidates[i].second;
+                else
+                    half[s].lo[candidates[i].first] = candidates[i].second;
+                grid.Clip(half[s], cells[c].faces);
+                cost[i] += ComputeHullVolume(half[s].points);
+            }
+        }
+        
+        size_t best = std::min_element(cost.begin(), cost.end()) - cost.begin();
+        DecompositionCell parent;
+        std::swap(parent, cells[c]);
+        cells.push_back(DecompositionCell());
+        DecompositionCell* half[2] = {&cells[c], &cells.back()};
+        for(unsigned int s=0; s<2; ++s)
+        {
+            std::copy(parent.lo, parent.lo + 3, half[s]->lo);
+            std::copy(parent.hi, parent.hi + 3, half[s]->hi);
+            if(s == 0)
+                half[s]->hi[candidates[best].first] = candidates[best].second;
+            else
+                half[s]->lo[candidates[best].first] = candidates[best].second;
+            grid.Clip(*half[s], parent.faces);
+            half[s]->concavity = btMax(ComputeHullVolume(half[s]->points) - grid.Volume(half[s]->lo, half[s]->hi), Scalar(0));
+        }
+    }
+    
+    //4. Compute simplified hulls of the parts
+    parts.resize(cells.size());
+    #pragma omp parallel for schedule(dynamic)
+    for(size_t c=0; c<cells.size(); ++c)
+        parts[c] = ComputeConvexHull(cells[c].points, maxHullVertices);
+    
+    parts.erase(std::remove_if(parts.begin(), parts.end(), [](const std::vector<Vector3>& p) { return p.size() < 4; }), parts.end());
+    return parts;
+}
+
 Vector3 FindInertialAxis(const Matrix3& I, Scalar value)
 {
     //Diagonalize
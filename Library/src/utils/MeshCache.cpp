@@ -0,0 +1,900 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MeshCache.cpp
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "utils/MeshCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <dirent.h>
+#include <algorithm>
+#include "core/SimulationApp.h"
+#include "graphics/OpenGLContent.h"
+#include "utils/SystemUtil.hpp"
+
+#define MESH_CACHE_VERSION 1
+
+namespace sf
+{
+
+std::mutex MeshCache::mutex;
+std::mutex MeshCache::diskMutex;
+std::map<std::string, std::shared_ptr<const Mesh>> MeshCache::meshes;
+std::map<const Mesh*, MeshCache::DerivedData> MeshCache::derived;
+std::map<const Mesh*, MeshCache::TriangleMeshData> MeshCache::triangleMeshes;
+std::map<std::string, uint64_t> MeshCache::sourceHashes;
+std::string MeshCache::diskCacheDir = "";
+bool MeshCache::diskCacheDirSet = false;
+size_t MeshCache::diskCacheLimit = DEFAULT_DISK_CACHE_SIZE_LIMIT;
+bool MeshCache::retainUnused = false;
+
+//Binary format of the processed meshes
+struct MeshBlobHeader
+{
+    char magic[4]; //"SFMB"
+    uint32_t version;
+    uint64_t key;
+    uint32_t texturable;
+    uint32_t vertexSize;
+    uint64_t nVertices;
+    uint64_t nFaces;
+};
+
+//Binary format of the serialized bounding volume hierarchies (data has to be 16-byte aligned)
+struct BvhBlobHeader
+{
+    char magic[4]; //"SFBV"
+    uint32_t version;
+    uint64_t key;
+    uint64_t nFaces;
+    uint64_t size;
+};
+
+//Binary format of the records of derived products (appended to a file starting with magic "SFMD" and version)
+struct DerivedRecordHeader
+{
+    uint32_t type;
+    uint32_t count; //Number of doubles in the payload
+};
+
+static inline uint64_t HashBytes(const char* data, size_t size, uint64_t h = 0xCBF29CE484222325ull)
+{
+    size_t n = size / 8;
+    for(size_t i=0; i<n; ++i)
+    {
+        uint64_t w;
+        memcpy(&w, data + i*8, 8);
+        h = (h ^ w) * 0x100000001B3ull;
+        h ^= h >> 32;
+    }
+    for(size_t i=n*8; i<size; ++i)
+        h = (h ^ (uint8_t)data[i]) * 0x100000001B3ull;
+    return h;
+}
+
+std::string MeshCache::MakeKey(const std::string& filename, GLfloat scale, bool smooth, GLfloat sizeThreshold)
+{
+    char params[64];
+    snprintf(params, sizeof(params), "|%.9g|%d|%.9g", scale, smooth ? 1 : 0, sizeThreshold);
+    return filename + std::string(params);
+}
+
+Mesh* MeshCache::LoadMesh(const std::string& filename, GLfloat scale, bool smooth)
+{
+    Mesh* mesh = LoadGeometryFromFile(filename, scale);
+    if(mesh == nullptr)
+        cCritical("Failed to load mesh '%s'!", filename.c_str());
+
+    OpenGLContent::CheckAndRepairFaceVertexOrder(mesh);
+    if(smooth)
+        OpenGLContent::SmoothNormals(mesh);
+    if(mesh->isTexturable())
+        OpenGLContent::ComputeTangents((TexturableMesh*)mesh);
+    return mesh;
+}
+
+std::shared_ptr<const Mesh> MeshCache::Insert(const std::string& key, Mesh* mesh, const DerivedData& data)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = meshes.find(key);
+    if(it != meshes.end()) //Another thread loaded the same mesh in the meantime
+    {
+        delete mesh;
+        return it->second;
+    }
+    std::shared_ptr<const Mesh> shared(mesh);
+    meshes[key] = shared;
+    derived[mesh] = data;
+    return shared;
+}
+
+std::shared_ptr<const Mesh> MeshCache::GetMesh(const std::string& filename, GLfloat scale, bool smooth)
+{
+    std::string key = MakeKey(filename, scale, smooth, 0.f);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = meshes.find(key);
+        if(it != meshes.end())
+            return it->second;
+    }
+    
+    //Loading done without holding the lock
+    DerivedData data;
+    Mesh* mesh = nullptr;
+    if((data.diskKey = MakeDiskKey(filename, scale, smooth, 0.f)) != 0
+       && (mesh = ReadMeshBlob(data.diskKey)) != nullptr)
+        ReadDerivedRecords(data.diskKey, data);
+    
+    if(mesh == nullptr)
+    {
+        mesh = LoadMesh(filename, scale, smooth);
+        if(data.diskKey != 0)
+            WriteMeshBlob(data.diskKey, mesh);
+    }
+    return Insert(key, mesh, data);
+}
+
+std::shared_ptr<const Mesh> MeshCache::GetRefinedMesh(const std::string& filename, GLfloat scale, bool smooth, GLfloat sizeThreshold)
+{
+    std::string key = MakeKey(filename, scale, smooth, sizeThreshold);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = meshes.find(key);
+        if(it != meshes.end())
+            return it->second;
+    }
+    
+    DerivedData data;
+    Mesh* mesh = nullptr;
+    if((data.diskKey = MakeDiskKey(filename, scale, smooth, sizeThreshold)) != 0
+       && (mesh = ReadMeshBlob(data.diskKey)) != nullptr)
+        ReadDerivedRecords(data.diskKey, data);
+    
+    if(mesh == nullptr)
+    {
+        mesh = CopyMesh(GetMesh(filename, scale, smooth).get());
+        OpenGLContent::Refine(mesh, sizeThreshold);
+        if(data.diskKey != 0)
+            WriteMeshBlob(data.diskKey, mesh);
+    }
+    return Insert(key, mesh, data);
+}
+
+MeshProperties MeshCache::GetPhysicalProperties(const Mesh* mesh, Scalar thickness, Scalar density)
+{
+    std::pair<Scalar, Scalar> key(thickness, density);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = derived.find(mesh);
+        if(it == derived.end())
+            return ComputePhysicalProperties(mesh, thickness, density);
+        auto pit = it->second.properties.find(key);
+        if(pit != it->second.properties.end())
+            return pit->second;
+    }
+
+    MeshProperties mp = ComputePhysicalProperties(mesh, thickness, density);
+    uint64_t diskKey = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = derived.find(mesh);
+        if(it != derived.end())
+        {
+            it->second.properties[key] = mp;
+            diskKey = it->second.diskKey;
+        }
+    }
+    
+    if(diskKey != 0)
+    {
+        std::vector<double> payload = {thickness, density, mp.mass, mp.CG.x(), mp.CG.y(), mp.CG.z(), mp.volume, mp.surface,
+                                       mp.Ipri.x(), mp.Ipri.y(), mp.Ipri.z()};
+        for(int i=0; i<3; ++i)
+            for(int h=0; h<3; ++h)
+                payload.push_back(mp.Irot[i][h]);
+        AppendDerivedRecord(diskKey, DerivedRecordType::PROPERTIES, payload);
+    }
+    return mp;
+}
+
+std::shared_ptr<const std::vector<Vector3>> MeshCache::GetConvexHull(const Mesh* mesh, unsigned int maxVertices)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = derived.find(mesh);
+        if(it != derived.end())
+        {
+            auto hit = it->second.hulls.find(maxVertices);
+            if(hit != it->second.hulls.end())
+                return hit->second;
+        }
+    }
+    
+    std::vector<Vector3> points(mesh->getNumOfVertices());
+    for(size_t i=0; i<points.size(); ++i)
+    {
+        glm::vec3 pos = mesh->getVertexPos(i);
+        points[i] = Vector3(pos.x, pos.y, pos.z);
+    }
+    std::vector<Vector3> hullPoints = ComputeConvexHull(points, maxVertices);
+    if(hullPoints.empty() && !points.empty()) //Hull computation failed (degenerate geometry)
+    {
+        cWarning("Failed to compute the convex hull of a mesh, using all of its vertices.");
+        hullPoints = points;
+    }
+    std::shared_ptr<const std::vector<Vector3>> hull = std::make_shared<const std::vector<Vector3>>(hullPoints);
+    uint64_t diskKey = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = derived.find(mesh);
+        if(it != derived.end())
+        {
+            it->second.hulls[maxVertices] = hull;
+            diskKey = it->second.diskKey;
+        }
+    }
+    
+    if(diskKey != 0)
+    {
+        std::vector<double> payload = {(double)maxVertices};
+        for(size_t i=0; i<hull->size(); ++i)
+            for(int h=0; h<3; ++h)
+                payload.push_back((*hull)[i][h]);
+        AppendDerivedRecord(diskKey, DerivedRecordType::HULL, payload);
+    }
+    return hull;
+}
+
+std::shared_ptr<const std::vector<std::vector<Vector3>>> MeshCache::GetConvexDecomposition(const Mesh* mesh, unsigned int maxParts, unsigned int maxHullVertices)
+{
+    std::pair<unsigned int, unsigned int> key(maxParts, maxHullVertices);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = derived.find(mesh);
+        if(it != derived.end())
+        {
+            auto dit = it->second.decompositions.find(key);
+            if(dit != it->second.decompositions.end())
+                return dit->second;
+        }
+    }
+    
+    int64_t start = GetTimeInMicroseconds();
+    std::shared_ptr<const std::vector<std::vector<Vector3>>> parts 
+        = std::make_shared<const std::vector<std::vector<Vector3>>>(ComputeConvexDecomposition(mesh, maxParts, maxHullVertices));
+    cInfo("Decomposed mesh into %ld convex parts in %ld ms.", parts->size(), (GetTimeInMicroseconds() - start)/1000);
+    uint64_t diskKey = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = derived.find(mesh);
+        if(it != derived.end())
+        {
+            it->second.decompositions[key] = parts;
+            diskKey = it->second.diskKey;
+        }
+    }
+    
+    if(diskKey != 0)
+    {
+        std::vector<double> payload = {(double)maxParts, (double)maxHullVertices, (double)parts->size()};
+        for(size_t i=0; i<parts->size(); ++i)
+        {
+            payload.push_back((double)(*parts)[i].size());
+            for(size_t h=0; h<(*parts)[i].size(); ++h)
+                for(int a=0; a<3; ++a)
+                    payload.push_back((*parts)[i][h][a]);
+        }
+        AppendDerivedRecord(diskKey, DerivedRecordType::DECOMPOSITION, payload);
+    }
+    return parts;
+}
+
+std::shared_ptr<btBvhTriangleMeshShape> MeshCache::GetTriangleMeshShape(const std::shared_ptr<const Mesh>& mesh)
+{
+    uint64_t diskKey = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = triangleMeshes.find(mesh.get());
+        if(it != triangleMeshes.end())
+            return it->second.shape;
+        auto dit = derived.find(mesh.get());
+        if(dit != derived.end())
+            diskKey = dit->second.diskKey;
+    }
+    
+    //Reference vertex positions and indices of the mesh directly
+    TriangleMeshData data;
+    data.mesh = mesh;
+    data.map = nullptr;
+    data.mapSize = 0;
+    btIndexedMesh im;
+    im.m_numTriangles = (int)mesh->faces.size();
+    im.m_triangleIndexBase = (const unsigned char*)mesh->faces.data();
+    im.m_triangleIndexStride = sizeof(Face);
+    im.m_indexType = PHY_INTEGER;
+    im.m_numVertices = (int)mesh->getNumOfVertices();
+    im.m_vertexBase = (const unsigned char*)mesh->getVertexDataPointer();
+    im.m_vertexStride = (int)mesh->getVertexSize();
+    im.m_vertexType = PHY_FLOAT;
+    data.array = new btTriangleIndexVertexArray();
+    data.array->addIndexedMesh(im, PHY_INTEGER);
+    
+    btOptimizedBvh* bvh = diskKey != 0 ? ReadBvh(diskKey, mesh.get(), data.map, data.mapSize) : nullptr;
+    if(bvh != nullptr)
+    {
+        data.shape = std::shared_ptr<btBvhTriangleMeshShape>(new btBvhTriangleMeshShape(data.array, true, false));
+        data.shape->setOptimizedBvh(bvh);
+    }
+    else
+    {
+        int64_t start = GetTimeInMicroseconds();
+        data.shape = std::shared_ptr<btBvhTriangleMeshShape>(new btBvhTriangleMeshShape(data.array, true, true));
+        cInfo("Built bounding volume hierarchy of %ld triangles in %ld ms.", mesh->faces.size(), (GetTimeInMicroseconds() - start)/1000);
+        if(diskKey != 0)
+            WriteBvh(diskKey, mesh.get(), data.shape->getOptimizedBvh());
+    }
+    data.shape->setMargin(0);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = triangleMeshes.find(mesh.get());
+    if(it != triangleMeshes.end()) //Another thread built the same shape in the meantime
+    {
+        DestroyTriangleMesh(data);
+        return it->second.shape;
+    }
+    triangleMeshes[mesh.get()] = data;
+    return data.shape;
+}
+
+bool MeshCache::FindEllipsoid(const Mesh* mesh, const Transform& T, const Vector3& offset, Vector3& axes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = derived.find(mesh);
+    if(it == derived.end())
+        return false;
+    for(size_t i=0; i<it->second.ellipsoids.size(); ++i)
+    {
+        const EllipsoidEntry& e = it->second.ellipsoids[i];
+        if(e.T == T && e.offset == offset)
+        {
+            axes = e.axes;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MeshCache::StoreEllipsoid(const Mesh* mesh, const Transform& T, const Vector3& offset, const Vector3& axes)
+{
+    uint64_t diskKey = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = derived.find(mesh);
+        if(it == derived.end())
+            return;
+        EllipsoidEntry e;
+        e.T = T;
+        e.offset = offset;
+        e.axes = axes;
+        it->second.ellipsoids.push_back(e);
+        diskKey = it->second.diskKey;
+    }
+    
+    if(diskKey != 0)
+    {
+        std::vector<double> payload;
+        for(int i=0; i<3; ++i)
+            for(int h=0; h<3; ++h)
+                payload.push_back(T.getBasis()[i][h]);
+        for(int i=0; i<3; ++i)
+            payload.push_back(T.getOrigin()[i]);
+        for(int i=0; i<3; ++i)
+            payload.push_back(offset[i]);
+        for(int i=0; i<3; ++i)
+            payload.push_back(axes[i]);
+        AppendDerivedRecord(diskKey, DerivedRecordType::ELLIPSOID, payload);
+    }
+}
+
+Mesh* MeshCache::CopyMesh(const Mesh* mesh)
+{
+    if(mesh->isTexturable())
+        return new TexturableMesh(*static_cast<const TexturableMesh*>(mesh));
+    else
+        return new PlainMesh(*static_cast<const PlainMesh*>(mesh));
+}
+
+void MeshCache::Purge()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    //Collision shapes keep their source meshes alive, so the unused ones have to be released first
+    for(auto it = triangleMeshes.begin(); it != triangleMeshes.end();)
+    {
+        if(it->second.shape.use_count() == 1) //Only referenced by the cache
+        {
+            DestroyTriangleMesh(it->second);
+            it = triangleMeshes.erase(it);
+        }
+        else
+            ++it;
+    }
+    
+    for(auto it = meshes.begin(); it != meshes.end();)
+    {
+        if(it->second.use_count() == 1) //Only referenced by the cache
+        {
+            derived.erase(it->second.get());
+            it = meshes.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void MeshCache::setRetainUnused(bool retain)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    retainUnused = retain;
+}
+
+bool MeshCache::isRetainingUnused()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return retainUnused;
+}
+
+void MeshCache::DestroyTriangleMesh(TriangleMeshData& data)
+{
+    data.shape.reset(); //The shape references the array and the memory-mapped hierarchy
+    delete data.array;
+    data.array = nullptr;
+    if(data.map != nullptr)
+        munmap(data.map, data.mapSize);
+    data.map = nullptr;
+    data.mesh.reset();
+}
+
+size_t MeshCache::getNumOfMeshes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return meshes.size();
+}
+
+
+void MeshCache::setDiskCacheDirectory(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    diskCacheDir = path;
+    diskCacheDirSet = true;
+}
+
+std::string MeshCache::getDiskCacheDirectory()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!diskCacheDirSet)
+    {
+        const char* env;
+        if((env = getenv("STONEFISH_CACHE_DIR")) != nullptr)
+            diskCacheDir = std::string(env);
+        else if((env = getenv("XDG_CACHE_HOME")) != nullptr && env[0] != '\0')
+            diskCacheDir = std::string(env) + "/stonefish";
+        else if((env = getenv("HOME")) != nullptr)
+            diskCacheDir = std::string(env) + "/.cache/stonefish";
+        diskCacheDirSet = true;
+    }
+    return diskCacheDir;
+}
+
+void MeshCache::setDiskCacheSizeLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    diskCacheLimit = bytes;
+}
+
+size_t MeshCache::getDiskCacheSizeLimit()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return diskCacheLimit;
+}
+
+uint64_t MeshCache::MakeDiskKey(const std::string& filename, GLfloat scale, bool smooth, GLfloat sizeThreshold)
+{
+    std::string dir = getDiskCacheDirectory();
+    if(dir == "")
+        return 0;
+    
+    //Hash the contents of the source file (once per process)
+    uint64_t sourceHash = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = sourceHashes.find(filename);
+        if(it != sourceHashes.end())
+            sourceHash = it->second;
+    }
+    if(sourceHash == 0)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if(fd < 0)
+            return 0;
+        struct stat st;
+        void* map = MAP_FAILED;
+        if(fstat(fd, &st) == 0 && st.st_size > 0)
+            map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(map == MAP_FAILED)
+            return 0;
+        madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+        sourceHash = HashBytes((const char*)map, (size_t)st.st_size) ^ (uint64_t)st.st_size;
+        munmap(map, (size_t)st.st_size);
+        std::lock_guard<std::mutex> lock(mutex);
+        sourceHashes[filename] = sourceHash;
+    }
+    
+    //Combine with processing parameters
+    struct
+    {
+        uint64_t source;
+        uint32_t version;
+        GLfloat scale;
+        uint32_t smooth;
+        GLfloat sizeThreshold;
+    } params;
+    memset(&params, 0, sizeof(params));
+    params.source = sourceHash;
+    params.version = MESH_CACHE_VERSION;
+    params.scale = scale;
+    params.smooth = smooth ? 1 : 0;
+    params.sizeThreshold = sizeThreshold;
+    uint64_t key = HashBytes((const char*)&params, sizeof(params));
+    return key == 0 ? 1 : key;
+}
+
+std::string MeshCache::DiskPath(uint64_t key, const char* extension)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.%s", (unsigned long long)key, extension);
+    return getDiskCacheDirectory() + std::string(name);
+}
+
+Mesh* MeshCache::ReadMeshBlob(uint64_t key)
+{
+    std::string path = DiskPath(key, "sfm");
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return nullptr;
+    struct stat st;
+    void* map = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(MeshBlobHeader))
+        map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+        return nullptr;
+    
+    size_t size = (size_t)st.st_size;
+    const char* data = (const char*)map;
+    MeshBlobHeader header;
+    memcpy(&header, data, sizeof(header));
+    Mesh* mesh = nullptr;
+    size_t vSize = header.texturable ? sizeof(TexturableVertex) : sizeof(Vertex);
+    
+    if(strncmp(header.magic, "SFMB", 4) == 0 && header.version == MESH_CACHE_VERSION && header.key == key
+       && header.vertexSize == vSize && size == sizeof(header) + header.nVertices * vSize + header.nFaces * sizeof(Face))
+    {
+        const char* vData = data + sizeof(header);
+        const char* fData = vData + header.nVertices * vSize;
+        if(header.texturable)
+        {
+            TexturableMesh* m = new TexturableMesh;
+            m->vertices.resize(header.nVertices);
+            memcpy((void*)m->vertices.data(), vData, header.nVertices * vSize);
+            mesh = m;
+        }
+        else
+        {
+            PlainMesh* m = new PlainMesh;
+            m->vertices.resize(header.nVertices);
+            memcpy((void*)m->vertices.data(), vData, header.nVertices * vSize);
+            mesh = m;
+        }
+        mesh->faces.resize(header.nFaces);
+        memcpy((void*)mesh->faces.data(), fData, header.nFaces * sizeof(Face));
+    }
+    else
+        cWarning("Ignoring invalid mesh cache entry: %s", path.c_str());
+    
+    munmap(map, size);
+    if(mesh != nullptr)
+        utimes(path.c_str(), nullptr); //Mark as recently used
+    return mesh;
+}
+
+void MeshCache::WriteMeshBlob(uint64_t key, const Mesh* mesh)
+{
+    std::string dir = getDiskCacheDirectory();
+    for(size_t i = 1; i <= dir.size(); ++i) //Create directories
+        if(i == dir.size() || dir[i] == '/')
+            mkdir(dir.substr(0, i).c_str(), 0755);
+    
+    MeshBlobHeader header;
+    memcpy(header.magic, "SFMB", 4);
+    header.version = MESH_CACHE_VERSION;
+    header.key = key;
+    header.texturable = mesh->isTexturable() ? 1 : 0;
+    header.vertexSize = (uint32_t)mesh->getVertexSize();
+    header.nVertices = mesh->getNumOfVertices();
+    header.nFaces = mesh->faces.size();
+    
+    //Write to a temporary file and rename, so that other processes never see partial data
+    std::string path = DiskPath(key, "sfm");
+    std::string tmpPath = path + ".tmp" + std::to_string((long)getpid());
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if(file == nullptr)
+    {
+        cWarning("Failed to write mesh cache entry: %s", path.c_str());
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if(header.nVertices > 0)
+        ok = ok && fwrite(mesh->getVertexDataPointer(), header.vertexSize * header.nVertices, 1, file) == 1;
+    if(header.nFaces > 0)
+        ok = ok && fwrite(mesh->faces.data(), sizeof(Face) * header.nFaces, 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    if(!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tmpPath.c_str());
+        cWarning("Failed to write mesh cache entry: %s", path.c_str());
+    }
+    else
+        PruneDiskCache();
+}
+
+btOptimizedBvh* MeshCache::ReadBvh(uint64_t key, const Mesh* mesh, void*& map, size_t& mapSize)
+{
+    std::string path = DiskPath(key, "sfb");
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return nullptr;
+    struct stat st;
+    map = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && (size_t)st.st_size > sizeof(BvhBlobHeader))
+        map = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0); //Pages are only copied if modified
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        map = nullptr;
+        return nullptr;
+    }
+    mapSize = (size_t)st.st_size;
+    
+    BvhBlobHeader header;
+    memcpy(&header, map, sizeof(header));
+    btOptimizedBvh* bvh = nullptr;
+    if(strncmp(header.magic, "SFBV", 4) == 0 && header.version == MESH_CACHE_VERSION && header.key == key 
+       && header.nFaces == mesh->faces.size() && header.size == mapSize - sizeof(header))
+        bvh = btOptimizedBvh::deSerializeInPlace((char*)map + sizeof(header), (unsigned int)header.size, false);
+    
+    if(bvh == nullptr)
+    {
+        cWarning("Ignoring invalid mesh cache entry: %s", path.c_str());
+        munmap(map, mapSize);
+        map = nullptr;
+        mapSize = 0;
+    }
+    else
+        utimes(path.c_str(), nullptr); //Mark as recently used
+    return bvh;
+}
+
+void MeshCache::WriteBvh(uint64_t key, const Mesh* mesh, const btOptimizedBvh* bvh)
+{
+    BvhBlobHeader header;
+    memcpy(header.magic, "SFBV", 4);
+    header.version = MESH_CACHE_VERSION;
+    header.key = key;
+    header.nFaces = mesh->faces.size();
+    header.size = bvh->calculateSerializeBufferSize();
+    void* buffer = btAlignedAlloc(header.size, 16);
+    if(!bvh->serializeInPlace(buffer, (unsigned int)header.size, false))
+    {
+        btAlignedFree(buffer);
+        return;
+    }
+    
+    std::string path = DiskPath(key, "sfb");
+    std::string tmpPath = path + ".tmp" + std::to_string((long)getpid());
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    bool ok = file != nullptr;
+    if(ok)
+    {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(buffer, header.size, 1, file) == 1;
+        ok = (fclose(file) == 0) && ok;
+    }
+    btAlignedFree(buffer);
+    if(!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tmpPath.c_str());
+        cWarning("Failed to write mesh cache entry: %s", path.c_str());
+    }
+    else
+        PruneDiskCache();
+}
+
+void MeshCache::PruneDiskCache()
+{
+    size_t limit = getDiskCacheSizeLimit();
+    std::string dir = getDiskCacheDirectory();
+    if(limit == 0 || dir == "")
+        return;
+    
+    std::lock_guard<std::mutex> lock(diskMutex);
+    DIR* d = opendir(dir.c_str());
+    if(d == nullptr)
+        return;
+    
+    //Group the files by entry (all files of an entry share the key), the last use is the latest modification
+    struct DiskEntry
+    {
+        size_t size;
+        time_t lastUsed;
+    };
+    std::map<std::string, DiskEntry> entries;
+    size_t total = 0;
+    struct dirent* de;
+    while((de = readdir(d)) != nullptr)
+    {
+        std::string name(de->d_name);
+        if(name.size() != 20 || name[16] != '.' || (name.compare(17, 3, "sfm") != 0 && name.compare(17, 3, "sfb") != 0 && name.compare(17, 3, "sfd") != 0))
+            continue;
+        struct stat st;
+        if(stat((dir + "/" + name).c_str(), &st) != 0)
+            continue;
+        DiskEntry& e = entries.insert({name.substr(0, 16), DiskEntry{0, 0}}).first->second;
+        e.size += (size_t)st.st_size;
+        e.lastUsed = std::max(e.lastUsed, st.st_mtime);
+        total += (size_t)st.st_size;
+    }
+    closedir(d);
+    if(total <= limit)
+        return;
+    
+    //Remove the least recently used entries
+    std::vector<std::pair<time_t, std::string>> order;
+    for(auto it = entries.begin(); it != entries.end(); ++it)
+        order.push_back(std::make_pair(it->second.lastUsed, it->first));
+    std::sort(order.begin(), order.end());
+    for(size_t i=0; i<order.size() && total > limit; ++i)
+    {
+        remove((dir + "/" + order[i].second + ".sfm").c_str());
+        remove((dir + "/" + order[i].second + ".sfb").c_str());
+        remove((dir + "/" + order[i].second + ".sfd").c_str());
+        total -= entries[order[i].second].size;
+    }
+}
+
+void MeshCache::ReadDerivedRecords(uint64_t key, DerivedData& data)
+{
+    std::lock_guard<std::mutex> lock(diskMutex);
+    FILE* file = fopen(DiskPath(key, "sfd").c_str(), "rb");
+    if(file == nullptr)
+        return;
+    
+    char magic[4];
+    uint32_t version;
+    if(fread(magic, 4, 1, file) != 1 || strncmp(magic, "SFMD", 4) != 0
+       || fread(&version, sizeof(version), 1, file) != 1 || version != MESH_CACHE_VERSION)
+    {
+        fclose(file);
+        return;
+    }
+    
+    DerivedRecordHeader rh;
+    std::vector<double> p;
+    while(fread(&rh, sizeof(rh), 1, file) == 1 && rh.count <= (1u << 24))
+    {
+        p.resize(rh.count);
+        if(rh.count > 0 && fread(p.data(), sizeof(double), rh.count, file) != rh.count) //Partially written record
+            break;
+        
+        if(rh.type == (uint32_t)DerivedRecordType::PROPERTIES && rh.count == 20)
+        {
+            MeshProperties mp;
+            mp.mass = p[2];
+            mp.CG = Vector3(p[3], p[4], p[5]);
+            mp.volume = p[6];
+            mp.surface = p[7];
+            mp.Ipri = Vector3(p[8], p[9], p[10]);
+            mp.Irot = Matrix3(p[11], p[12], p[13], p[14], p[15], p[16], p[17], p[18], p[19]);
+            data.properties[std::make_pair(Scalar(p[0]), Scalar(p[1]))] = mp;
+        }
+        else if(rh.type == (uint32_t)DerivedRecordType::ELLIPSOID && rh.count == 18)
+        {
+            EllipsoidEntry e;
+            e.T = Transform(Matrix3(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]), Vector3(p[9], p[10], p[11]));
+            e.offset = Vector3(p[12], p[13], p[14]);
+            e.axes = Vector3(p[15], p[16], p[17]);
+            data.ellipsoids.push_back(e);
+        }
+        else if(rh.type == (uint32_t)DerivedRecordType::HULL && rh.count % 3 == 1)
+        {
+            std::vector<Vector3> hull(rh.count/3);
+            for(size_t i=0; i<hull.size(); ++i)
+                hull[i] = Vector3(p[i*3+1], p[i*3+2], p[i*3+3]);
+            data.hulls[(unsigned int)p[0]] = std::make_shared<const std::vector<Vector3>>(std::move(hull));
+        }
+        else if(rh.type == (uint32_t)DerivedRecordType::DECOMPOSITION && rh.count >= 3
+                && p[2] >= 0.0 && p[2] <= (double)(rh.count - 3)) //Each part takes at least one value
+        {
+            std::vector<std::vector<Vector3>> parts((size_t)p[2]);
+            size_t offset = 3;
+            size_t i = 0;
+            for(; i<parts.size() && offset < p.size(); ++i)
+            {
+                double count = p[offset++];
+                if(!(count >= 0.0 && count <= (double)((p.size() - offset)/3))) //Corrupt count (also NaN)
+                    break;
+                size_t n = (size_t)count;
+                parts[i].resize(n);
+                for(size_t h=0; h<n; ++h, offset+=3)
+                    parts[i][h] = Vector3(p[offset], p[offset+1], p[offset+2]);
+            }
+            if(i == parts.size() && offset == p.size())
+                data.decompositions[std::make_pair((unsigned int)p[0], (unsigned int)p[1])] = std::make_shared<const std::vector<std::vector<Vector3>>>(std::move(parts));
+        }
+    }
+    fclose(file);
+}
+
+void MeshCache::AppendDerivedRecord(uint64_t key, DerivedRecordType type, const std::vector<double>& payload)
+{
+    //Lock so that the file header is written only once and records of different threads are not interleaved
+    std::lock_guard<std::mutex> lock(diskMutex);
+    FILE* file = fopen(DiskPath(key, "sfd").c_str(), "ab");
+    if(file == nullptr)
+        return;
+    
+    //Assemble the whole record to write it at once
+    std::vector<char> record;
+    fseek(file, 0, SEEK_END);
+    if(ftell(file) == 0)
+    {
+        uint32_t version = MESH_CACHE_VERSION;
+        record.insert(record.end(), "SFMD", "SFMD" + 4);
+        record.insert(record.end(), (const char*)&version, (const char*)&version + sizeof(version));
+    }
+    DerivedRecordHeader rh;
+    rh.type = (uint32_t)type;
+    rh.count = (uint32_t)payload.size();
+    record.insert(record.end(), (const char*)&rh, (const char*)&rh + sizeof(rh));
+    record.insert(record.end(), (const char*)payload.data(), (const char*)(payload.data() + payload.size()));
+    fwrite(record.data(), record.size(), 1, file);
+    fclose(file);
+}
+
+}
@@ -24,26 +24,63 @@
 //
 
 #include "utils/PerformanceMonitor.h"
-#include <numeric>
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include "LinearMath/btAlignedAllocator.h"
+#ifdef __linux__
+    #include <malloc.h>
+#elif __APPLE__
+    #include <malloc/malloc.h>
+#else //WINDOWS
+    #include <malloc.h>
+#endif
+#include "utils/TraceRecorder.h"
 
 namespace sf
 {
 
-PerformanceMonitor::PerformanceMonitor(size_t averageMaxCount)
+std::atomic<int64_t> PerformanceMonitor::bulletMemory(0);
+
+// Size of a block returned by malloc (blocks are not prefixed with a header, so that the blocks
+// allocated by Bullet before the allocator was installed can still be freed)
+static inline size_t BulletBlockSize(void* ptr)
 {
-    maxCount = averageMaxCount;
-    
+#ifdef __linux__
+    return malloc_usable_size(ptr);
+#elif __APPLE__
+    return malloc_size(ptr);
+#else //WINDOWS
+    return _msize(ptr);
+#endif
+}
+
+// Installs the counting allocator at process start, before Bullet is used
+static struct BulletAllocatorInstaller
+{
+    BulletAllocatorInstaller() { PerformanceMonitor::InstallBulletAllocator(); }
+} bulletAllocatorInstaller;
+
+PerformanceMonitor::PerformanceMonitor(size_t windowSize)
+{
+    window = windowSize < 1 ? 1 : windowSize;
     simTime = 0;
     simFinished = true;
-    phyTime = std::deque<double>(0);
-    phyTimeAvg = 0;
-    hydroTime = std::deque<double>(0);
-    hydroTimeAvg = 0;
+    phases = new PhaseBuffer[(size_t)PerformancePhase::COUNT];
+    for(size_t i=0; i<(size_t)PerformancePhase::COUNT; ++i)
+    {
+        phases[i].samples = std::vector<std::atomic<double>>(window);
+        phases[i].sum = 0.0;
+        phases[i].count = 0;
+    }
+    for(size_t i=0; i<(size_t)MemoryCategory::COUNT; ++i)
+        memory[i] = 0;
     updateMtx = SDL_CreateMutex();
 }
 
 PerformanceMonitor::~PerformanceMonitor()
 {
+    delete [] phases;
     SDL_DestroyMutex(updateMtx);
 }
 
@@ -53,10 +90,11 @@ void PerformanceMonitor::SimulationStarted()
     simStart = std::chrono::high_resolution_clock::now();
     simTime = 0;
     simFinished = false;
-    phyTime.clear();
-    phyTimeAvg = 0;
-    hydroTime.clear();
-    hydroTimeAvg = 0;
+    for(size_t i=0; i<(size_t)PerformancePhase::COUNT; ++i)
+    {
+        phases[i].count.store(0);
+        phases[i].sum.store(0.0);
+    }
     SDL_UnlockMutex(updateMtx);
 }
 
@@ -71,22 +109,51 @@ void PerformanceMonitor::SimulationFinished()
 
 void PerformanceMonitor::PhysicsStarted()
 {
-    phyStart = std::chrono::high_resolution_clock::now();
+    PhaseStarted(PerformancePhase::PHYSICS);
 }
 
 void PerformanceMonitor::PhysicsFinished()
 {
-    Update(phyStart, phyTime, phyTimeAvg);
+    PhaseFinished(PerformancePhase::PHYSICS);
 }
 
 void PerformanceMonitor::HydrodynamicsStarted()
 {
-    hydroStart = std::chrono::high_resolution_clock::now();
+    PhaseStarted(PerformancePhase::HYDRODYNAMICS);
 }
 
 void PerformanceMonitor::HydrodynamicsFinished()
 {
-    Update(hydroStart, hydroTime, hydroTimeAvg);
+    PhaseFinished(PerformancePhase::HYDRODYNAMICS);
+}
+
+void PerformanceMonitor::PhaseStarted(PerformancePhase phase)
+{
+    phases[(size_t)phase].start = std::chrono::steady_clock::now();
+}
+
+void PerformanceMonitor::PhaseFinished(PerformancePhase phase)
+{
+    auto end = std::chrono::steady_clock::now();
+    PhaseBuffer& buf = phases[(size_t)phase];
+    double elapsed = std::chrono::duration<double, std::micro>(end - buf.start).count();
+    TraceRecorder::Record(getPhaseName(phase), "phase", buf.start, end);
+    
+    // Only the simulation thread writes, readers see complete samples thanks to the atomic counter
+    unsigned long long n = buf.count.load(std::memory_order_relaxed);
+    size_t slot = (size_t)(n % window);
+    double evicted = n >= window ? buf.samples[slot].load(std::memory_order_relaxed) : 0.0;
+    buf.samples[slot].store(elapsed, std::memory_order_relaxed);
+    if(slot == window-1) // Recompute the sum once per window to avoid drift (amortised constant cost)
+    {
+        double sum = 0.0;
+        for(size_t i=0; i<window; ++i)
+            sum += buf.samples[i].load(std::memory_order_relaxed);
+        buf.sum.store(sum, std::memory_order_relaxed);
+    }
+    else
+        buf.sum.store(buf.sum.load(std::memory_order_relaxed) + elapsed - evicted, std::memory_order_relaxed);
+    buf.count.store(n + 1, std::memory_order_release);
 }
 
 double PerformanceMonitor::getSimulationTime()
@@ -104,49 +171,212 @@ double PerformanceMonitor::getSimulationTime()
 
 double PerformanceMonitor::getPhysicsTime()
 {
-    SDL_LockMutex(updateMtx);
-    double t = phyTime.back();
-    SDL_UnlockMutex(updateMtx);
-    return t;
+    return getPhaseStats(PerformancePhase::PHYSICS).last;
 }
 
 double PerformanceMonitor::getPhysicsTimeAverage()
 {
-    SDL_LockMutex(updateMtx);
-    double t = phyTimeAvg;
-    SDL_UnlockMutex(updateMtx);
-    return t;
+    return getPhaseStats(PerformancePhase::PHYSICS).mean;
 }
 
 double PerformanceMonitor::getHydrodynamicsTime()
+{
+    return getPhaseStats(PerformancePhase::HYDRODYNAMICS).last;
+}
+
+double PerformanceMonitor::getHydrodynamicsTimeAverage()
+{
+    return getPhaseStats(PerformancePhase::HYDRODYNAMICS).mean;
+}
+
+std::vector<double> PerformanceMonitor::getPhaseSamples(PerformancePhase phase, size_t len)
+{
+    PhaseBuffer& buf = phases[(size_t)phase];
+    unsigned long long n = buf.count.load(std::memory_order_acquire);
+    size_t size = (size_t)std::min<unsigned long long>(n, window);
+    size = std::min(size, len);
+    std::vector<double> data(size);
+    for(size_t i=0; i<size; ++i) // Oldest first
+        data[i] = buf.samples[(size_t)((n - size + i) % window)].load(std::memory_order_relaxed);
+    return data;
+}
+
+PerformanceStats PerformanceMonitor::getPhaseStats(PerformancePhase phase)
+{
+    PerformanceStats stats;
+    stats.last = stats.min = stats.mean = stats.p95 = stats.p99 = 0.0;
+    std::vector<double> data = getPhaseSamples(phase, window);
+    stats.samples = data.size();
+    if(data.empty())
+        return stats;
+    
+    stats.last = data.back();
+    stats.mean = phases[(size_t)phase].sum.load(std::memory_order_relaxed) / (double)data.size();
+    std::sort(data.begin(), data.end());
+    stats.min = data.front();
+    stats.p95 = data[std::min((size_t)(0.95 * data.size()), data.size()-1)];
+    stats.p99 = data[std::min((size_t)(0.99 * data.size()), data.size()-1)];
+    return stats;
+}
+
+const char* PerformanceMonitor::getPhaseName(PerformancePhase phase)
+{
+    switch(phase)
+    {
+        case PerformancePhase::PHYSICS:
+            return "Physics";
+        case PerformancePhase::ACTUATORS:
+            return "Actuators";
+        case PerformancePhase::JOINT_DAMPING:
+            return "Joint damping";
+        case PerformancePhase::GRAVITY:
+            return "Gravity";
+        case PerformancePhase::TRIGGERS:
+            return "Triggers";
+        case PerformancePhase::TERRAIN:
+            return "Terrain";
+        case PerformancePhase::AERODYNAMICS:
+            return "Aerodynamics";
+        case PerformancePhase::HYDRODYNAMICS:
+            return "Hydrodynamics";
+        case PerformancePhase::BROADPHASE:
+            return "Broadphase";
+        case PerformancePhase::NARROWPHASE:
+            return "Narrowphase";
+        case PerformancePhase::SOLVER:
+            return "Solver";
+        case PerformancePhase::SENSORS:
+            return "Sensors";
+        case PerformancePhase::COMMS:
+            return "Comms";
+        case PerformancePhase::CONTACTS:
+            return "Contacts";
+        default:
+            return "";
+    }
+}
+
+void HydrodynamicsCounters::Count(bool recomputed)
+{
+    evaluations.store(evaluations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if(recomputed)
+        recomputations.store(recomputations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+HydrodynamicsCounters* PerformanceMonitor::AddHydrodynamicsBody(const std::string& bodyName)
 {
     SDL_LockMutex(updateMtx);
-    double t = hydroTime.back();
+    hydroCounters.emplace_back(bodyName);
+    HydrodynamicsCounters* counters = &hydroCounters.back();
     SDL_UnlockMutex(updateMtx);
-    return t;
+    return counters;
 }
 
-double PerformanceMonitor::getHydrodynamicsTimeAverage()
+void PerformanceMonitor::ClearHydrodynamicsBodies()
 {
     SDL_LockMutex(updateMtx);
-    double t = hydroTimeAvg;
+    hydroCounters.clear();
     SDL_UnlockMutex(updateMtx);
-    return t;
 }
 
-void PerformanceMonitor::Update(const std::chrono::high_resolution_clock::time_point& start, std::deque<double>& times, double& average)
+std::map<std::string, HydrodynamicsStats> PerformanceMonitor::getHydrodynamicsStats()
 {
-    // Compute elapsed time
-    auto end = std::chrono::high_resolution_clock::now();
+    std::map<std::string, HydrodynamicsStats> stats;
+    SDL_LockMutex(updateMtx); //Protects the list of bodies, not the counters
+    for(size_t i=0; i<hydroCounters.size(); ++i)
+    {
+        HydrodynamicsStats s;
+        s.evaluations = hydroCounters[i].evaluations.load(std::memory_order_relaxed);
+        s.recomputations = hydroCounters[i].recomputations.load(std::memory_order_relaxed);
+        stats[hydroCounters[i].name] = s;
+    }
+    SDL_UnlockMutex(updateMtx);
+    return stats;
+}
+
+double PerformanceMonitor::getHydrodynamicsRecomputeRatio()
+{
+    unsigned long long evaluations = 0;
+    unsigned long long recomputations = 0;
     SDL_LockMutex(updateMtx);
-    double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    // Update averaging queue
-    times.push_back(elapsed);
-    if(times.size() > maxCount)
-        times.pop_front();
-    // Update average
-    average = std::accumulate(times.begin(), times.end(), 0.0) / (double)times.size();
+    for(size_t i=0; i<hydroCounters.size(); ++i)
+    {
+        evaluations += hydroCounters[i].evaluations.load(std::memory_order_relaxed);
+        recomputations += hydroCounters[i].recomputations.load(std::memory_order_relaxed);
+    }
     SDL_UnlockMutex(updateMtx);
+    return evaluations > 0 ? (double)recomputations/(double)evaluations : 1.0;
+}
+
+void PerformanceMonitor::setMemoryUsage(MemoryCategory category, size_t bytes)
+{
+    memory[(size_t)category].store(bytes, std::memory_order_relaxed);
 }
 
-}
\ No newline at end of file
+size_t PerformanceMonitor::getMemoryUsage(MemoryCategory category)
+{
+    return memory[(size_t)category].load(std::memory_order_relaxed);
+}
+
+size_t PerformanceMonitor::getTotalMemoryUsage()
+{
+    size_t total = 0;
+    for(size_t i=0; i<(size_t)MemoryCategory::COUNT; ++i)
+        total += memory[i].load(std::memory_order_relaxed);
+    return total;
+}
+
+const char* PerformanceMonitor::getMemoryCategoryName(MemoryCategory category)
+{
+    switch(category)
+    {
+        case MemoryCategory::GRAPHICS_MESHES:
+            return "Graphics meshes";
+        case MemoryCategory::PHYSICS_MESHES:
+            return "Physics meshes";
+        case MemoryCategory::SENSOR_HISTORY:
+            return "Sensor history";
+        case MemoryCategory::CONTACT_HISTORY:
+            return "Contact history";
+        case MemoryCategory::BULLET:
+            return "Bullet";
+        case MemoryCategory::GL_BUFFERS:
+            return "GL buffers";
+        case MemoryCategory::GL_TEXTURES:
+            return "GL textures";
+        case MemoryCategory::COMMS:
+            return "Comm buffers";
+        default:
+            return "";
+    }
+}
+
+void PerformanceMonitor::InstallBulletAllocator()
+{
+    static std::once_flag installed;
+    std::call_once(installed, []() { btAlignedAllocSetCustom(BulletAlloc, BulletFree); });
+}
+
+size_t PerformanceMonitor::getBulletMemoryUsage()
+{
+    int64_t bytes = bulletMemory.load(std::memory_order_relaxed);
+    return bytes > 0 ? (size_t)bytes : 0; //Blocks allocated before installation are subtracted when freed
+}
+
+void* PerformanceMonitor::BulletAlloc(size_t size)
+{
+    void* ptr = malloc(size);
+    if(ptr != nullptr)
+        bulletMemory.fetch_add((int64_t)BulletBlockSize(ptr), std::memory_order_relaxed);
+    return ptr;
+}
+
+void PerformanceMonitor::BulletFree(void* ptr)
+{
+    if(ptr == nullptr)
+        return;
+    bulletMemory.fetch_sub((int64_t)BulletBlockSize(ptr), std::memory_order_relaxed);
+    free(ptr);
+}
+
+}
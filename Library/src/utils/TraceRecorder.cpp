@@ -0,0 +1,189 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+//
+//  TraceRecorder.cpp
+//  Stonefish
+//
+//  Created by agent on 18/10/2026.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "utils/TraceRecorder.h"
+#include <algorithm>
+#include <cstdio>
+#include <omp.h>
+#include "core/SimulationApp.h"
+
+namespace sf
+{
+
+std::atomic<bool> TraceRecorder::enabled(false);
+std::atomic<unsigned long long> TraceRecorder::generation(0);
+std::atomic<size_t> TraceRecorder::capacity(TraceRecorder::DEFAULT_TRACE_EVENTS);
+std::mutex TraceRecorder::mutex;
+std::vector<TraceRecorder::ThreadBuffer*> TraceRecorder::buffers;
+std::atomic<int64_t> TraceRecorder::origin(std::chrono::duration_cast<std::chrono::nanoseconds>(TraceRecorder::Clock::now().time_since_epoch()).count());
+
+void TraceRecorder::Start(size_t eventsPerThread)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity.store(eventsPerThread < 1 ? 1 : eventsPerThread);
+    origin.store(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+    generation.fetch_add(1); //Buffers are reset by their owners on the next event
+    enabled.store(true);
+}
+
+void TraceRecorder::Stop()
+{
+    enabled.store(false);
+}
+
+void TraceRecorder::SetThreadName(const std::string& name)
+{
+    ThreadBuffer* buf = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(mutex);
+    buf->name = name;
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::getThreadBuffer()
+{
+    //Buffers outlive their threads, so that the events of finished threads can still be saved
+    thread_local ThreadBuffer* buf = nullptr;
+    if(buf == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buf = new ThreadBuffer();
+        buf->tid = (unsigned int)buffers.size() + 1;
+        if(omp_in_parallel() && omp_get_thread_num() > 0)
+            buf->name = "OpenMP worker " + std::to_string(omp_get_thread_num());
+        else
+            buf->name = "Thread " + std::to_string(buf->tid);
+        buf->count = 0;
+        buf->generation = 0;
+        buffers.push_back(buf);
+    }
+    return buf;
+}
+
+void TraceRecorder::Record(const char* name, const char* category, Clock::time_point start, Clock::time_point end)
+{
+    if(!isEnabled())
+        return;
+    
+    ThreadBuffer* buf = getThreadBuffer();
+    unsigned long long gen = generation.load(std::memory_order_acquire);
+    if(buf->generation.load(std::memory_order_relaxed) != gen) //Recording restarted
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buf->events = std::vector<Event>(capacity.load());
+        buf->count.store(0, std::memory_order_relaxed);
+        buf->generation.store(gen, std::memory_order_relaxed);
+    }
+    
+    unsigned long long n = buf->count.load(std::memory_order_relaxed);
+    Event& ev = buf->events[(size_t)(n % buf->events.size())];
+    ev.name.store(name, std::memory_order_relaxed);
+    ev.category.store(category, std::memory_order_relaxed);
+    ev.start.store(std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count() - origin.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    ev.duration.store(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), std::memory_order_relaxed);
+    buf->count.store(n + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::Dump(const std::string& filename)
+{
+    FILE* file = fopen(filename.c_str(), "w");
+    if(file == NULL)
+    {
+        cError("Failed to open trace file '%s'!", filename.c_str());
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    unsigned long long gen = generation.load();
+    size_t nEvents = 0;
+    
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Stonefish\"}}");
+    for(size_t i=0; i<buffers.size(); ++i)
+    {
+        ThreadBuffer* buf = buffers[i];
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", buf->tid, EscapeJson(buf->name).c_str());
+        if(buf->generation.load() != gen)
+            continue;
+        
+        //Copy the events first, the owning thread may keep on writing
+        size_t cap = buf->events.size();
+        unsigned long long n = buf->count.load(std::memory_order_acquire);
+        unsigned long long first = n > cap ? n - cap : 0;
+        std::vector<const char*> names;
+        std::vector<const char*> categories;
+        std::vector<int64_t> starts;
+        std::vector<int64_t> durations;
+        for(unsigned long long k=first; k<n; ++k)
+        {
+            const Event& ev = buf->events[(size_t)(k % cap)];
+            names.push_back(ev.name.load(std::memory_order_relaxed));
+            categories.push_back(ev.category.load(std::memory_order_relaxed));
+            starts.push_back(ev.start.load(std::memory_order_relaxed));
+            durations.push_back(ev.duration.load(std::memory_order_relaxed));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        
+        //Skip the events that could have been overwritten while copying
+        unsigned long long n2 = buf->count.load(std::memory_order_relaxed);
+        unsigned long long valid = n2 >= cap ? n2 - cap + 1 : 0;
+        for(unsigned long long k=std::max(first, valid); k<n; ++k)
+        {
+            size_t j = (size_t)(k - first);
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    names[j], categories[j], buf->tid, starts[j]/1000.0, durations[j]/1000.0);
+            ++nEvents;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    
+    cInfo("Saved %lu trace events to '%s'.", (unsigned long)nEvents, filename.c_str());
+    return true;
+}
+
+std::string TraceRecorder::EscapeJson(const std::string& str)
+{
+    std::string out;
+    out.reserve(str.size());
+    for(char c : str)
+    {
+        if(c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if((unsigned char)c < 0x20) //Control characters
+        {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", (unsigned int)(unsigned char)c);
+            out += code;
+        }
+        else
+            out += c;
+    }
+    return out;
+}
+
+}